@@ -1,43 +0,0 @@
-/**
- * @file BySum.cpp
- *
- * This file is part of Cyclops
- *
- * Copyright 2016 Observational Health Data Sciences and Informatics
- *
- * Licensed under the Apache License, Version 2.0 (the "License");
- * you may not use this file except in compliance with the License.
- * You may obtain a copy of the License at
- *
- *     http://www.apache.org/licenses/LICENSE-2.0
- *
- * Unless required by applicable law or agreed to in writing, software
- * distributed under the License is distributed on an "AS IS" BASIS,
- * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
- * See the License for the specific language governing permissions and
- * limitations under the License.
- */
-
-#include "BySum.h"
-
-namespace ohdsi {
-namespace cyclops {
-
-std::map<double, double> BySum::bySum(const List &ffValues, const List &ffBins){
-  std::map<double, double> binToValue;
-  Environment bit = Environment::namespace_env("bit");
-  Function chunk = bit["chunk"];
-  List chunks = chunk(ffValues);
-  Environment ff = Environment::namespace_env("ff");
-  Function subset = ff["[.ff"];
-  for (int i = 0; i < chunks.size(); i++){
-    NumericVector bins = subset(ffBins, chunks[i]);
-    NumericVector values = subset(ffValues, chunks[i]);
-    for (int j = 0; j < bins.size(); j++){
-      binToValue[bins[j]] = binToValue[bins[j]] + values[j];
-    }
-  }
-  return binToValue;
-}
-}
-}
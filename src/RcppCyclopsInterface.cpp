@@ -8,6 +8,8 @@
 #include <vector>
 #include <map>
 #include "Timing.h"
+#include "PerformanceCounters.h"
+#include "Trace.h"
 
 #include "Rcpp.h"
 #include "RcppCyclopsInterface.h"
@@ -350,6 +352,97 @@ List cyclopsPredictModel(SEXP inRcppCcdInterface) {
 	return list;
 }
 
+// [[Rcpp::export(".cyclopsGetBaselineHazard")]]
+List cyclopsGetBaselineHazard(SEXP inRcppCcdInterface) {
+	using namespace bsccs;
+	XPtr<RcppCcdInterface> interface(inRcppCcdInterface);
+
+	std::vector<double> time;
+	std::vector<int> stratum;
+	std::vector<double> cumulativeHazard;
+	interface->getCcd().getBaselineHazard(time, stratum, cumulativeHazard);
+
+	return List::create(
+			Rcpp::Named("time") = time,
+			Rcpp::Named("stratum") = stratum,
+			Rcpp::Named("cumulativeHazard") = cumulativeHazard
+		);
+}
+
+
+// [[Rcpp::export(".cyclopsGetPerformanceCounters")]]
+List cyclopsGetPerformanceCounters(bool reset) {
+	using namespace bsccs;
+	const std::vector<performance::CounterRecord> records = performance::snapshot();
+	if (reset) {
+		performance::reset();
+	}
+
+	CharacterVector kernel(records.size());
+	CharacterVector format(records.size());
+	NumericVector calls(records.size());
+	NumericVector seconds(records.size());
+	for (size_t i = 0; i < records.size(); ++i) {
+		kernel[i] = records[i].kernel;
+		format[i] = records[i].format;
+		calls[i] = static_cast<double>(records[i].calls);
+		seconds[i] = records[i].nanoseconds * 1E-9;
+	}
+
+	return List::create(
+			Rcpp::Named("kernel") = kernel,
+			Rcpp::Named("format") = format,
+			Rcpp::Named("calls") = calls,
+			Rcpp::Named("seconds") = seconds
+		);
+}
+
+// [[Rcpp::export(".cyclopsGetMemoryFootprint")]]
+List cyclopsGetMemoryFootprint(SEXP inRcppCcdInterface, int threads) {
+	using namespace bsccs;
+	XPtr<RcppCcdInterface> interface(inRcppCcdInterface);
+
+	const MemoryFootprint data = interface->getModelData().getMemoryFootprint();
+	const MemoryFootprint clone = interface->getCcd().getMemoryFootprint();
+	MemoryFootprint records(data);
+	records.insert(records.end(), clone.begin(), clone.end());
+
+	CharacterVector owner(records.size());
+	CharacterVector component(records.size());
+	NumericVector bytes(records.size());
+	for (size_t i = 0; i < records.size(); ++i) {
+		owner[i] = records[i].owner;
+		component[i] = records[i].component;
+		bytes[i] = static_cast<double>(records[i].bytes);
+	}
+
+	// A full xBeta recompute from dense coefficients builds the row-major mirror
+	const double estimate = static_cast<double>(memory::estimateForThreads(data, clone,
+		interface->getModelData().getNumberOfRows(), sizeof(real), threads) +
+		interface->getModelData().getPendingRowMajorBytes());
+
+	return List::create(
+			Rcpp::Named("owner") = owner,
+			Rcpp::Named("component") = component,
+			Rcpp::Named("bytes") = bytes,
+			Rcpp::Named("estimatedBytes") = estimate
+		);
+}
+
+// [[Rcpp::export(".cyclopsStartTrace")]]
+void cyclopsStartTrace() {
+	bsccs::trace::start();
+}
+
+// [[Rcpp::export(".cyclopsWriteTrace")]]
+void cyclopsWriteTrace(const std::string& fileName) {
+	bsccs::trace::stop();
+	const bool written = bsccs::trace::write(fileName);
+	bsccs::trace::clear();
+	if (!written) {
+		Rcpp::stop("Unable to write trace to " + fileName);
+	}
+}
 
 // [[Rcpp::export(".cyclopsSetControl")]]
 void cyclopsSetControl(SEXP inRcppCcdInterface,
@@ -646,6 +739,14 @@ bsccs::ModelType RcppCcdInterface::parseModelType(const std::string& modelName)
  	return modelType;
 }
 
+std::string RcppCcdInterface::getModelTypeName(bsccs::ModelType modelType) {
+	auto model = modelTypeNames.find(modelType);
+	if (model == end(modelTypeNames)) {
+		handleError("Invalid model type.");
+	}
+	return model->second;
+}
+
 void RcppCcdInterface::setNoiseLevel(bsccs::NoiseLevels noiseLevel) {
     using namespace bsccs;
     ccd->setNoiseLevel(noiseLevel);
@@ -6,18 +6,6 @@
 
 using namespace Rcpp;
 
-// bySum
-DataFrame bySum(List ffValues, List ffBins);
-RcppExport SEXP _Cyclops_bySum(SEXP ffValuesSEXP, SEXP ffBinsSEXP) {
-BEGIN_RCPP
-    Rcpp::RObject rcpp_result_gen;
-    Rcpp::RNGScope rcpp_rngScope_gen;
-    Rcpp::traits::input_parameter< List >::type ffValues(ffValuesSEXP);
-    Rcpp::traits::input_parameter< List >::type ffBins(ffBinsSEXP);
-    rcpp_result_gen = Rcpp::wrap(bySum(ffValues, ffBins));
-    return rcpp_result_gen;
-END_RCPP
-}
 // cyclopsGetModelTypeNames
 std::vector<std::string> cyclopsGetModelTypeNames();
 RcppExport SEXP _Cyclops_cyclopsGetModelTypeNames() {
@@ -209,6 +197,59 @@ BEGIN_RCPP
     return rcpp_result_gen;
 END_RCPP
 }
+// cyclopsGetBaselineHazard
+List cyclopsGetBaselineHazard(SEXP inRcppCcdInterface);
+RcppExport SEXP _Cyclops_cyclopsGetBaselineHazard(SEXP inRcppCcdInterfaceSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type inRcppCcdInterface(inRcppCcdInterfaceSEXP);
+    rcpp_result_gen = Rcpp::wrap(cyclopsGetBaselineHazard(inRcppCcdInterface));
+    return rcpp_result_gen;
+END_RCPP
+}
+// cyclopsGetPerformanceCounters
+List cyclopsGetPerformanceCounters(bool reset);
+RcppExport SEXP _Cyclops_cyclopsGetPerformanceCounters(SEXP resetSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< bool >::type reset(resetSEXP);
+    rcpp_result_gen = Rcpp::wrap(cyclopsGetPerformanceCounters(reset));
+    return rcpp_result_gen;
+END_RCPP
+}
+// cyclopsGetMemoryFootprint
+List cyclopsGetMemoryFootprint(SEXP inRcppCcdInterface, int threads);
+RcppExport SEXP _Cyclops_cyclopsGetMemoryFootprint(SEXP inRcppCcdInterfaceSEXP, SEXP threadsSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type inRcppCcdInterface(inRcppCcdInterfaceSEXP);
+    Rcpp::traits::input_parameter< int >::type threads(threadsSEXP);
+    rcpp_result_gen = Rcpp::wrap(cyclopsGetMemoryFootprint(inRcppCcdInterface, threads));
+    return rcpp_result_gen;
+END_RCPP
+}
+// cyclopsStartTrace
+void cyclopsStartTrace();
+RcppExport SEXP _Cyclops_cyclopsStartTrace() {
+BEGIN_RCPP
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    cyclopsStartTrace();
+    return R_NilValue;
+END_RCPP
+}
+// cyclopsWriteTrace
+void cyclopsWriteTrace(const std::string& fileName);
+RcppExport SEXP _Cyclops_cyclopsWriteTrace(SEXP fileNameSEXP) {
+BEGIN_RCPP
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< const std::string& >::type fileName(fileNameSEXP);
+    cyclopsWriteTrace(fileName);
+    return R_NilValue;
+END_RCPP
+}
 // cyclopsSetControl
 void cyclopsSetControl(SEXP inRcppCcdInterface, int maxIterations, double tolerance, const std::string& convergenceType, bool useAutoSearch, int fold, int foldToCompute, double lowerLimit, double upperLimit, int gridSteps, const std::string& noiseLevel, int threads, int seed, bool resetCoefficients, double startingVariance, bool useKKTSwindle, int swindleMultipler, const std::string& selectorType, double initialBound, int maxBoundCount);
 RcppExport SEXP _Cyclops_cyclopsSetControl(SEXP inRcppCcdInterfaceSEXP, SEXP maxIterationsSEXP, SEXP toleranceSEXP, SEXP convergenceTypeSEXP, SEXP useAutoSearchSEXP, SEXP foldSEXP, SEXP foldToComputeSEXP, SEXP lowerLimitSEXP, SEXP upperLimitSEXP, SEXP gridStepsSEXP, SEXP noiseLevelSEXP, SEXP threadsSEXP, SEXP seedSEXP, SEXP resetCoefficientsSEXP, SEXP startingVarianceSEXP, SEXP useKKTSwindleSEXP, SEXP swindleMultiplerSEXP, SEXP selectorTypeSEXP, SEXP initialBoundSEXP, SEXP maxBoundCountSEXP) {
@@ -284,6 +325,112 @@ BEGIN_RCPP
     return rcpp_result_gen;
 END_RCPP
 }
+// cyclopsNewExternalSort
+SEXP cyclopsNewExternalSort(const std::vector<bool>& ascending, const double memoryMegabytes, const int threads, const std::string& tempDirectory);
+RcppExport SEXP _Cyclops_cyclopsNewExternalSort(SEXP ascendingSEXP, SEXP memoryMegabytesSEXP, SEXP threadsSEXP, SEXP tempDirectorySEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< const std::vector<bool>& >::type ascending(ascendingSEXP);
+    Rcpp::traits::input_parameter< const double >::type memoryMegabytes(memoryMegabytesSEXP);
+    Rcpp::traits::input_parameter< const int >::type threads(threadsSEXP);
+    Rcpp::traits::input_parameter< const std::string& >::type tempDirectory(tempDirectorySEXP);
+    rcpp_result_gen = Rcpp::wrap(cyclopsNewExternalSort(ascending, memoryMegabytes, threads, tempDirectory));
+    return rcpp_result_gen;
+END_RCPP
+}
+// cyclopsAddToExternalSort
+void cyclopsAddToExternalSort(SEXP sexpSorter, const List& keys);
+RcppExport SEXP _Cyclops_cyclopsAddToExternalSort(SEXP sexpSorterSEXP, SEXP keysSEXP) {
+BEGIN_RCPP
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type sexpSorter(sexpSorterSEXP);
+    Rcpp::traits::input_parameter< const List& >::type keys(keysSEXP);
+    cyclopsAddToExternalSort(sexpSorter, keys);
+    return R_NilValue;
+END_RCPP
+}
+// cyclopsFinishExternalSort
+SEXP cyclopsFinishExternalSort(SEXP sexpSorter);
+RcppExport SEXP _Cyclops_cyclopsFinishExternalSort(SEXP sexpSorterSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type sexpSorter(sexpSorterSEXP);
+    rcpp_result_gen = Rcpp::wrap(cyclopsFinishExternalSort(sexpSorter));
+    return rcpp_result_gen;
+END_RCPP
+}
+// cyclopsWriteExternalSort
+void cyclopsWriteExternalSort(SEXP sexpSorter, Function write);
+RcppExport SEXP _Cyclops_cyclopsWriteExternalSort(SEXP sexpSorterSEXP, SEXP writeSEXP) {
+BEGIN_RCPP
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type sexpSorter(sexpSorterSEXP);
+    Rcpp::traits::input_parameter< Function >::type write(writeSEXP);
+    cyclopsWriteExternalSort(sexpSorter, write);
+    return R_NilValue;
+END_RCPP
+}
+// cyclopsNewRowIdIndex
+SEXP cyclopsNewRowIdIndex(const NumericVector& rowIds);
+RcppExport SEXP _Cyclops_cyclopsNewRowIdIndex(SEXP rowIdsSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< const NumericVector& >::type rowIds(rowIdsSEXP);
+    rcpp_result_gen = Rcpp::wrap(cyclopsNewRowIdIndex(rowIds));
+    return rcpp_result_gen;
+END_RCPP
+}
+// cyclopsMatchRowIds
+SEXP cyclopsMatchRowIds(SEXP sexpIndex, const NumericVector& rowIds, const int threads);
+RcppExport SEXP _Cyclops_cyclopsMatchRowIds(SEXP sexpIndexSEXP, SEXP rowIdsSEXP, SEXP threadsSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type sexpIndex(sexpIndexSEXP);
+    Rcpp::traits::input_parameter< const NumericVector& >::type rowIds(rowIdsSEXP);
+    Rcpp::traits::input_parameter< const int >::type threads(threadsSEXP);
+    rcpp_result_gen = Rcpp::wrap(cyclopsMatchRowIds(sexpIndex, rowIds, threads));
+    return rcpp_result_gen;
+END_RCPP
+}
+// cyclopsNewGroupBySum
+SEXP cyclopsNewGroupBySum(const int nValues, const int threads);
+RcppExport SEXP _Cyclops_cyclopsNewGroupBySum(SEXP nValuesSEXP, SEXP threadsSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< const int >::type nValues(nValuesSEXP);
+    Rcpp::traits::input_parameter< const int >::type threads(threadsSEXP);
+    rcpp_result_gen = Rcpp::wrap(cyclopsNewGroupBySum(nValues, threads));
+    return rcpp_result_gen;
+END_RCPP
+}
+// cyclopsAddToGroupBySum
+void cyclopsAddToGroupBySum(SEXP sexpAggregator, const NumericVector& keys, const List& values);
+RcppExport SEXP _Cyclops_cyclopsAddToGroupBySum(SEXP sexpAggregatorSEXP, SEXP keysSEXP, SEXP valuesSEXP) {
+BEGIN_RCPP
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type sexpAggregator(sexpAggregatorSEXP);
+    Rcpp::traits::input_parameter< const NumericVector& >::type keys(keysSEXP);
+    Rcpp::traits::input_parameter< const List& >::type values(valuesSEXP);
+    cyclopsAddToGroupBySum(sexpAggregator, keys, values);
+    return R_NilValue;
+END_RCPP
+}
+// cyclopsGroupBySumResult
+List cyclopsGroupBySumResult(SEXP sexpAggregator);
+RcppExport SEXP _Cyclops_cyclopsGroupBySumResult(SEXP sexpAggregatorSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type sexpAggregator(sexpAggregatorSEXP);
+    rcpp_result_gen = Rcpp::wrap(cyclopsGroupBySumResult(sexpAggregator));
+    return rcpp_result_gen;
+END_RCPP
+}
 // isSorted
 bool isSorted(const DataFrame& dataFrame, const std::vector<std::string>& indexes, const std::vector<bool>& ascending);
 RcppExport SEXP _Cyclops_isSorted(SEXP dataFrameSEXP, SEXP indexesSEXP, SEXP ascendingSEXP) {
@@ -409,54 +556,85 @@ BEGIN_RCPP
 END_RCPP
 }
 // cyclopsUnivariableCorrelation
-std::vector<double> cyclopsUnivariableCorrelation(Environment x, const std::vector<long>& covariateLabel);
-RcppExport SEXP _Cyclops_cyclopsUnivariableCorrelation(SEXP xSEXP, SEXP covariateLabelSEXP) {
+std::vector<double> cyclopsUnivariableCorrelation(Environment x, const std::vector<long>& covariateLabel, const int threads);
+RcppExport SEXP _Cyclops_cyclopsUnivariableCorrelation(SEXP xSEXP, SEXP covariateLabelSEXP, SEXP threadsSEXP) {
 BEGIN_RCPP
     Rcpp::RObject rcpp_result_gen;
     Rcpp::RNGScope rcpp_rngScope_gen;
     Rcpp::traits::input_parameter< Environment >::type x(xSEXP);
     Rcpp::traits::input_parameter< const std::vector<long>& >::type covariateLabel(covariateLabelSEXP);
-    rcpp_result_gen = Rcpp::wrap(cyclopsUnivariableCorrelation(x, covariateLabel));
+    Rcpp::traits::input_parameter< const int >::type threads(threadsSEXP);
+    rcpp_result_gen = Rcpp::wrap(cyclopsUnivariableCorrelation(x, covariateLabel, threads));
+    return rcpp_result_gen;
+END_RCPP
+}
+// cyclopsUnivariableScore
+List cyclopsUnivariableScore(Environment x, const std::vector<long>& covariateLabel, const int threads);
+RcppExport SEXP _Cyclops_cyclopsUnivariableScore(SEXP xSEXP, SEXP covariateLabelSEXP, SEXP threadsSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< Environment >::type x(xSEXP);
+    Rcpp::traits::input_parameter< const std::vector<long>& >::type covariateLabel(covariateLabelSEXP);
+    Rcpp::traits::input_parameter< const int >::type threads(threadsSEXP);
+    rcpp_result_gen = Rcpp::wrap(cyclopsUnivariableScore(x, covariateLabel, threads));
+    return rcpp_result_gen;
+END_RCPP
+}
+// cyclopsScoreModelData
+std::vector<double> cyclopsScoreModelData(Environment x, const std::vector<double>& coefficientIds, const std::vector<double>& coefficients, const int threads);
+RcppExport SEXP _Cyclops_cyclopsScoreModelData(SEXP xSEXP, SEXP coefficientIdsSEXP, SEXP coefficientsSEXP, SEXP threadsSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< Environment >::type x(xSEXP);
+    Rcpp::traits::input_parameter< const std::vector<double>& >::type coefficientIds(coefficientIdsSEXP);
+    Rcpp::traits::input_parameter< const std::vector<double>& >::type coefficients(coefficientsSEXP);
+    Rcpp::traits::input_parameter< const int >::type threads(threadsSEXP);
+    rcpp_result_gen = Rcpp::wrap(cyclopsScoreModelData(x, coefficientIds, coefficients, threads));
     return rcpp_result_gen;
 END_RCPP
 }
 // cyclopsSumByGroup
-List cyclopsSumByGroup(Environment x, const std::vector<long>& covariateLabel, const long groupByLabel, const int power);
-RcppExport SEXP _Cyclops_cyclopsSumByGroup(SEXP xSEXP, SEXP covariateLabelSEXP, SEXP groupByLabelSEXP, SEXP powerSEXP) {
+List cyclopsSumByGroup(Environment x, const std::vector<long>& covariateLabel, const long groupByLabel, const std::vector<int>& power, const int threads);
+RcppExport SEXP _Cyclops_cyclopsSumByGroup(SEXP xSEXP, SEXP covariateLabelSEXP, SEXP groupByLabelSEXP, SEXP powerSEXP, SEXP threadsSEXP) {
 BEGIN_RCPP
     Rcpp::RObject rcpp_result_gen;
     Rcpp::RNGScope rcpp_rngScope_gen;
     Rcpp::traits::input_parameter< Environment >::type x(xSEXP);
     Rcpp::traits::input_parameter< const std::vector<long>& >::type covariateLabel(covariateLabelSEXP);
     Rcpp::traits::input_parameter< const long >::type groupByLabel(groupByLabelSEXP);
-    Rcpp::traits::input_parameter< const int >::type power(powerSEXP);
-    rcpp_result_gen = Rcpp::wrap(cyclopsSumByGroup(x, covariateLabel, groupByLabel, power));
+    Rcpp::traits::input_parameter< const std::vector<int>& >::type power(powerSEXP);
+    Rcpp::traits::input_parameter< const int >::type threads(threadsSEXP);
+    rcpp_result_gen = Rcpp::wrap(cyclopsSumByGroup(x, covariateLabel, groupByLabel, power, threads));
     return rcpp_result_gen;
 END_RCPP
 }
 // cyclopsSumByStratum
-List cyclopsSumByStratum(Environment x, const std::vector<long>& covariateLabel, const int power);
-RcppExport SEXP _Cyclops_cyclopsSumByStratum(SEXP xSEXP, SEXP covariateLabelSEXP, SEXP powerSEXP) {
+List cyclopsSumByStratum(Environment x, const std::vector<long>& covariateLabel, const std::vector<int>& power, const int threads);
+RcppExport SEXP _Cyclops_cyclopsSumByStratum(SEXP xSEXP, SEXP covariateLabelSEXP, SEXP powerSEXP, SEXP threadsSEXP) {
 BEGIN_RCPP
     Rcpp::RObject rcpp_result_gen;
     Rcpp::RNGScope rcpp_rngScope_gen;
     Rcpp::traits::input_parameter< Environment >::type x(xSEXP);
     Rcpp::traits::input_parameter< const std::vector<long>& >::type covariateLabel(covariateLabelSEXP);
-    Rcpp::traits::input_parameter< const int >::type power(powerSEXP);
-    rcpp_result_gen = Rcpp::wrap(cyclopsSumByStratum(x, covariateLabel, power));
+    Rcpp::traits::input_parameter< const std::vector<int>& >::type power(powerSEXP);
+    Rcpp::traits::input_parameter< const int >::type threads(threadsSEXP);
+    rcpp_result_gen = Rcpp::wrap(cyclopsSumByStratum(x, covariateLabel, power, threads));
     return rcpp_result_gen;
 END_RCPP
 }
 // cyclopsSum
-std::vector<double> cyclopsSum(Environment x, const std::vector<long>& covariateLabel, const int power);
-RcppExport SEXP _Cyclops_cyclopsSum(SEXP xSEXP, SEXP covariateLabelSEXP, SEXP powerSEXP) {
+std::vector<double> cyclopsSum(Environment x, const std::vector<long>& covariateLabel, const std::vector<int>& power, const int threads);
+RcppExport SEXP _Cyclops_cyclopsSum(SEXP xSEXP, SEXP covariateLabelSEXP, SEXP powerSEXP, SEXP threadsSEXP) {
 BEGIN_RCPP
     Rcpp::RObject rcpp_result_gen;
     Rcpp::RNGScope rcpp_rngScope_gen;
     Rcpp::traits::input_parameter< Environment >::type x(xSEXP);
     Rcpp::traits::input_parameter< const std::vector<long>& >::type covariateLabel(covariateLabelSEXP);
-    Rcpp::traits::input_parameter< const int >::type power(powerSEXP);
-    rcpp_result_gen = Rcpp::wrap(cyclopsSum(x, covariateLabel, power));
+    Rcpp::traits::input_parameter< const std::vector<int>& >::type power(powerSEXP);
+    Rcpp::traits::input_parameter< const int >::type threads(threadsSEXP);
+    rcpp_result_gen = Rcpp::wrap(cyclopsSum(x, covariateLabel, power, threads));
     return rcpp_result_gen;
 END_RCPP
 }
@@ -496,14 +674,15 @@ BEGIN_RCPP
 END_RCPP
 }
 // cyclopsNormalizeCovariates
-std::vector<double> cyclopsNormalizeCovariates(Environment x, const std::string& normalizationName);
-RcppExport SEXP _Cyclops_cyclopsNormalizeCovariates(SEXP xSEXP, SEXP normalizationNameSEXP) {
+std::vector<double> cyclopsNormalizeCovariates(Environment x, const std::string& normalizationName, const int threads);
+RcppExport SEXP _Cyclops_cyclopsNormalizeCovariates(SEXP xSEXP, SEXP normalizationNameSEXP, SEXP threadsSEXP) {
 BEGIN_RCPP
     Rcpp::RObject rcpp_result_gen;
     Rcpp::RNGScope rcpp_rngScope_gen;
     Rcpp::traits::input_parameter< Environment >::type x(xSEXP);
     Rcpp::traits::input_parameter< const std::string& >::type normalizationName(normalizationNameSEXP);
-    rcpp_result_gen = Rcpp::wrap(cyclopsNormalizeCovariates(x, normalizationName));
+    Rcpp::traits::input_parameter< const int >::type threads(threadsSEXP);
+    rcpp_result_gen = Rcpp::wrap(cyclopsNormalizeCovariates(x, normalizationName, threads));
     return rcpp_result_gen;
 END_RCPP
 }
@@ -604,8 +783,8 @@ BEGIN_RCPP
 END_RCPP
 }
 // cyclopsLoadDataMultipleX
-int cyclopsLoadDataMultipleX(Environment x, const std::vector<int64_t>& covariateId, const std::vector<int64_t>& rowId, const std::vector<double>& covariateValue, const bool checkCovariateIds, const bool checkCovariateBounds, const bool append, const bool forceSparse);
-RcppExport SEXP _Cyclops_cyclopsLoadDataMultipleX(SEXP xSEXP, SEXP covariateIdSEXP, SEXP rowIdSEXP, SEXP covariateValueSEXP, SEXP checkCovariateIdsSEXP, SEXP checkCovariateBoundsSEXP, SEXP appendSEXP, SEXP forceSparseSEXP) {
+int cyclopsLoadDataMultipleX(Environment x, const std::vector<int64_t>& covariateId, const std::vector<int64_t>& rowId, const std::vector<double>& covariateValue, const bool checkCovariateIds, const bool checkCovariateBounds, const bool append, const bool forceSparse, const int threads);
+RcppExport SEXP _Cyclops_cyclopsLoadDataMultipleX(SEXP xSEXP, SEXP covariateIdSEXP, SEXP rowIdSEXP, SEXP covariateValueSEXP, SEXP checkCovariateIdsSEXP, SEXP checkCovariateBoundsSEXP, SEXP appendSEXP, SEXP forceSparseSEXP, SEXP threadsSEXP) {
 BEGIN_RCPP
     Rcpp::RObject rcpp_result_gen;
     Rcpp::RNGScope rcpp_rngScope_gen;
@@ -617,7 +796,26 @@ BEGIN_RCPP
     Rcpp::traits::input_parameter< const bool >::type checkCovariateBounds(checkCovariateBoundsSEXP);
     Rcpp::traits::input_parameter< const bool >::type append(appendSEXP);
     Rcpp::traits::input_parameter< const bool >::type forceSparse(forceSparseSEXP);
-    rcpp_result_gen = Rcpp::wrap(cyclopsLoadDataMultipleX(x, covariateId, rowId, covariateValue, checkCovariateIds, checkCovariateBounds, append, forceSparse));
+    Rcpp::traits::input_parameter< const int >::type threads(threadsSEXP);
+    rcpp_result_gen = Rcpp::wrap(cyclopsLoadDataMultipleX(x, covariateId, rowId, covariateValue, checkCovariateIds, checkCovariateBounds, append, forceSparse, threads));
+    return rcpp_result_gen;
+END_RCPP
+}
+// cyclopsLoadDataArrow
+int cyclopsLoadDataArrow(Environment x, SEXP outcomeArray, SEXP outcomeSchema, SEXP covariateArray, SEXP covariateSchema, const bool append, const bool forceSparse, const int threads);
+RcppExport SEXP _Cyclops_cyclopsLoadDataArrow(SEXP xSEXP, SEXP outcomeArraySEXP, SEXP outcomeSchemaSEXP, SEXP covariateArraySEXP, SEXP covariateSchemaSEXP, SEXP appendSEXP, SEXP forceSparseSEXP, SEXP threadsSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< Environment >::type x(xSEXP);
+    Rcpp::traits::input_parameter< SEXP >::type outcomeArray(outcomeArraySEXP);
+    Rcpp::traits::input_parameter< SEXP >::type outcomeSchema(outcomeSchemaSEXP);
+    Rcpp::traits::input_parameter< SEXP >::type covariateArray(covariateArraySEXP);
+    Rcpp::traits::input_parameter< SEXP >::type covariateSchema(covariateSchemaSEXP);
+    Rcpp::traits::input_parameter< const bool >::type append(appendSEXP);
+    Rcpp::traits::input_parameter< const bool >::type forceSparse(forceSparseSEXP);
+    Rcpp::traits::input_parameter< const int >::type threads(threadsSEXP);
+    rcpp_result_gen = Rcpp::wrap(cyclopsLoadDataArrow(x, outcomeArray, outcomeSchema, covariateArray, covariateSchema, append, forceSparse, threads));
     return rcpp_result_gen;
 END_RCPP
 }
@@ -656,6 +854,48 @@ BEGIN_RCPP
     return rcpp_result_gen;
 END_RCPP
 }
+// cyclopsNewIngestionSession
+SEXP cyclopsNewIngestionSession(Environment x, const int threads, const int maxPendingBatches, const double expectedRows);
+RcppExport SEXP _Cyclops_cyclopsNewIngestionSession(SEXP xSEXP, SEXP threadsSEXP, SEXP maxPendingBatchesSEXP, SEXP expectedRowsSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< Environment >::type x(xSEXP);
+    Rcpp::traits::input_parameter< const int >::type threads(threadsSEXP);
+    Rcpp::traits::input_parameter< const int >::type maxPendingBatches(maxPendingBatchesSEXP);
+    Rcpp::traits::input_parameter< const double >::type expectedRows(expectedRowsSEXP);
+    rcpp_result_gen = Rcpp::wrap(cyclopsNewIngestionSession(x, threads, maxPendingBatches, expectedRows));
+    return rcpp_result_gen;
+END_RCPP
+}
+// cyclopsAppendToIngestionSession
+void cyclopsAppendToIngestionSession(SEXP sexpSession, const std::vector<int64_t>& oStratumId, const std::vector<int64_t>& oRowId, const std::vector<double>& oY, const std::vector<double>& oTime, const std::vector<int64_t>& cRowId, const std::vector<int64_t>& cCovariateId, const std::vector<double>& cCovariateValue);
+RcppExport SEXP _Cyclops_cyclopsAppendToIngestionSession(SEXP sexpSessionSEXP, SEXP oStratumIdSEXP, SEXP oRowIdSEXP, SEXP oYSEXP, SEXP oTimeSEXP, SEXP cRowIdSEXP, SEXP cCovariateIdSEXP, SEXP cCovariateValueSEXP) {
+BEGIN_RCPP
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type sexpSession(sexpSessionSEXP);
+    Rcpp::traits::input_parameter< const std::vector<int64_t>& >::type oStratumId(oStratumIdSEXP);
+    Rcpp::traits::input_parameter< const std::vector<int64_t>& >::type oRowId(oRowIdSEXP);
+    Rcpp::traits::input_parameter< const std::vector<double>& >::type oY(oYSEXP);
+    Rcpp::traits::input_parameter< const std::vector<double>& >::type oTime(oTimeSEXP);
+    Rcpp::traits::input_parameter< const std::vector<int64_t>& >::type cRowId(cRowIdSEXP);
+    Rcpp::traits::input_parameter< const std::vector<int64_t>& >::type cCovariateId(cCovariateIdSEXP);
+    Rcpp::traits::input_parameter< const std::vector<double>& >::type cCovariateValue(cCovariateValueSEXP);
+    cyclopsAppendToIngestionSession(sexpSession, oStratumId, oRowId, oY, oTime, cRowId, cCovariateId, cCovariateValue);
+    return R_NilValue;
+END_RCPP
+}
+// cyclopsCloseIngestionSession
+double cyclopsCloseIngestionSession(SEXP sexpSession);
+RcppExport SEXP _Cyclops_cyclopsCloseIngestionSession(SEXP sexpSessionSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type sexpSession(sexpSessionSEXP);
+    rcpp_result_gen = Rcpp::wrap(cyclopsCloseIngestionSession(sexpSession));
+    return rcpp_result_gen;
+END_RCPP
+}
 // cyclopsGetInterceptLabel
 SEXP cyclopsGetInterceptLabel(Environment x);
 RcppExport SEXP _Cyclops_cyclopsGetInterceptLabel(SEXP xSEXP) {
@@ -668,14 +908,58 @@ BEGIN_RCPP
 END_RCPP
 }
 // cyclopsReadFileData
-List cyclopsReadFileData(const std::string& fileName, const std::string& modelTypeName);
-RcppExport SEXP _Cyclops_cyclopsReadFileData(SEXP fileNameSEXP, SEXP modelTypeNameSEXP) {
+List cyclopsReadFileData(const std::string& fileName, const std::string& modelTypeName, int threads);
+RcppExport SEXP _Cyclops_cyclopsReadFileData(SEXP fileNameSEXP, SEXP modelTypeNameSEXP, SEXP threadsSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< const std::string& >::type fileName(fileNameSEXP);
+    Rcpp::traits::input_parameter< const std::string& >::type modelTypeName(modelTypeNameSEXP);
+    Rcpp::traits::input_parameter< int >::type threads(threadsSEXP);
+    rcpp_result_gen = Rcpp::wrap(cyclopsReadFileData(fileName, modelTypeName, threads));
+    return rcpp_result_gen;
+END_RCPP
+}
+// cyclopsSaveBinaryData
+void cyclopsSaveBinaryData(Environment x, const std::string& fileName);
+RcppExport SEXP _Cyclops_cyclopsSaveBinaryData(SEXP xSEXP, SEXP fileNameSEXP) {
+BEGIN_RCPP
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< Environment >::type x(xSEXP);
+    Rcpp::traits::input_parameter< const std::string& >::type fileName(fileNameSEXP);
+    cyclopsSaveBinaryData(x, fileName);
+    return R_NilValue;
+END_RCPP
+}
+// cyclopsLoadBinaryData
+List cyclopsLoadBinaryData(const std::string& fileName, double residentMegabytes);
+RcppExport SEXP _Cyclops_cyclopsLoadBinaryData(SEXP fileNameSEXP, SEXP residentMegabytesSEXP) {
 BEGIN_RCPP
     Rcpp::RObject rcpp_result_gen;
     Rcpp::RNGScope rcpp_rngScope_gen;
     Rcpp::traits::input_parameter< const std::string& >::type fileName(fileNameSEXP);
+    Rcpp::traits::input_parameter< double >::type residentMegabytes(residentMegabytesSEXP);
+    rcpp_result_gen = Rcpp::wrap(cyclopsLoadBinaryData(fileName, residentMegabytes));
+    return rcpp_result_gen;
+END_RCPP
+}
+// cyclopsSimulateData
+List cyclopsSimulateData(const std::string& modelTypeName, double rows, double stratumSize, int indicatorColumns, double maxDensity, double decay, int effects, double effectSize, double baseRate, double seed);
+RcppExport SEXP _Cyclops_cyclopsSimulateData(SEXP modelTypeNameSEXP, SEXP rowsSEXP, SEXP stratumSizeSEXP, SEXP indicatorColumnsSEXP, SEXP maxDensitySEXP, SEXP decaySEXP, SEXP effectsSEXP, SEXP effectSizeSEXP, SEXP baseRateSEXP, SEXP seedSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
     Rcpp::traits::input_parameter< const std::string& >::type modelTypeName(modelTypeNameSEXP);
-    rcpp_result_gen = Rcpp::wrap(cyclopsReadFileData(fileName, modelTypeName));
+    Rcpp::traits::input_parameter< double >::type rows(rowsSEXP);
+    Rcpp::traits::input_parameter< double >::type stratumSize(stratumSizeSEXP);
+    Rcpp::traits::input_parameter< int >::type indicatorColumns(indicatorColumnsSEXP);
+    Rcpp::traits::input_parameter< double >::type maxDensity(maxDensitySEXP);
+    Rcpp::traits::input_parameter< double >::type decay(decaySEXP);
+    Rcpp::traits::input_parameter< int >::type effects(effectsSEXP);
+    Rcpp::traits::input_parameter< double >::type effectSize(effectSizeSEXP);
+    Rcpp::traits::input_parameter< double >::type baseRate(baseRateSEXP);
+    Rcpp::traits::input_parameter< double >::type seed(seedSEXP);
+    rcpp_result_gen = Rcpp::wrap(cyclopsSimulateData(modelTypeName, rows, stratumSize, indicatorColumns, maxDensity, decay, effects, effectSize, baseRate, seed));
     return rcpp_result_gen;
 END_RCPP
 }
@@ -699,9 +983,48 @@ BEGIN_RCPP
     return rcpp_result_gen;
 END_RCPP
 }
+// cyclopsNewScorer
+SEXP cyclopsNewScorer(const NumericVector& rowIds, const NumericVector& coefficientIds, const std::vector<double>& coefficients, const std::string& modelType, const int threads);
+RcppExport SEXP _Cyclops_cyclopsNewScorer(SEXP rowIdsSEXP, SEXP coefficientIdsSEXP, SEXP coefficientsSEXP, SEXP modelTypeSEXP, SEXP threadsSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< const NumericVector& >::type rowIds(rowIdsSEXP);
+    Rcpp::traits::input_parameter< const NumericVector& >::type coefficientIds(coefficientIdsSEXP);
+    Rcpp::traits::input_parameter< const std::vector<double>& >::type coefficients(coefficientsSEXP);
+    Rcpp::traits::input_parameter< const std::string& >::type modelType(modelTypeSEXP);
+    Rcpp::traits::input_parameter< const int >::type threads(threadsSEXP);
+    rcpp_result_gen = Rcpp::wrap(cyclopsNewScorer(rowIds, coefficientIds, coefficients, modelType, threads));
+    return rcpp_result_gen;
+END_RCPP
+}
+// cyclopsAddToScorer
+void cyclopsAddToScorer(SEXP sexpScorer, const NumericVector& rowIds, const NumericVector& covariateIds, const NumericVector& covariateValues);
+RcppExport SEXP _Cyclops_cyclopsAddToScorer(SEXP sexpScorerSEXP, SEXP rowIdsSEXP, SEXP covariateIdsSEXP, SEXP covariateValuesSEXP) {
+BEGIN_RCPP
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type sexpScorer(sexpScorerSEXP);
+    Rcpp::traits::input_parameter< const NumericVector& >::type rowIds(rowIdsSEXP);
+    Rcpp::traits::input_parameter< const NumericVector& >::type covariateIds(covariateIdsSEXP);
+    Rcpp::traits::input_parameter< const NumericVector& >::type covariateValues(covariateValuesSEXP);
+    cyclopsAddToScorer(sexpScorer, rowIds, covariateIds, covariateValues);
+    return R_NilValue;
+END_RCPP
+}
+// cyclopsScorerResult
+std::vector<double> cyclopsScorerResult(SEXP sexpScorer, const double intercept);
+RcppExport SEXP _Cyclops_cyclopsScorerResult(SEXP sexpScorerSEXP, SEXP interceptSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type sexpScorer(sexpScorerSEXP);
+    Rcpp::traits::input_parameter< const double >::type intercept(interceptSEXP);
+    rcpp_result_gen = Rcpp::wrap(cyclopsScorerResult(sexpScorer, intercept));
+    return rcpp_result_gen;
+END_RCPP
+}
 
 static const R_CallMethodDef CallEntries[] = {
-    {"_Cyclops_bySum", (DL_FUNC) &_Cyclops_bySum, 2},
     {"_Cyclops_cyclopsGetModelTypeNames", (DL_FUNC) &_Cyclops_cyclopsGetModelTypeNames, 0},
     {"_Cyclops_cyclopsGetRemoveInterceptNames", (DL_FUNC) &_Cyclops_cyclopsGetRemoveInterceptNames, 0},
     {"_Cyclops_cyclopsGetIsSurvivalNames", (DL_FUNC) &_Cyclops_cyclopsGetIsSurvivalNames, 0},
@@ -718,11 +1041,25 @@ static const R_CallMethodDef CallEntries[] = {
     {"_Cyclops_cyclopsSetParameterizedPrior", (DL_FUNC) &_Cyclops_cyclopsSetParameterizedPrior, 5},
     {"_Cyclops_cyclopsProfileModel", (DL_FUNC) &_Cyclops_cyclopsProfileModel, 6},
     {"_Cyclops_cyclopsPredictModel", (DL_FUNC) &_Cyclops_cyclopsPredictModel, 1},
+    {"_Cyclops_cyclopsGetBaselineHazard", (DL_FUNC) &_Cyclops_cyclopsGetBaselineHazard, 1},
+    {"_Cyclops_cyclopsGetPerformanceCounters", (DL_FUNC) &_Cyclops_cyclopsGetPerformanceCounters, 1},
+    {"_Cyclops_cyclopsGetMemoryFootprint", (DL_FUNC) &_Cyclops_cyclopsGetMemoryFootprint, 2},
+    {"_Cyclops_cyclopsStartTrace", (DL_FUNC) &_Cyclops_cyclopsStartTrace, 0},
+    {"_Cyclops_cyclopsWriteTrace", (DL_FUNC) &_Cyclops_cyclopsWriteTrace, 1},
     {"_Cyclops_cyclopsSetControl", (DL_FUNC) &_Cyclops_cyclopsSetControl, 20},
     {"_Cyclops_cyclopsRunCrossValidationl", (DL_FUNC) &_Cyclops_cyclopsRunCrossValidationl, 1},
     {"_Cyclops_cyclopsFitModel", (DL_FUNC) &_Cyclops_cyclopsFitModel, 1},
     {"_Cyclops_cyclopsLogModel", (DL_FUNC) &_Cyclops_cyclopsLogModel, 1},
     {"_Cyclops_cyclopsInitializeModel", (DL_FUNC) &_Cyclops_cyclopsInitializeModel, 3},
+    {"_Cyclops_cyclopsNewExternalSort", (DL_FUNC) &_Cyclops_cyclopsNewExternalSort, 4},
+    {"_Cyclops_cyclopsAddToExternalSort", (DL_FUNC) &_Cyclops_cyclopsAddToExternalSort, 2},
+    {"_Cyclops_cyclopsFinishExternalSort", (DL_FUNC) &_Cyclops_cyclopsFinishExternalSort, 1},
+    {"_Cyclops_cyclopsWriteExternalSort", (DL_FUNC) &_Cyclops_cyclopsWriteExternalSort, 2},
+    {"_Cyclops_cyclopsNewRowIdIndex", (DL_FUNC) &_Cyclops_cyclopsNewRowIdIndex, 1},
+    {"_Cyclops_cyclopsMatchRowIds", (DL_FUNC) &_Cyclops_cyclopsMatchRowIds, 3},
+    {"_Cyclops_cyclopsNewGroupBySum", (DL_FUNC) &_Cyclops_cyclopsNewGroupBySum, 2},
+    {"_Cyclops_cyclopsAddToGroupBySum", (DL_FUNC) &_Cyclops_cyclopsAddToGroupBySum, 3},
+    {"_Cyclops_cyclopsGroupBySumResult", (DL_FUNC) &_Cyclops_cyclopsGroupBySumResult, 1},
     {"_Cyclops_isSorted", (DL_FUNC) &_Cyclops_isSorted, 3},
     {"_Cyclops_isSortedVectorList", (DL_FUNC) &_Cyclops_isSortedVectorList, 2},
     {"_Cyclops_cyclopsPrintRowIds", (DL_FUNC) &_Cyclops_cyclopsPrintRowIds, 1},
@@ -734,14 +1071,16 @@ static const R_CallMethodDef CallEntries[] = {
     {"_Cyclops_cyclopsPrintMatrixMarket", (DL_FUNC) &_Cyclops_cyclopsPrintMatrixMarket, 2},
     {"_Cyclops_cyclopsGetNumberOfRows", (DL_FUNC) &_Cyclops_cyclopsGetNumberOfRows, 1},
     {"_Cyclops_cyclopsGetNumberOfTypes", (DL_FUNC) &_Cyclops_cyclopsGetNumberOfTypes, 1},
-    {"_Cyclops_cyclopsUnivariableCorrelation", (DL_FUNC) &_Cyclops_cyclopsUnivariableCorrelation, 2},
-    {"_Cyclops_cyclopsSumByGroup", (DL_FUNC) &_Cyclops_cyclopsSumByGroup, 4},
-    {"_Cyclops_cyclopsSumByStratum", (DL_FUNC) &_Cyclops_cyclopsSumByStratum, 3},
-    {"_Cyclops_cyclopsSum", (DL_FUNC) &_Cyclops_cyclopsSum, 3},
+    {"_Cyclops_cyclopsUnivariableCorrelation", (DL_FUNC) &_Cyclops_cyclopsUnivariableCorrelation, 3},
+    {"_Cyclops_cyclopsUnivariableScore", (DL_FUNC) &_Cyclops_cyclopsUnivariableScore, 3},
+    {"_Cyclops_cyclopsScoreModelData", (DL_FUNC) &_Cyclops_cyclopsScoreModelData, 4},
+    {"_Cyclops_cyclopsSumByGroup", (DL_FUNC) &_Cyclops_cyclopsSumByGroup, 5},
+    {"_Cyclops_cyclopsSumByStratum", (DL_FUNC) &_Cyclops_cyclopsSumByStratum, 4},
+    {"_Cyclops_cyclopsSum", (DL_FUNC) &_Cyclops_cyclopsSum, 4},
     {"_Cyclops_cyclopsNewSqlData", (DL_FUNC) &_Cyclops_cyclopsNewSqlData, 2},
     {"_Cyclops_cyclopsMedian", (DL_FUNC) &_Cyclops_cyclopsMedian, 1},
     {"_Cyclops_cyclopsQuantile", (DL_FUNC) &_Cyclops_cyclopsQuantile, 2},
-    {"_Cyclops_cyclopsNormalizeCovariates", (DL_FUNC) &_Cyclops_cyclopsNormalizeCovariates, 2},
+    {"_Cyclops_cyclopsNormalizeCovariates", (DL_FUNC) &_Cyclops_cyclopsNormalizeCovariates, 3},
     {"_Cyclops_cyclopsSetHasIntercept", (DL_FUNC) &_Cyclops_cyclopsSetHasIntercept, 2},
     {"_Cyclops_cyclopsGetHasIntercept", (DL_FUNC) &_Cyclops_cyclopsGetHasIntercept, 1},
     {"_Cyclops_cyclopsGetHasOffset", (DL_FUNC) &_Cyclops_cyclopsGetHasOffset, 1},
@@ -750,12 +1089,22 @@ static const R_CallMethodDef CallEntries[] = {
     {"_Cyclops_cyclopsGetTimeVector", (DL_FUNC) &_Cyclops_cyclopsGetTimeVector, 1},
     {"_Cyclops_cyclopsFinalizeData", (DL_FUNC) &_Cyclops_cyclopsFinalizeData, 7},
     {"_Cyclops_cyclopsLoadDataY", (DL_FUNC) &_Cyclops_cyclopsLoadDataY, 5},
-    {"_Cyclops_cyclopsLoadDataMultipleX", (DL_FUNC) &_Cyclops_cyclopsLoadDataMultipleX, 8},
+    {"_Cyclops_cyclopsLoadDataMultipleX", (DL_FUNC) &_Cyclops_cyclopsLoadDataMultipleX, 9},
+    {"_Cyclops_cyclopsLoadDataArrow", (DL_FUNC) &_Cyclops_cyclopsLoadDataArrow, 8},
     {"_Cyclops_cyclopsLoadDataX", (DL_FUNC) &_Cyclops_cyclopsLoadDataX, 7},
     {"_Cyclops_cyclopsAppendSqlData", (DL_FUNC) &_Cyclops_cyclopsAppendSqlData, 8},
+    {"_Cyclops_cyclopsNewIngestionSession", (DL_FUNC) &_Cyclops_cyclopsNewIngestionSession, 4},
+    {"_Cyclops_cyclopsAppendToIngestionSession", (DL_FUNC) &_Cyclops_cyclopsAppendToIngestionSession, 8},
+    {"_Cyclops_cyclopsCloseIngestionSession", (DL_FUNC) &_Cyclops_cyclopsCloseIngestionSession, 1},
     {"_Cyclops_cyclopsGetInterceptLabel", (DL_FUNC) &_Cyclops_cyclopsGetInterceptLabel, 1},
-    {"_Cyclops_cyclopsReadFileData", (DL_FUNC) &_Cyclops_cyclopsReadFileData, 2},
+    {"_Cyclops_cyclopsReadFileData", (DL_FUNC) &_Cyclops_cyclopsReadFileData, 3},
+    {"_Cyclops_cyclopsSaveBinaryData", (DL_FUNC) &_Cyclops_cyclopsSaveBinaryData, 2},
+    {"_Cyclops_cyclopsLoadBinaryData", (DL_FUNC) &_Cyclops_cyclopsLoadBinaryData, 2},
+    {"_Cyclops_cyclopsSimulateData", (DL_FUNC) &_Cyclops_cyclopsSimulateData, 10},
     {"_Cyclops_cyclopsModelData", (DL_FUNC) &_Cyclops_cyclopsModelData, 10},
+    {"_Cyclops_cyclopsNewScorer", (DL_FUNC) &_Cyclops_cyclopsNewScorer, 5},
+    {"_Cyclops_cyclopsAddToScorer", (DL_FUNC) &_Cyclops_cyclopsAddToScorer, 4},
+    {"_Cyclops_cyclopsScorerResult", (DL_FUNC) &_Cyclops_cyclopsScorerResult, 2},
     {NULL, NULL, 0}
 };
 
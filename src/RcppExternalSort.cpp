@@ -0,0 +1,109 @@
+/*
+ * RcppExternalSort.cpp
+ *
+ * R bindings for the chunked external sort and rowId matching used when converting
+ * ffdf tables.  The sort order can be streamed back to R block by block.
+ */
+
+#include <algorithm>
+#include <climits>
+
+#include "Rcpp.h"
+#include "io/ExternalSort.h"
+
+using namespace Rcpp;
+
+namespace {
+
+// Whether R can hold indices into this many rows as integers
+bool fitsInteger(size_t rows) {
+    return rows <= static_cast<size_t>(INT_MAX);
+}
+
+// 1-based indices, as integers when asInteger, otherwise doubles
+template <typename Iterator>
+SEXP wrapIndices(Iterator begin, Iterator end, size_t length, bool asInteger) {
+    if (asInteger) {
+        IntegerVector indices(length);
+        std::transform(begin, end, indices.begin(), [](int64_t i) {
+            return i < 0 ? NA_INTEGER : static_cast<int>(i + 1);
+        });
+        return indices;
+    }
+    NumericVector indices(length);
+    std::transform(begin, end, indices.begin(), [](int64_t i) {
+        return i < 0 ? NA_REAL : static_cast<double>(i + 1);
+    });
+    return indices;
+}
+
+} // namespace
+
+// [[Rcpp::export(".cyclopsNewExternalSort")]]
+SEXP cyclopsNewExternalSort(const std::vector<bool>& ascending, const double memoryMegabytes,
+        const int threads, const std::string& tempDirectory) {
+
+    using namespace bsccs;
+    const size_t memoryBytes = static_cast<size_t>(memoryMegabytes * 1024 * 1024);
+    XPtr<ExternalSort> sorter(new ExternalSort(ascending, memoryBytes, threads, tempDirectory), true);
+    return sorter;
+}
+
+// [[Rcpp::export(".cyclopsAddToExternalSort")]]
+void cyclopsAddToExternalSort(SEXP sexpSorter, const List& keys) {
+
+    using namespace bsccs;
+    XPtr<ExternalSort> sorter(sexpSorter);
+
+    std::vector<NumericVector> columns; // keeps any coerced copies alive
+    std::vector<const double*> pointers;
+    for (R_xlen_t k = 0; k < keys.size(); ++k) {
+        columns.push_back(as<NumericVector>(keys[k]));
+        if (columns.back().size() != columns.front().size()) {
+            stop("Sort key columns must have equal length");
+        }
+        pointers.push_back(columns.back().begin());
+    }
+    sorter->add(pointers, columns.empty() ? 0 : columns.front().size());
+}
+
+// [[Rcpp::export(".cyclopsFinishExternalSort")]]
+SEXP cyclopsFinishExternalSort(SEXP sexpSorter) {
+
+    using namespace bsccs;
+    XPtr<ExternalSort> sorter(sexpSorter);
+    const std::vector<uint64_t> order = sorter->finish();
+    return wrapIndices(order.begin(), order.end(), order.size(), fitsInteger(order.size()));
+}
+
+// [[Rcpp::export(".cyclopsWriteExternalSort")]]
+void cyclopsWriteExternalSort(SEXP sexpSorter, Function write) {
+
+    using namespace bsccs;
+    XPtr<ExternalSort> sorter(sexpSorter);
+    const bool asInteger = fitsInteger(sorter->size());
+    double from = 1;
+    sorter->finish([&write, &from, asInteger](const uint64_t* order, size_t length) {
+        write(from, wrapIndices(order, order + length, length, asInteger));
+        from += length;
+    });
+}
+
+// [[Rcpp::export(".cyclopsNewRowIdIndex")]]
+SEXP cyclopsNewRowIdIndex(const NumericVector& rowIds) {
+
+    using namespace bsccs;
+    XPtr<RowIdIndex> index(new RowIdIndex(rowIds.begin(), rowIds.size()), true);
+    return index;
+}
+
+// [[Rcpp::export(".cyclopsMatchRowIds")]]
+SEXP cyclopsMatchRowIds(SEXP sexpIndex, const NumericVector& rowIds, const int threads) {
+
+    using namespace bsccs;
+    XPtr<RowIdIndex> index(sexpIndex);
+    std::vector<int64_t> positions(rowIds.size());
+    index->lookup(rowIds.begin(), rowIds.size(), positions.data(), threads);
+    return wrapIndices(positions.begin(), positions.end(), positions.size(),
+        fitsInteger(positions.size()));
+}
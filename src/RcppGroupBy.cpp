@@ -0,0 +1,63 @@
+/*
+ * RcppGroupBy.cpp
+ *
+ * R bindings for the chunked hashed group-by sum used to aggregate ffdf predictions.
+ */
+
+#include <stdexcept>
+
+#include "Rcpp.h"
+#include "GroupBy.h"
+
+using namespace Rcpp;
+
+// [[Rcpp::export(".cyclopsNewGroupBySum")]]
+SEXP cyclopsNewGroupBySum(const int nValues, const int threads) {
+
+    using namespace bsccs;
+    XPtr<GroupBySum> aggregator(new GroupBySum(nValues, threads), true);
+    return aggregator;
+}
+
+// [[Rcpp::export(".cyclopsAddToGroupBySum")]]
+void cyclopsAddToGroupBySum(SEXP sexpAggregator, const NumericVector& keys, const List& values) {
+
+    using namespace bsccs;
+    XPtr<GroupBySum> aggregator(sexpAggregator);
+
+    std::vector<NumericVector> columns; // keeps any coerced copies alive
+    std::vector<const double*> pointers;
+    for (R_xlen_t v = 0; v < values.size(); ++v) {
+        columns.push_back(as<NumericVector>(values[v]));
+        if (columns.back().size() != keys.size()) {
+            stop("Keys and values must have equal length");
+        }
+        pointers.push_back(columns.back().begin());
+    }
+    try {
+        aggregator->add(keys.begin(), pointers, keys.size());
+    } catch (std::invalid_argument& e) {
+        stop(e.what());
+    }
+}
+
+// [[Rcpp::export(".cyclopsGroupBySumResult")]]
+List cyclopsGroupBySumResult(SEXP sexpAggregator) {
+
+    using namespace bsccs;
+    XPtr<GroupBySum> aggregator(sexpAggregator);
+
+    std::vector<double> keys;
+    std::vector<double> sums;
+    aggregator->finish(keys, sums);
+
+    const size_t nGroups = keys.size();
+    List values(nGroups == 0 ? 0 : sums.size() / nGroups);
+    for (R_xlen_t v = 0; v < values.size(); ++v) {
+        values[v] = NumericVector(sums.begin() + v * nGroups, sums.begin() + (v + 1) * nGroups);
+    }
+    return List::create(
+        Named("keys") = keys,
+        Named("sums") = values
+    );
+}
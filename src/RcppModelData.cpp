@@ -10,40 +10,17 @@
 #include "Timer.h"
 #include "RcppCyclopsInterface.h"
 #include "io/NewGenericInputReader.h"
+#include "io/BinaryModelData.h"
+#include "io/SyntheticDataGenerator.h"
+#include "io/ArrowImport.h"
+#include "io/IngestionSession.h"
+#include "GroupBy.h"
+#include "UnivariableStatistics.h"
+#include "Scoring.h"
 #include "RcppProgressLogger.h"
 
 using namespace Rcpp;
 
-struct Sum {
-    inline double operator()(double x, double y) {
-        return x + y;
-    }
-};
-
-struct ZeroPower {
-    inline double operator()(double x) {
-        return x == 0.0 ? 0.0 : 1.0;
-    }
-};
-
-struct FirstPower {
-    inline double operator()(double x) {
-        return x;
-    }
-};
-
-struct SecondPower {
-    inline double operator()(double x) {
-        return x * x;
-    }
-};
-
-struct InnerProduct {
-    inline double operator()(double x, double y) {
-        return x * y;
-    }
-};
-
 XPtr<bsccs::ModelData> parseEnvironmentForPtr(const Environment& x) {
 	if (!x.inherits("cyclopsData")) {
 		stop("Input must be a cyclopsData object");
@@ -238,90 +215,147 @@ int cyclopsGetNumberOfTypes(Environment object) {
 	return static_cast<int>(data->getNumberOfTypes());
 }
 
+namespace {
+
+// All non-offset columns when no labels are given
+std::vector<size_t> getScreeningColumns(const bsccs::ModelData& data,
+        const std::vector<long>& covariateLabel) {
+    std::vector<size_t> columns;
+    if (covariateLabel.size() == 0) {
+        columns.reserve(data.getNumberOfColumns());
+        size_t index = (data.getHasOffsetCovariate()) ? 1 : 0;
+        for (; index < data.getNumberOfColumns(); ++index) {
+            columns.push_back(index);
+        }
+    } else {
+        columns.reserve(covariateLabel.size());
+        for (auto it = covariateLabel.begin(); it != covariateLabel.end(); ++it) {
+            columns.push_back(data.getColumnIndex(*it));
+        }
+    }
+    return columns;
+}
+
+} // namespace
+
 // [[Rcpp::export(.cyclopsUnivariableCorrelation)]]
 std::vector<double> cyclopsUnivariableCorrelation(Environment x,
-                                                  const std::vector<long>& covariateLabel) {
+                                                  const std::vector<long>& covariateLabel,
+                                                  const int threads = 1) {
     XPtr<bsccs::RcppModelData> data = parseEnvironmentForRcppPtr(x);
 
-    const double Ey1 = data->reduce(-1, FirstPower()) / data->getNumberOfRows();
-    const double Ey2 = data->reduce(-1, SecondPower()) / data->getNumberOfRows();
-    const double Vy = Ey2 - Ey1 * Ey1;
+    const bsccs::UnivariableStatistics statistics(*data);
+    std::vector<double> result = statistics.correlation(
+        getScreeningColumns(*data, covariateLabel), threads);
+
+    for (auto it = result.begin(); it != result.end(); ++it) {
+        if (std::isnan(*it)) {
+            *it = NA_REAL;
+        }
+    }
+    return result;
+}
 
-    std::vector<double> result;
+// [[Rcpp::export(.cyclopsUnivariableScore)]]
+List cyclopsUnivariableScore(Environment x, const std::vector<long>& covariateLabel,
+                             const int threads = 1) {
+    XPtr<bsccs::RcppModelData> data = parseEnvironmentForRcppPtr(x);
 
-    auto oneVariable = [&data, &result, Ey1, Vy](const size_t index) {
-        const double Ex1 = data->reduce(index, FirstPower()) / data->getNumberOfRows();
-        const double Ex2 = data->reduce(index, SecondPower()) / data->getNumberOfRows();
-        const double Exy = data->innerProductWithOutcome(index, InnerProduct()) / data->getNumberOfRows();
+    const bsccs::UnivariableStatistics statistics(*data);
+    std::vector<double> gradient;
+    std::vector<double> information;
+    statistics.score(getScreeningColumns(*data, covariateLabel), gradient, information, threads);
 
-        const double Vx = Ex2 - Ex1 * Ex1;
-        const double cov = Exy - Ex1 * Ey1;
-        const double cor = (Vx > 0.0 && Vy > 0.0) ?
-                           cov / std::sqrt(Vx) / std::sqrt(Vy) : NA_REAL;
+    return List::create(
+        Named("gradient") = gradient,
+        Named("information") = information
+    );
+}
 
-        // Rcpp::Rcout << index << " " << Ey1 << " " << Ey2 << " " << Ex1 << " " << Ex2 << std::endl;
-        // Rcpp::Rcout << index << " " << ySquared << " " << xSquared <<  " " << crossProduct << std::endl;
-        result.push_back(cor);
-    };
+// [[Rcpp::export(.cyclopsScoreModelData)]]
+std::vector<double> cyclopsScoreModelData(Environment x, const std::vector<double>& coefficientIds,
+                                          const std::vector<double>& coefficients,
+                                          const int threads = 1) {
+    XPtr<bsccs::RcppModelData> data = parseEnvironmentForRcppPtr(x);
 
-    if (covariateLabel.size() == 0) {
-        result.reserve(data->getNumberOfColumns());
-        size_t index = (data->getHasOffsetCovariate()) ? 1 : 0;
-        for (; index <  data->getNumberOfColumns(); ++index) {
-            oneVariable(index);
-        }
-    } else {
-        result.reserve(covariateLabel.size());
-        for(auto it = covariateLabel.begin(); it != covariateLabel.end(); ++it) {
-            oneVariable(data->getColumnIndex(*it));
-        }
+    if (coefficientIds.size() != coefficients.size()) {
+        stop("Coefficients and their IDs must have equal length");
+    }
+    const bsccs::Scorer scorer(
+        std::vector<bsccs::IdType>(coefficientIds.begin(), coefficientIds.end()),
+        coefficients, data->getModelType(), threads);
+    return scorer.predict(scorer.getLinearPredictor(*data));
+}
+
+namespace {
+
+std::vector<size_t> getColumnIndices(const bsccs::ModelData& data,
+        const std::vector<long>& covariateLabel) {
+    std::vector<size_t> indices;
+    indices.reserve(covariateLabel.size());
+    for (auto it = covariateLabel.begin(); it != covariateLabel.end(); ++it) {
+        indices.push_back(data.getColumnIndex(*it));
     }
+    return indices;
+}
 
-    return result;
+// One vector of group sums per (covariate, power), covariate-major
+List wrapGroupedSums(const std::vector<double>& sums, const std::vector<long>& covariateLabel,
+        const size_t nPowers, const size_t nGroups) {
+    List list(covariateLabel.size() * nPowers);
+    IntegerVector names(list.size());
+    for (R_xlen_t i = 0; i < list.size(); ++i) {
+        list[i] = NumericVector(sums.begin() + i * nGroups, sums.begin() + (i + 1) * nGroups);
+        names[i] = covariateLabel[i / nPowers];
+    }
+    list.attr("names") = names;
+    return list;
 }
 
+} // namespace
+
 // [[Rcpp::export(".cyclopsSumByGroup")]]
 List cyclopsSumByGroup(Environment x, const std::vector<long>& covariateLabel,
-		const long groupByLabel, const int power) {
-	XPtr<bsccs::RcppModelData> data = parseEnvironmentForRcppPtr(x);
-    List list(covariateLabel.size());
-    IntegerVector names(covariateLabel.size());
-    for (size_t i = 0; i < covariateLabel.size(); ++i) {
-        std::vector<double> result;
-        data->sumByGroup(result, covariateLabel[i], groupByLabel, power);
-        list[i] = result;
-        names[i] = covariateLabel[i];
+		const long groupByLabel, const std::vector<int>& power, const int threads = 1) {
+    using namespace bsccs;
+	XPtr<RcppModelData> data = parseEnvironmentForRcppPtr(x);
+
+    const size_t groupByIndex = data->getColumnIndex(groupByLabel);
+    if (data->getFormatType(groupByIndex) != INDICATOR) {
+        stop("Grouping by non-indicators is not yet supported.");
+    }
+    std::vector<int> groups(data->getNumberOfRows(), 0);
+    const PinnedColumn pinned(*data, groupByIndex);
+    const std::vector<int>& rows = data->getCompressedColumnVectorSTL(groupByIndex);
+    for (auto it = rows.begin(); it != rows.end(); ++it) {
+        groups[*it] = 1;
     }
-	list.attr("names") = names;
-	return list;
+
+    const std::vector<double> sums = GroupBy::reduceColumns(*data,
+        getColumnIndices(*data, covariateLabel), groups.data(), 2, power, threads);
+    return wrapGroupedSums(sums, covariateLabel, power.size(), 2);
 }
 
 // [[Rcpp::export(".cyclopsSumByStratum")]]
 List cyclopsSumByStratum(Environment x, const std::vector<long>& covariateLabel,
-		const int power) {
-	XPtr<bsccs::RcppModelData> data = parseEnvironmentForRcppPtr(x);
-    List list(covariateLabel.size());
-    IntegerVector names(covariateLabel.size());
-    for (size_t i = 0; i < covariateLabel.size(); ++i) {
-        std::vector<double> result;
-        data->sumByGroup(result, covariateLabel[i], power);
-        list[i] = result;
-        names[i] = covariateLabel[i];
-    }
-	list.attr("names") = names;
-	return list;
+		const std::vector<int>& power, const int threads = 1) {
+    using namespace bsccs;
+	XPtr<RcppModelData> data = parseEnvironmentForRcppPtr(x);
+
+    const size_t nStrata = data->getNumberOfPatients();
+    const std::vector<double> sums = GroupBy::reduceColumns(*data,
+        getColumnIndices(*data, covariateLabel), data->getPidVector(), nStrata, power, threads);
+    return wrapGroupedSums(sums, covariateLabel, power.size(), nStrata);
 }
 
 // [[Rcpp::export(".cyclopsSum")]]
 std::vector<double> cyclopsSum(Environment x, const std::vector<long>& covariateLabel,
-		const int power) {
-	XPtr<bsccs::RcppModelData> data = parseEnvironmentForRcppPtr(x);
-	std::vector<double> result;
-	for (std::vector<long>::const_iterator it = covariateLabel.begin();
-	        it != covariateLabel.end(); ++it) {
-	    result.push_back(data->sum(*it, power));
-	}
-	return result;
+		const std::vector<int>& power, const int threads = 1) {
+    using namespace bsccs;
+	XPtr<RcppModelData> data = parseEnvironmentForRcppPtr(x);
+
+    return GroupBy::reduceColumns(*data, getColumnIndices(*data, covariateLabel),
+        nullptr, 1, power, threads);
 }
 
 
@@ -362,11 +396,12 @@ double cyclopsQuantile(const NumericVector& vector, double q) {
 }
 
 // [[Rcpp::export(".cyclopsNormalizeCovariates")]]
-std::vector<double> cyclopsNormalizeCovariates(Environment x, const std::string& normalizationName) {
+std::vector<double> cyclopsNormalizeCovariates(Environment x, const std::string& normalizationName,
+                                               const int threads = 1) {
     using namespace bsccs;
     XPtr<ModelData> data = parseEnvironmentForPtr(x);
     NormalizationType type = RcppCcdInterface::parseNormalizationType(normalizationName);
-    return data->normalizeCovariates(type);
+    return data->normalizeCovariates(type, threads);
 }
 
 // [[Rcpp::export(".cyclopsSetHasIntercept")]]
@@ -394,9 +429,12 @@ bool cyclopsGetHasOffset(Environment x) {
 double cyclopsGetMeanOffset(Environment x) {
     using namespace bsccs;
     XPtr<RcppModelData> data = parseEnvironmentForRcppPtr(x);
-    return (data->getHasOffsetCovariate()) ?
-        data->sum(-1, 1) / data->getNumberOfRows() :
-        0.0;
+    if (!data->getHasOffsetCovariate()) {
+        return 0.0;
+    }
+    const std::vector<size_t> columns(1, data->getColumnIndex(-1));
+    return GroupBy::reduceColumns(*data, columns, nullptr, 1, std::vector<int>(1, 1))[0] /
+        data->getNumberOfRows();
 }
 
 // [[Rcpp::export("getYVector")]]
@@ -427,6 +465,10 @@ void cyclopsFinalizeData(
         ::Rf_error("OHDSI data object is already finalized");
     }
 
+    if (data->isOutOfCore()) {
+        ::Rf_error("OHDSI data object is paged from disk and cannot be modified");
+    }
+
     if (addIntercept) {
         if (data->getHasInterceptCovariate()) {
             ::Rf_error("OHDSI data object already has an intercept");
@@ -461,7 +503,7 @@ void cyclopsFinalizeData(
             }
         }
         data->moveToFront(index);
-        data->getColumn(0).add_label(-1); // TODO Generic label for offset?
+        data->setColumnLabel(0, -1); // TODO Generic label for offset?
         data->setHasOffsetCovariate(true);
     }
 
@@ -481,6 +523,9 @@ void cyclopsFinalizeData(
         }
     }
 
+    data->shareDuplicateColumns();
+    data->touchX();
+
     data->setIsFinalized(true);
 }
 
@@ -505,13 +550,56 @@ int cyclopsLoadDataMultipleX(Environment x,
 		const bool checkCovariateIds,
 		const bool checkCovariateBounds,
 		const bool append,
-		const bool forceSparse) {
+		const bool forceSparse,
+		const int threads = 1) {
 
 	using namespace bsccs;
 	XPtr<ModelData> data = parseEnvironmentForPtr(x);
 
 	return data->loadMultipleX(covariateId, rowId, covariateValue, checkCovariateIds,
-                            checkCovariateBounds, append, forceSparse);
+                            checkCovariateBounds, append, forceSparse, threads);
+}
+
+// Arrow C structs arrive as external pointers (e.g., from nanoarrow)
+template <typename ArrowType>
+ArrowType* parseArrowPointer(SEXP sexp) {
+    if (TYPEOF(sexp) != EXTPTRSXP) {
+        stop("Arrow arrays and schemas must be external pointers");
+    }
+    ArrowType* pointer = static_cast<ArrowType*>(R_ExternalPtrAddr(sexp));
+    if (pointer == nullptr) {
+        stop("Arrow array or schema external pointer is null");
+    }
+    return pointer;
+}
+
+// [[Rcpp::export(".loadCyclopsDataArrow")]]
+int cyclopsLoadDataArrow(Environment x,
+        SEXP outcomeArray,
+        SEXP outcomeSchema,
+        SEXP covariateArray,
+        SEXP covariateSchema,
+        const bool append,
+        const bool forceSparse,
+        const int threads = 1) {
+
+    using namespace bsccs;
+    XPtr<ModelData> data = parseEnvironmentForPtr(x);
+
+    if (!Rf_isNull(outcomeArray)) {
+        ArrowImport::loadOutcomes(*data,
+            parseArrowPointer<ArrowSchema>(outcomeSchema),
+            parseArrowPointer<ArrowArray>(outcomeArray));
+    }
+
+    if (Rf_isNull(covariateArray)) {
+        return data->getNumberOfColumns();
+    }
+
+    return ArrowImport::loadCovariates(*data,
+        parseArrowPointer<ArrowSchema>(covariateSchema),
+        parseArrowPointer<ArrowArray>(covariateArray),
+        append, forceSparse, threads);
 }
 
 // [[Rcpp::export(".loadCyclopsDataX")]]
@@ -552,6 +640,60 @@ int cyclopsAppendSqlData(Environment x,
     return static_cast<int>(count);
 }
 
+// [[Rcpp::export(".cyclopsNewIngestionSession")]]
+SEXP cyclopsNewIngestionSession(Environment x,
+        const int threads,
+        const int maxPendingBatches,
+        const double expectedRows) {
+
+    using namespace bsccs;
+    XPtr<ModelData> data = parseEnvironmentForPtr(x);
+
+    if (data->getIsFinalized()) {
+        ::Rf_error("OHDSI data object is already finalized");
+    }
+
+    // Protect the data object for as long as the session may write into it
+    XPtr<IngestionSession> session(
+        new IngestionSession(*data, threads, maxPendingBatches, static_cast<size_t>(expectedRows)),
+        true, R_NilValue, x);
+    return session;
+}
+
+// [[Rcpp::export(".cyclopsAppendToIngestionSession")]]
+void cyclopsAppendToIngestionSession(SEXP sexpSession,
+        const std::vector<int64_t>& oStratumId,
+        const std::vector<int64_t>& oRowId,
+        const std::vector<double>& oY,
+        const std::vector<double>& oTime,
+        const std::vector<int64_t>& cRowId,
+        const std::vector<int64_t>& cCovariateId,
+        const std::vector<double>& cCovariateValue) {
+
+    using namespace bsccs;
+    XPtr<IngestionSession> session(sexpSession);
+
+    // R vectors are copied once here since background threads cannot touch R memory
+    IngestionSession::Batch batch;
+    batch.stratumId = oStratumId;
+    batch.rowId = oRowId;
+    batch.y = oY;
+    batch.time = oTime;
+    batch.covariateRowId = cRowId;
+    batch.covariateId = cCovariateId;
+    batch.covariateValue = cCovariateValue;
+
+    session->append(std::move(batch));
+}
+
+// [[Rcpp::export(".cyclopsCloseIngestionSession")]]
+double cyclopsCloseIngestionSession(SEXP sexpSession) {
+
+    using namespace bsccs;
+    XPtr<IngestionSession> session(sexpSession);
+    return static_cast<double>(session->close());
+}
+
 
 // [[Rcpp::export(".cyclopsGetInterceptLabel")]]
 SEXP cyclopsGetInterceptLabel(Environment x) {
@@ -566,7 +708,8 @@ SEXP cyclopsGetInterceptLabel(Environment x) {
 }
 
 // [[Rcpp::export(".cyclopsReadData")]]
-List cyclopsReadFileData(const std::string& fileName, const std::string& modelTypeName) {
+List cyclopsReadFileData(const std::string& fileName, const std::string& modelTypeName,
+        int threads = 1) {
 
 		using namespace bsccs;
 		Timer timer;
@@ -574,6 +717,7 @@ List cyclopsReadFileData(const std::string& fileName, const std::string& modelTy
     InputReader* reader = new NewGenericInputReader(modelType,
     	bsccs::make_shared<loggers::RcppProgressLogger>(true), // make silent
     	bsccs::make_shared<loggers::RcppErrorHandler>());
+    reader->setThreadCount(threads);
 		reader->readFile(fileName.c_str()); // TODO Check for error
 
     XPtr<ModelData> ptr(reader->getModelData());
@@ -594,6 +738,70 @@ List cyclopsReadFileData(const std::string& fileName, const std::string& modelTy
     return list;
 }
 
+// [[Rcpp::export(".cyclopsSaveBinaryData")]]
+void cyclopsSaveBinaryData(Environment x, const std::string& fileName) {
+    using namespace bsccs;
+    XPtr<ModelData> data = parseEnvironmentForPtr(x);
+    BinaryModelData::write(*data, fileName);
+}
+
+// [[Rcpp::export(".cyclopsLoadBinaryData")]]
+List cyclopsLoadBinaryData(const std::string& fileName, double residentMegabytes = 0) {
+    using namespace bsccs;
+    Timer timer;
+
+    XPtr<RcppModelData> ptr(new RcppModelData(ModelType::NONE,
+        bsccs::make_shared<loggers::RcppProgressLogger>(true), // make silent
+        bsccs::make_shared<loggers::RcppErrorHandler>()));
+    BinaryModelData::read(*ptr, fileName,
+        static_cast<size_t>(std::max(0.0, residentMegabytes) * 1024 * 1024));
+
+    double time = timer();
+    List list = List::create(
+            Rcpp::Named("cyclopsDataPtr") = ptr,
+            Rcpp::Named("modelType") = RcppCcdInterface::getModelTypeName(ptr->getModelType()),
+            Rcpp::Named("timeLoad") = time
+    );
+    return list;
+}
+
+// [[Rcpp::export(".cyclopsSimulateData")]]
+List cyclopsSimulateData(const std::string& modelTypeName, double rows, double stratumSize,
+        int indicatorColumns, double maxDensity, double decay, int effects, double effectSize,
+        double baseRate, double seed) {
+    using namespace bsccs;
+    Timer timer;
+
+    SyntheticDataArguments arguments;
+    arguments.modelType = RcppCcdInterface::parseModelType(modelTypeName);
+    arguments.rows = static_cast<size_t>(std::max(0.0, rows));
+    arguments.stratumSize = static_cast<size_t>(std::max(0.0, stratumSize));
+    arguments.indicatorColumns = indicatorColumns;
+    arguments.maxDensity = maxDensity;
+    arguments.decay = decay;
+    arguments.effects = effects;
+    arguments.effectSize = effectSize;
+    arguments.baseRate = baseRate;
+    arguments.seed = static_cast<uint64_t>(seed);
+
+    loggers::ProgressLoggerPtr logger =
+        bsccs::make_shared<loggers::RcppProgressLogger>(true); // make silent
+    loggers::ErrorHandlerPtr error = bsccs::make_shared<loggers::RcppErrorHandler>();
+
+    XPtr<RcppModelData> ptr(new RcppModelData(arguments.modelType, logger, error));
+    SyntheticDataGenerator generator(arguments, logger, error);
+    generator.generate(*ptr);
+
+    double time = timer();
+    List list = List::create(
+            Rcpp::Named("cyclopsDataPtr") = ptr,
+            Rcpp::Named("modelType") = RcppCcdInterface::getModelTypeName(ptr->getModelType()),
+            Rcpp::Named("timeLoad") = time,
+            Rcpp::Named("trueBeta") = generator.getTrueBeta()
+    );
+    return list;
+}
+
 // [[Rcpp::export(".cyclopsModelData")]]
 List cyclopsModelData(SEXP pid, SEXP y, SEXP z, SEXP offs, SEXP dx, SEXP sx, SEXP ix,
     const std::string& modelTypeName,
@@ -695,7 +903,7 @@ RcppModelData::RcppModelData(
         push_back(NULL, r, DENSE);
         r->assign(offs.begin(), offs.end()); // TODO Should not be necessary with shared_ptr
         setHasOffsetCovariate(true);
-	    getColumn(0).add_label(-1);
+	    setColumnLabel(0, -1);
 	}
 
     nTypes = numTypes; // TODO move into constructor
@@ -708,7 +916,7 @@ RcppModelData::RcppModelData(
 					static_cast<IntegerVector::iterator>(NULL), static_cast<IntegerVector::iterator>(NULL),
 					dxv.begin() + i * y.size(), dxv.begin() + (i + 1) * y.size(),
 					DENSE);
-			getColumn(getNumberOfColumns() - 1).add_label(getNumberOfColumns() - (getHasOffsetCovariate() ? 1 : 0));
+			setColumnLabel(getNumberOfColumns() - 1, getNumberOfColumns() - (getHasOffsetCovariate() ? 1 : 0));
 		} else {
 			std::vector<RealVectorPtr> covariates;
 			for (int c = 0; c < numTypes; ++c) {
@@ -725,7 +933,7 @@ RcppModelData::RcppModelData(
                         NULL,
                         covariates[c],
 						DENSE);
-				getColumn(getNumberOfColumns() - 1).add_label(getNumberOfColumns() - (getHasOffsetCovariate() ? 1 : 0));
+				setColumnLabel(getNumberOfColumns() - 1, getNumberOfColumns() - (getHasOffsetCovariate() ? 1 : 0));
 			}
 		}
 	}
@@ -742,7 +950,7 @@ RcppModelData::RcppModelData(
 			    	siv.begin() + begin, siv.begin() + end,
 				    sxv.begin() + begin, sxv.begin() + end,
     				SPARSE);
-            getColumn(getNumberOfColumns() - 1).add_label(getNumberOfColumns() - (getHasOffsetCovariate() ? 1 : 0));
+            setColumnLabel(getNumberOfColumns() - 1, getNumberOfColumns() - (getHasOffsetCovariate() ? 1 : 0));
         } else {
 			std::vector<IntVectorPtr> covariatesI;
 			std::vector<RealVectorPtr> covariatesX;
@@ -750,7 +958,7 @@ RcppModelData::RcppModelData(
 				covariatesI.push_back(make_shared<IntVector>());
 				covariatesX.push_back(make_shared<RealVector>());
 				push_back(covariatesI[c], covariatesX[c], SPARSE);
-				getColumn(getNumberOfColumns() - 1).add_label(getNumberOfColumns() - (getHasOffsetCovariate() ? 1 : 0));
+				setColumnLabel(getNumberOfColumns() - 1, getNumberOfColumns() - (getHasOffsetCovariate() ? 1 : 0));
 			}
 
             auto itI = siv.begin() + begin;
@@ -775,13 +983,13 @@ RcppModelData::RcppModelData(
 	    			iiv.begin() + begin, iiv.begin() + end,
 		    		static_cast<NumericVector::iterator>(NULL), static_cast<NumericVector::iterator>(NULL),
 			    	INDICATOR);
-            getColumn(getNumberOfColumns() - 1).add_label(getNumberOfColumns() - (getHasOffsetCovariate() ? 1 : 0));
+            setColumnLabel(getNumberOfColumns() - 1, getNumberOfColumns() - (getHasOffsetCovariate() ? 1 : 0));
         } else {
 			std::vector<IntVectorPtr> covariates;
 			for (int c = 0; c < numTypes; ++c) {
 				covariates.push_back(make_shared<IntVector>());
 				push_back(covariates[c], NULL, INDICATOR);
-				getColumn(getNumberOfColumns() - 1).add_label(getNumberOfColumns() - (getHasOffsetCovariate() ? 1 : 0));
+				setColumnLabel(getNumberOfColumns() - 1, getNumberOfColumns() - (getHasOffsetCovariate() ? 1 : 0));
 			}
 
             for (auto it = iiv.begin() + begin; it != iiv.begin() + end; ++it) {
@@ -817,43 +1025,6 @@ RcppModelData::RcppModelData(
     }
 }
 
-double RcppModelData::sum(const IdType covariate, int power) {
-
-    size_t index = getColumnIndex(covariate);
-    if (power == 0) {
-		return reduce(index, ZeroPower());
-	} else if (power == 1) {
-		return reduce(index, FirstPower());
-	} else {
-		return reduce(index, SecondPower());
-	}
-}
-
-void RcppModelData::sumByGroup(std::vector<double>& out, const IdType covariate, const IdType groupBy, int power) {
-    size_t covariateIndex = getColumnIndex(covariate);
-    size_t groupByIndex = getColumnIndex(groupBy);
-    out.resize(2);
-    if (power == 0) {
-    	reduceByGroup(out, covariateIndex, groupByIndex, ZeroPower());
-    } else if (power == 1) {
-  		reduceByGroup(out, covariateIndex, groupByIndex, FirstPower());
-    } else {
-    	reduceByGroup(out, covariateIndex, groupByIndex, SecondPower());
-    }
-}
-
-void RcppModelData::sumByGroup(std::vector<double>& out, const IdType covariate, int power) {
-    size_t covariateIndex = getColumnIndex(covariate);
-    out.resize(nPatients);
-    if (power == 0) {
-    	reduceByGroup(out, covariateIndex, pid, ZeroPower());
-    } else if (power == 1) {
-  		reduceByGroup(out, covariateIndex, pid, FirstPower());
-    } else {
-    	reduceByGroup(out, covariateIndex, pid, SecondPower());
-    }
-}
-
 RcppModelData::~RcppModelData() {
 //	std::cout << "~RcppModelData() called." << std::endl;
 }
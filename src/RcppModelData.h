@@ -46,14 +46,8 @@ public:
 
 	virtual ~RcppModelData();
 
-	double sum(const IdType covariate, int power = 1);
-
 	void standardize(const IdType covariate);
 
-	void sumByGroup(std::vector<double>& out, const IdType covariate, const IdType groupBy, int power = 1);
-
-	void sumByGroup(std::vector<double>& out, const IdType covariate, int power = 1);
-
     template <typename F>
     void transform(const size_t index, F func) {
 		switch (getFormatType(index)) {
@@ -115,29 +109,6 @@ public:
 	    return sum;
 	}
 
-	template <typename T, typename F>
-	void reduceByGroup(T& out, const size_t reductionIndex, const size_t groupByIndex, F func) {
-	    if (getFormatType(groupByIndex) != INDICATOR) {
-	        std::ostringstream stream;
-	        stream << "Grouping by non-indicators is not yet supported.";
-	        error->throwError(stream);
-	    }
-		switch (getFormatType(reductionIndex)) {
-			case INDICATOR :
-                reduceByGroupImpl<IndicatorIterator>(out, reductionIndex, groupByIndex, func);
-				break;
-			case SPARSE :
-				reduceByGroupImpl<SparseIterator>(out, reductionIndex, groupByIndex, func);
-				break;
-			case DENSE :
-				reduceByGroupImpl<DenseIterator>(out, reductionIndex, groupByIndex, func);
-				break;
-			case INTERCEPT :
-			    reduceByGroupImpl<InterceptIterator>(out, reductionIndex, groupByIndex, func);
-				break;
-		}
-	}
-
 protected:
 
 	template <typename T, typename F>
@@ -159,17 +130,6 @@ protected:
 		}
 	}
 
-	template <typename IteratorType, typename T, typename F>
-	void reduceByGroupImpl(T& out, const size_t reductionIndex, const size_t groupByIndex, F func) {
-	    IteratorType reduceIt(*this, reductionIndex);
-	    IndicatorIterator groupByIt(*this, groupByIndex);
-
-	    GroupByIterator<IteratorType> it(reduceIt, groupByIt);
-	    for (; it; ++it) {
-	        out[it.group()] += func(it.value()); // TODO compute reduction in registers
-	    }
-	}
-
 	template <typename IteratorType, typename T, typename F>
 	void reduceByGroupImpl(T& out, const size_t reductionIndex, const std::vector<int>& groups, F func) {
 	    IteratorType it(*this, reductionIndex);
@@ -0,0 +1,60 @@
+/*
+ * RcppScoring.cpp
+ *
+ * R bindings for scoring new covariate triplets, fed chunk by chunk, with fitted coefficients.
+ */
+
+#include "Rcpp.h"
+#include "RcppCyclopsInterface.h"
+#include "Scoring.h"
+
+using namespace Rcpp;
+
+namespace {
+
+std::vector<bsccs::IdType> asIds(const NumericVector& ids) {
+    return std::vector<bsccs::IdType>(ids.begin(), ids.end());
+}
+
+} // namespace
+
+// [[Rcpp::export(".cyclopsNewScorer")]]
+SEXP cyclopsNewScorer(const NumericVector& rowIds, const NumericVector& coefficientIds,
+                      const std::vector<double>& coefficients, const std::string& modelType,
+                      const int threads) {
+
+    using namespace bsccs;
+    if (coefficientIds.size() != static_cast<R_xlen_t>(coefficients.size())) {
+        stop("Coefficients and their IDs must have equal length");
+    }
+    XPtr<Scorer> scorer(new Scorer(asIds(coefficientIds), coefficients,
+                                   RcppCcdInterface::parseModelType(modelType), threads), true);
+    scorer->setRows(asIds(rowIds));
+    return scorer;
+}
+
+// [[Rcpp::export(".cyclopsAddToScorer")]]
+void cyclopsAddToScorer(SEXP sexpScorer, const NumericVector& rowIds,
+                        const NumericVector& covariateIds, const NumericVector& covariateValues) {
+
+    using namespace bsccs;
+    XPtr<Scorer> scorer(sexpScorer);
+
+    if (rowIds.size() != covariateIds.size() ||
+        (covariateValues.size() != 0 && covariateValues.size() != rowIds.size())) {
+        stop("Covariate rowIds, covariateIds and covariateValues must have equal length");
+    }
+    const std::vector<IdType> rows = asIds(rowIds);
+    const std::vector<IdType> covariates = asIds(covariateIds);
+    scorer->addCovariates(rows.data(), covariates.data(),
+                          covariateValues.size() == 0 ? nullptr : covariateValues.begin(),
+                          rows.size());
+}
+
+// [[Rcpp::export(".cyclopsScorerResult")]]
+std::vector<double> cyclopsScorerResult(SEXP sexpScorer, const double intercept) {
+
+    using namespace bsccs;
+    XPtr<Scorer> scorer(sexpScorer);
+    return scorer->predict(intercept);
+}
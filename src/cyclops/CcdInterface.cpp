@@ -31,6 +31,7 @@
 
 #include "boost/iterator/counting_iterator.hpp"
 #include "Thread.h"
+#include "Trace.h"
 
 // #include "io/InputReader.h"
 // #include "io/HierarchyReader.h"
@@ -173,6 +174,8 @@ void CcdInterface::setDefaultArguments(void) {
 	arguments.reportRawEstimates = false;
 	arguments.modelName = "sccs";
 	arguments.fileFormat = "generic";
+	arguments.residentMegabytes = 0;
+	arguments.binaryOutput = false;
 	//arguments.outputFormat = "estimates";
 	arguments.computeMLE = false;
 	arguments.fitMLEAtMode = false;
@@ -237,6 +240,7 @@ struct OptimizationProfile {
 	}
 
 	double objective(double x) {
+		trace::Span span("profileEvaluation", "profile", "covariate", index);
 		++nEvals;
 		ccd.setBeta(index, x);
 		ccd.setFixedBeta(index, true);
@@ -312,6 +316,9 @@ double CcdInterface::profileModel(CyclicCoordinateDescent *ccd, ModelData *model
 	// Parallelize across columns and lower/upper bound
 	int nThreads = (inThreads == -1) ?
 	    bsccs::thread::hardware_concurrency() : inThreads;
+	if (ccd->getIsOutOfCore()) { // Bounds would evict each other's columns
+	    nThreads = 1;
+	}
 
 	std::ostringstream stream2;
 	stream2 << "Using " << nThreads << " thread(s)";
@@ -321,6 +328,7 @@ double CcdInterface::profileModel(CyclicCoordinateDescent *ccd, ModelData *model
 
 	ccdPool.push_back(ccd);
 
+	ccd->setThreadCount(1); // Parallelize across bounds only
 	for (int i = 1; i < nThreads; ++i) {
 	    ccdPool.push_back(ccd->clone());
 	}
@@ -574,6 +582,7 @@ double CcdInterface::fitModel(CyclicCoordinateDescent *ccd) {
 	struct timeval time1, time2;
 	gettimeofday(&time1, NULL);
 
+	ccd->setThreadCount(arguments.threads);
 	ccd->update(arguments.modeFinding);
 
 	gettimeofday(&time2, NULL);
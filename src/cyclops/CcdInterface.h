@@ -89,8 +89,12 @@ struct CCDArguments {
 	std::string inFileName;
 	std::string outFileName;
 	std::string fileFormat;
+	std::string binaryFileName; // Save loaded data in binary format
+	int residentMegabytes; // Page binary data from disk within this budget; 0 loads all
 	std::string outDirectoryName;
 	std::vector<std::string> outputFormat;
+	bool binaryOutput; // Write output tables as binary columns instead of CSV
+	std::string traceFileName; // Write a Chrome trace-event timeline of the run
 	bool useGPU;
 	bool useBetterGPU;
 	int deviceNumber;
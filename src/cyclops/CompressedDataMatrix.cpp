@@ -11,12 +11,15 @@
 #include <numeric>
 #include <vector>
 #include <stdexcept>
+#include <unordered_map>
+#include <unordered_set>
 
 #include "CompressedDataMatrix.h"
 
 namespace bsccs {
 
-CompressedDataMatrix::CompressedDataMatrix() : nRows(0), nCols(0), nEntries(0) {
+CompressedDataMatrix::CompressedDataMatrix() : nRows(0), nCols(0), nEntries(0),
+		columnIndexValid(false) {
 	// Do nothing
 }
 
@@ -43,23 +46,92 @@ real CompressedDataMatrix::sumColumn(int column) {
 	return sum;
 }
 
-struct DrugIDComparator {
-	IdType id;
-	DrugIDComparator(IdType i) : id(i) { }
-	bool operator()(const CompressedDataColumn::Ptr& column) {
-		return column->getNumericalLabel() == id;
+void CompressedDataMatrix::buildColumnIndex() const {
+	columnIndex.clear();
+	columnIndex.reserve(allColumns.size());
+	for (size_t i = 0; i < allColumns.size(); ++i) {
+		columnIndex.emplace(allColumns[i]->getNumericalLabel(), i); // keeps the first
 	}
-};
+	columnIndexValid = true;
+}
+
+void CompressedDataMatrix::indexLastColumn() {
+	std::lock_guard<bsccs::mutex> guard(columnIndexLock);
+	if (columnIndexValid) {
+		columnIndex.emplace(allColumns.back()->getNumericalLabel(), allColumns.size() - 1);
+	}
+}
 
 int CompressedDataMatrix::getColumnIndexByName(IdType name) const {
 
-	DrugIDComparator cmp(name);
-	auto found = std::find_if(
-			allColumns.begin(), allColumns.end(), cmp);
-	if (found != allColumns.end()) {
-		return std::distance(allColumns.begin(), found);
-	} else {
-		return -1;
+	std::lock_guard<bsccs::mutex> guard(columnIndexLock);
+	if (!columnIndexValid) {
+		buildColumnIndex();
+	}
+
+	auto found = columnIndex.find(name);
+	if (found != columnIndex.end() && (found->second >= allColumns.size() ||
+			allColumns[found->second]->getNumericalLabel() != name)) {
+		buildColumnIndex(); // Defensive; labels only change through setColumnLabel()
+		found = columnIndex.find(name);
+	}
+	return (found != columnIndex.end()) ? static_cast<int>(found->second) : -1;
+}
+
+MemoryFootprint CompressedDataMatrix::getMemoryFootprint() const {
+	static const char* formatNames[] = { "dense", "sparse", "indicator", "intercept" };
+
+	MemoryFootprint footprint;
+	for (const char* name : formatNames) {
+		memory::add(footprint, "data", name, 0);
+	}
+
+	// Columns are not paged in; out-of-core storage counts only while resident
+	std::unordered_set<const void*> seen;
+	for (const auto& column : allColumns) {
+		uint64_t bytes = 0;
+		if (column->columns && seen.insert(column->columns.get()).second) {
+			bytes += memory::bytes(*column->columns);
+		}
+		if (column->data && seen.insert(column->data.get()).second) {
+			bytes += memory::bytes(*column->data);
+		}
+		memory::add(footprint, "data", formatNames[column->getFormatType()], bytes);
+	}
+
+	std::lock_guard<bsccs::mutex> guard(columnIndexLock);
+	memory::add(footprint, "data", "columns",
+		memory::bytes(allColumns) + allColumns.size() * sizeof(CompressedDataColumn) +
+		memory::hashBytes(columnIndex));
+	return footprint;
+}
+
+void CompressedDataMatrix::setColumnLabel(size_t column, IdType label) {
+
+	std::lock_guard<bsccs::mutex> guard(columnIndexLock);
+	const IdType previous = allColumns[column]->getNumericalLabel();
+	allColumns[column]->add_label(label);
+
+	if (!columnIndexValid || previous == label) {
+		return;
+	}
+
+	// The previous label now first occurs after this column, if at all; freshly
+	// appended columns are last, so this is constant time while loading
+	auto old = columnIndex.find(previous);
+	if (old != columnIndex.end() && old->second == column) {
+		columnIndex.erase(old);
+		for (size_t i = column + 1; i < allColumns.size(); ++i) {
+			if (allColumns[i]->getNumericalLabel() == previous) {
+				columnIndex.emplace(previous, i);
+				break;
+			}
+		}
+	}
+
+	auto inserted = columnIndex.emplace(label, column);
+	if (!inserted.second && inserted.first->second > column) {
+		inserted.first->second = column;
 	}
 }
 
@@ -90,10 +162,12 @@ int CompressedDataMatrix::getColumnIndexByName(IdType name) const {
 // }
 
 void CompressedDataMatrix::convertColumnToSparse(int column) {
+	page(column);
 	allColumns[column]->convertColumnToSparse();
 }
 
 void CompressedDataMatrix::convertColumnToDense(int column) {
+	page(column);
 	allColumns[column]->convertColumnToDense(nRows);
 }
 
@@ -106,6 +180,7 @@ size_t CompressedDataMatrix::getNumberOfColumns(void) const {
 }
 
 size_t CompressedDataMatrix::getNumberOfEntries(int column) const {
+	page(column);
 	return allColumns[column]->getNumberOfEntries();
 }
 
@@ -118,20 +193,24 @@ size_t CompressedDataMatrix::getNumberOfNonZeroEntries(int column) const {
     }
 }
 
-int* CompressedDataMatrix::getCompressedColumnVector(int column) const {
-	return allColumns[column]->getColumns();
+const int* CompressedDataMatrix::getCompressedColumnVector(int column) const {
+	page(column);
+	return static_cast<const CompressedDataColumn&>(*allColumns[column]).getColumns();
 }
 
-std::vector<int>& CompressedDataMatrix::getCompressedColumnVectorSTL(int column) const {
-	return allColumns[column]->getColumnsVector();
+const std::vector<int>& CompressedDataMatrix::getCompressedColumnVectorSTL(int column) const {
+	page(column);
+	return static_cast<const CompressedDataColumn&>(*allColumns[column]).getColumnsVector();
 }
 
-real* CompressedDataMatrix::getDataVector(int column) const {
-	return allColumns[column]->getData();
+const real* CompressedDataMatrix::getDataVector(int column) const {
+	page(column);
+	return static_cast<const CompressedDataColumn&>(*allColumns[column]).getData();
 }
 
-std::vector<real>& CompressedDataMatrix::getDataVectorSTL(int column) const {
-	return allColumns[column]->getDataVector();
+const std::vector<real>& CompressedDataMatrix::getDataVectorSTL(int column) const {
+	page(column);
+	return static_cast<const CompressedDataColumn&>(*allColumns[column]).getDataVector();
 }
 
 
@@ -139,6 +218,22 @@ FormatType CompressedDataMatrix::getFormatType(int column) const {
 	return allColumns[column]->getFormatType();
 }
 
+void CompressedDataMatrix::pinColumn(size_t column) const {
+	if (pager) {
+		pager->pin(*allColumns[column]);
+		const size_t readAhead = std::min(pager->getReadAhead(), nCols - 1);
+		for (size_t i = 1; i <= readAhead; ++i) {
+			pager->prefetch(*allColumns[(column + i) % nCols]);
+		}
+	}
+}
+
+void CompressedDataMatrix::unpinColumn(size_t column) const {
+	if (pager) {
+		pager->unpin(*allColumns[column]);
+	}
+}
+
 void CompressedDataColumn::fill(RealVector& values, int nRows) {
 	values.resize(nRows);
 	if (formatType == DENSE) {
@@ -146,7 +241,7 @@ void CompressedDataColumn::fill(RealVector& values, int nRows) {
 		} else {
 			bool isSparse = formatType == SPARSE;
 			values.assign(nRows, 0.0);
-			int* indicators = getColumns();
+			const int* indicators = getColumns();
 			size_t n = getNumberOfEntries();
 			for (size_t i = 0; i < n; ++i) {
 				const int k = indicators[i];
@@ -215,10 +310,12 @@ CompressedDataMatrix* CompressedDataMatrix::transpose() {
 
 // TODO Fix massive copying
 void CompressedDataMatrix::addToColumnVector(int column, IntVector addEntries) const{
+	page(column);
 	allColumns[column]->addToColumnVector(addEntries);
 }
 
 void CompressedDataMatrix::removeFromColumnVector(int column, IntVector removeEntries) const{
+	page(column);
 	allColumns[column]->removeFromColumnVector(removeEntries);
 }
 
@@ -230,7 +327,7 @@ void CompressedDataMatrix::getDataRow(int row, real* x) const {
 			x[j] = this->getDataVector(j)[row];
 		else{
 			x[j] = 0.0;
-			int* col = this->getCompressedColumnVector(j);
+			const int* col = this->getCompressedColumnVector(j);
 			for(size_t i = 0; i < this->allColumns[j]->getNumberOfEntries(); i++){
 				if(col[i] == row){
 					x[j] = 1.0;
@@ -243,6 +340,72 @@ void CompressedDataMatrix::getDataRow(int row, real* x) const {
 	}
 }
 
+void CompressedDataMatrix::fillRowMajor(CompressedRowMatrix& rowMajor) const {
+	std::vector<size_t>& offsets = rowMajor.offsets;
+	offsets.assign(nRows + 1, 0);
+
+	// Count entries per row
+	for (size_t j = 0; j < nCols; ++j) {
+		const CompressedDataColumn& column = getColumn(j);
+		const FormatType format = column.getFormatType();
+		if (format == INTERCEPT) {
+			for (size_t k = 0; k < nRows; ++k) {
+				++offsets[k + 1];
+			}
+		} else if (format == DENSE) {
+			const std::vector<real>& data = column.getDataVector();
+			const size_t n = std::min(data.size(), nRows);
+			for (size_t k = 0; k < n; ++k) {
+				if (data[k] != static_cast<real>(0)) {
+					++offsets[k + 1];
+				}
+			}
+		} else {
+			const std::vector<int>& rows = column.getColumnsVector();
+			for (auto it = rows.begin(); it != rows.end(); ++it) {
+				++offsets[*it + 1];
+			}
+		}
+	}
+	std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+
+	const size_t nnz = offsets[nRows];
+	rowMajor.columns.resize(nnz);
+	rowMajor.values.resize(nnz);
+
+	// Scatter in column order, so entries within each row remain sorted
+	std::vector<size_t> position(offsets.begin(), offsets.end() - 1);
+	for (size_t j = 0; j < nCols; ++j) {
+		const CompressedDataColumn& column = getColumn(j);
+		const FormatType format = column.getFormatType();
+		if (format == INTERCEPT) {
+			for (size_t k = 0; k < nRows; ++k) {
+				const size_t i = position[k]++;
+				rowMajor.columns[i] = j;
+				rowMajor.values[i] = static_cast<real>(1);
+			}
+		} else if (format == DENSE) {
+			const std::vector<real>& data = column.getDataVector();
+			const size_t n = std::min(data.size(), nRows);
+			for (size_t k = 0; k < n; ++k) {
+				if (data[k] != static_cast<real>(0)) {
+					const size_t i = position[k]++;
+					rowMajor.columns[i] = j;
+					rowMajor.values[i] = data[k];
+				}
+			}
+		} else {
+			const std::vector<int>& rows = column.getColumnsVector();
+			const bool isSparse = format == SPARSE;
+			for (size_t e = 0; e < rows.size(); ++e) {
+				const size_t i = position[rows[e]]++;
+				rowMajor.columns[i] = j;
+				rowMajor.values[i] = isSparse ? column.getDataVector()[e] : static_cast<real>(1);
+			}
+		}
+	}
+}
+
 void CompressedDataMatrix::setNumberOfColumns(int nColumns) {
 	nCols = nColumns;
 }
@@ -274,6 +437,7 @@ void CompressedDataColumn::convertColumnToSparse(void) {
 	if (formatType == SPARSE) {
 		return;
 	}
+	detachStorage();
 	if (formatType == DENSE) {
 // 		fprintf(stderr, "Format not yet support.\n");
 // 		exit(-1);
@@ -294,6 +458,7 @@ void CompressedDataColumn::convertColumnToDense(int nRows) {
 	if (formatType == DENSE) {
 		return;
 	}
+	detachStorage();
 
 //	real_vector* oldData = data;
     RealVectorPtr oldData = data;
@@ -302,7 +467,7 @@ void CompressedDataColumn::convertColumnToDense(int nRows) {
 
 	data->resize(nRows, static_cast<real>(0));
 
-	int* indicators = getColumns();
+	const int* indicators = getColumns();
 	int n = getNumberOfEntries();
 //	int nonzero = 0;
 	for (int i = 0; i < n; ++i) {
@@ -324,6 +489,7 @@ void CompressedDataColumn::convertColumnToDense(int nRows) {
 
 // TODO Fix massive copying
 void CompressedDataColumn::addToColumnVector(IntVector addEntries){
+	detachStorage();
 	int lastit = 0;
 
 	for(int i = 0; i < (int)addEntries.size(); i++)
@@ -340,6 +506,7 @@ void CompressedDataColumn::addToColumnVector(IntVector addEntries){
 }
 
 void CompressedDataColumn::removeFromColumnVector(IntVector removeEntries){
+	detachStorage();
 	int lastit = 0;
 	IntVector::iterator it1 = removeEntries.begin();
 	IntVector::iterator it2 = columns->begin();
@@ -356,6 +523,120 @@ void CompressedDataColumn::removeFromColumnVector(IntVector removeEntries){
 	}
 }
 
+namespace {
+
+inline void hashCombine(size_t& seed, size_t value) {
+	seed ^= value + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+}
+
+} // namespace
+
+size_t CompressedDataColumn::hashContents() const {
+	size_t seed = std::hash<int>()(static_cast<int>(formatType));
+	if (columns) {
+		hashCombine(seed, columns->size());
+		for (auto it = columns->begin(); it != columns->end(); ++it) {
+			hashCombine(seed, std::hash<int>()(*it));
+		}
+	}
+	if (data) {
+		hashCombine(seed, data->size());
+		for (auto it = data->begin(); it != data->end(); ++it) {
+			hashCombine(seed, std::hash<real>()(*it));
+		}
+	}
+	return seed;
+}
+
+bool CompressedDataColumn::equalContents(const CompressedDataColumn& other) const {
+	if (formatType != other.formatType) {
+		return false;
+	}
+	if (formatType == SPARSE || formatType == INDICATOR) {
+		if (*columns != *other.columns) {
+			return false;
+		}
+	}
+	if (formatType == SPARSE || formatType == DENSE) {
+		if (*data != *other.data) {
+			return false;
+		}
+	}
+	return true;
+}
+
+void CompressedDataColumn::shareStorage(const CompressedDataColumn& other) {
+	columns = other.columns;
+	data = other.data;
+	sharedPtrs = true;
+}
+
+void CompressedDataColumn::detachStorage() {
+	if (!sharedPtrs) {
+		return;
+	}
+	if (columns && columns.use_count() > 1) {
+		columns = make_shared<IntVector>(*columns);
+	}
+	if (data && data.use_count() > 1) {
+		data = make_shared<RealVector>(*data);
+	}
+	sharedPtrs = false;
+}
+
+size_t CompressedDataMatrix::shareDuplicateColumns() {
+	if (pager) {
+		return 0; // Paged columns were deduplicated when written
+	}
+
+	std::unordered_map<size_t, std::vector<size_t>> buckets;
+	size_t shared = 0;
+
+	for (size_t j = 0; j < nCols; ++j) {
+		CompressedDataColumn& column = *allColumns[j];
+		if (column.getFormatType() == INTERCEPT) {
+			continue;
+		}
+
+		auto& bucket = buckets[column.hashContents()];
+		bool found = false;
+		for (auto it = bucket.begin(); it != bucket.end(); ++it) {
+			const CompressedDataColumn& original = *allColumns[*it];
+			if (original.getStorageKey() == column.getStorageKey()) {
+				found = true; // Already shared
+				break;
+			}
+			if (original.equalContents(column)) {
+				column.shareStorage(original);
+				allColumns[*it]->shareStorage(original);
+				found = true;
+				break;
+			}
+		}
+		if (found) {
+			++shared;
+		} else {
+			bucket.push_back(j);
+		}
+	}
+	return shared;
+}
+
+std::vector<size_t> CompressedDataMatrix::getSharedColumnMap() const {
+	std::vector<size_t> map(nCols);
+	std::unordered_map<const void*, size_t> first;
+
+	for (size_t j = 0; j < nCols; ++j) {
+		const CompressedDataColumn& column = *allColumns[j];
+		map[j] = j;
+		if (column.isSharedStorage()) {
+			auto inserted = first.insert(std::make_pair(column.getStorageKey(), j));
+			map[j] = inserted.first->second;
+		}
+	}
+	return map;
+}
+
 void CompressedDataColumn::printMatrixMarketFormat(std::ostream& stream, const int rows, const int columnNumber) const {
 
     if (formatType == DENSE || formatType == INTERCEPT) {
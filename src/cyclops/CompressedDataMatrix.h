@@ -19,10 +19,13 @@
 #include <algorithm>
 #include <numeric>
 #include <stdexcept>
+#include <unordered_map>
 
 //#define DATA_AOS
 
 #include "Types.h"
+#include "Thread.h"
+#include "MemoryFootprint.h"
 
 namespace bsccs {
 
@@ -60,12 +63,12 @@ public:
 //		}
 	}
 
-	int* getColumns() const {
-		return static_cast<int*>(columns->data());
+	const int* getColumns() const {
+		return columns->data();
 	}
 
-	real* getData() const {
-		return static_cast<real*>(data->data());
+	const real* getData() const {
+		return data->data();
 	}
 
 	const std::vector<int>& getColumnsVector() const {
@@ -76,14 +79,22 @@ public:
 		return *data;
 	}
 
+	// Mutable access takes a private copy of shared storage
 	std::vector<int>& getColumnsVector() {
+		detachStorage();
 		return *columns;
 	}
 
 	std::vector<real>& getDataVector() {
+		detachStorage();
 		return *data;
 	}
 
+	// Bytes of index and value storage, whether or not shared with other columns
+	uint64_t getStorageBytes() const {
+		return (columns ? memory::bytes(*columns) : 0) + (data ? memory::bytes(*data) : 0);
+	}
+
 	std::vector<real> copyData() {
 // 		std::vector copy(std::begin(data), std::end(data));
 // 		return std::move(copy);
@@ -92,6 +103,7 @@ public:
 
 	template <typename Function>
 	void transform(Function f) {
+	    detachStorage();
 	    std::transform(data->begin(), data->end(), data->begin(), f);
 	}
 
@@ -145,11 +157,8 @@ public:
 		stringName = label;
 	}
 
-	void add_label(IdType label) {
-		numericalName = label;
-	}
-
 	bool add_data(int row, real value) {
+		detachStorage();
 		if (formatType == DENSE) {
 			//Making sure that we are at the correct row
 			for(int i = data->size(); i < row; i++) {
@@ -185,6 +194,32 @@ public:
 
 	void convertColumnToSparse(void);
 
+	/**
+	 * Hash of the format and contents; identical columns hash identically
+	 */
+	size_t hashContents() const;
+
+	bool equalContents(const CompressedDataColumn& other) const;
+
+	/**
+	 * Point this column at the (identical) storage of other; labels are kept
+	 */
+	void shareStorage(const CompressedDataColumn& other);
+
+	bool isSharedStorage() const {
+		return sharedPtrs;
+	}
+
+	const void* getStorageKey() const {
+		return columns ? static_cast<const void*>(columns.get()) :
+		                 static_cast<const void*>(data.get());
+	}
+
+	/**
+	 * Copy-on-write: take a private copy of shared storage before modification
+	 */
+	void detachStorage();
+
 	void fill(RealVector& values, int nRows);
 
 	void printColumn(int nRows);
@@ -218,6 +253,13 @@ public:
 	void printMatrixMarketFormat(std::ostream& stream, const int rows, const int columnNumber) const;
 
 private:
+	friend class CompressedDataMatrix;
+
+	// Numerical labels go through CompressedDataMatrix::setColumnLabel(), which indexes them
+	void add_label(IdType label) {
+		numericalName = label;
+	}
+
 	// Disable copy-constructors and assignment constructors
 	CompressedDataColumn();
 	CompressedDataColumn(const CompressedDataColumn&);
@@ -228,9 +270,76 @@ private:
 	FormatType formatType;
 	mutable std::string stringName;
 	IdType numericalName;
-	bool sharedPtrs; // TODO Actually use shared pointers
+	bool sharedPtrs; // storage may be shared with identical columns
+};
+
+/**
+ * Row-major (CSR) copy of a CompressedDataMatrix; entries within a row are in column order
+ */
+struct CompressedRowMatrix {
+	std::vector<size_t> offsets; // nRows + 1
+	std::vector<int> columns;
+	std::vector<real> values;
+
+	size_t getNumberOfRows() const {
+		return offsets.empty() ? 0 : offsets.size() - 1;
+	}
+
+	size_t getNumberOfEntries() const {
+		return columns.size();
+	}
+
+	template <typename VectorType>
+	real innerProduct(size_t row, const VectorType& beta) const {
+		real sum = static_cast<real>(0);
+		for (size_t i = offsets[row]; i < offsets[row + 1]; ++i) {
+			sum += beta[columns[i]] * values[i];
+		}
+		return sum;
+	}
 };
 
+/**
+ * Supplies column storage on demand when X lives on disk.  Columns are keyed by
+ * identity, so reordering the matrix does not invalidate a pager.
+ */
+class ColumnPager {
+public:
+	virtual ~ColumnPager() { }
+
+	// Make column storage resident; may release unpinned columns to stay within budget
+	virtual void load(const CompressedDataColumn& column) = 0;
+
+	virtual void pin(const CompressedDataColumn& column) = 0;
+
+	virtual void unpin(const CompressedDataColumn& column) = 0;
+
+	// Hint that column will be needed soon
+	virtual void prefetch(const CompressedDataColumn& column) = 0;
+
+	virtual void forget(const CompressedDataColumn& column) = 0;
+
+	/**
+	 * Keep storage derived from a resident column, such as the strata it touches, with
+	 * the column.  It counts against the budget and is dropped when the column is paged
+	 * out; owner is a key unique to the deriving engine.
+	 */
+	virtual void attach(const CompressedDataColumn& column, uint64_t owner,
+		IntVectorPtr storage) = 0;
+
+	// Storage attached by owner that is still resident, or null
+	virtual IntVectorPtr getAttached(const CompressedDataColumn& column,
+		uint64_t owner) const = 0;
+
+	virtual void detach(uint64_t owner) = 0;
+
+	virtual size_t getReadAhead() const = 0;
+
+	virtual size_t getResidentBytes() const = 0;
+};
+
+typedef bsccs::shared_ptr<ColumnPager> ColumnPagerPtr;
+
 class CompressedDataMatrix {
 
 public:
@@ -251,19 +360,21 @@ public:
 
 	size_t getNumberOfNonZeroEntries(int column) const;
 
-	int* getCompressedColumnVector(int column) const; // TODO depreciate
-	std::vector<int>& getCompressedColumnVectorSTL(int column) const;
+	const int* getCompressedColumnVector(int column) const; // TODO depreciate
+	const std::vector<int>& getCompressedColumnVectorSTL(int column) const;
 
 	void removeFromColumnVector(int column, IntVector removeEntries) const;
 	void addToColumnVector(int column, IntVector addEntries) const;
 
- 	real* getDataVector(int column) const;  // TODO depreciate
+	const real* getDataVector(int column) const;  // TODO depreciate
 
-	std::vector<real>& getDataVectorSTL(int column) const;
+	const std::vector<real>& getDataVectorSTL(int column) const;
 
 	void getDataRow(int row, real* x) const;
 	CompressedDataMatrix* transpose();
 
+	void fillRowMajor(CompressedRowMatrix& rowMajor) const;
+
 	FormatType getFormatType(int column) const;
 
 	void convertColumnToDense(int column);
@@ -285,18 +396,53 @@ public:
 	void sortColumns(Comparator cmp) {
 		std::sort(allColumns.begin(), allColumns.end(),
 				cmp);
+		invalidateColumnIndex();
 	}
 
 	const CompressedDataColumn& getColumn(size_t column) const {
+		page(column);
 		return *(allColumns[column]);
 	}
 
 	CompressedDataColumn& getColumn(size_t column) {
+		page(column);
 		return *(allColumns[column]);
 	}
 
+	/**
+	 * Out-of-core mode: column storage is fetched through the pager on access
+	 */
+	void setColumnPager(ColumnPagerPtr columnPager) {
+		pager = columnPager;
+	}
+
+	const ColumnPagerPtr& getColumnPager() const {
+		return pager;
+	}
+
+	bool isOutOfCore() const {
+		return static_cast<bool>(pager);
+	}
+
+	// Threads to use for work spread across columns; paging is not thread-safe across columns
+	int getColumnThreadCount(int nThreads) const {
+		return isOutOfCore() ? 1 : nThreads;
+	}
+
+	// Keep column resident and read ahead of it in sweep order
+	void pinColumn(size_t column) const;
+
+	void unpinColumn(size_t column) const;
+
+	// Position of the first column with this numerical label, or -1
 	int getColumnIndexByName(IdType name) const;
 
+	// Resident column storage by format, counting shared storage once, and the column index
+	virtual MemoryFootprint getMemoryFootprint() const;
+
+	// Set the numerical label of a column, keeping the label index current
+	void setColumnLabel(size_t column, IdType label);
+
 	// Make deep copy
 	template <typename IntVectorItr, typename RealVectorItr>
 	void push_back(
@@ -385,6 +531,7 @@ public:
                 allColumns.rbegin() + reversePosition,
                 allColumns.rbegin() + reversePosition + 1, // rotate one element
                 allColumns.rend());
+            invalidateColumnIndex();
     	}
     }
 
@@ -392,12 +539,27 @@ public:
 		//if (allColumns[column]) {
 		//	delete allColumns[column];
 		//}
+		if (pager) {
+			pager->forget(*allColumns[column]);
+		}
 		allColumns.erase(allColumns.begin() + column);
 		nCols--;
+		invalidateColumnIndex();
 	}
 
 	void printMatrixMarketFormat(std::ostream& stream) const;
 
+	/**
+	 * Detect columns with identical contents and let them share one storage buffer.
+	 * Returns the number of columns that now share storage with an earlier column.
+	 */
+	size_t shareDuplicateColumns();
+
+	/**
+	 * For each column, the index of the first column sharing its storage (or itself)
+	 */
+	std::vector<size_t> getSharedColumnMap() const;
+
 protected:
 
     typedef CompressedDataColumn::Ptr CompressedDataColumnPtr;
@@ -411,6 +573,7 @@ protected:
 		(colIndices, colData, colFormat)
 		);
 		nCols++;
+		indexLastColumn();
 	}
 
 	void replace(int position, IntVectorPtr colIndices, RealVectorPtr colData, FormatType colFormat) {
@@ -420,7 +583,11 @@ protected:
 // 		std::cerr << (colData == nullptr ? "null" : "notnull") << std::endl;
 		auto newColumn = make_unique<CompressedDataColumn>(colIndices, colData, colFormat);
 // 		std::cerr << "New at " << newColumn.get() << std::endl;
+		if (pager) {
+			pager->forget(*allColumns[position]);
+		}
 	    allColumns[position] = std::move(newColumn);
+	    invalidateColumnIndex();
 // 	    std::cerr << "allColumns[" << position << "] = " << allColumns[position].get() << std::endl;
 // 	    std::cerr << "allColumns[0] = " << allColumns[0].get() << std::endl;
 	}
@@ -433,19 +600,65 @@ protected:
 	    (colIndices, colData, colFormat)
 	    );
 	    nCols++;
+	    invalidateColumnIndex();
+	}
+
+	void page(size_t column) const {
+		if (pager) {
+			pager->load(*allColumns[column]);
+		}
+	}
+
+	void invalidateColumnIndex() {
+		std::lock_guard<bsccs::mutex> guard(columnIndexLock);
+		columnIndexValid = false;
+		columnIndex.clear();
 	}
 
+	void indexLastColumn();
+
+	void buildColumnIndex() const;
+
 	size_t nRows;
 	size_t nCols;
 	size_t nEntries;
 	DataColumnVector allColumns;
 
+	ColumnPagerPtr pager;
+
+	// Numerical label -> position of its first column; built on first lookup
+	mutable std::unordered_map<IdType, size_t> columnIndex;
+	mutable bool columnIndexValid;
+	mutable bsccs::mutex columnIndexLock;
+
 private:
 	// Disable copy-constructors and copy-assignment
 	CompressedDataMatrix(const CompressedDataMatrix&);
 	CompressedDataMatrix& operator = (const CompressedDataMatrix&);
 };
 
+/**
+ * Scoped pin of one column; a no-op unless the matrix is out-of-core
+ */
+class PinnedColumn {
+public:
+	PinnedColumn(const CompressedDataMatrix& matrix, size_t column)
+		: matrix(matrix), column(column) {
+		matrix.pinColumn(column);
+	}
+
+	~PinnedColumn() {
+		matrix.unpinColumn(column);
+	}
+
+private:
+	PinnedColumn(const PinnedColumn&);
+	PinnedColumn& operator = (const PinnedColumn&);
+
+	const CompressedDataMatrix& matrix;
+	const size_t column;
+};
+
 } // namespace
 
 #endif /* COMPRESSEDINDICATORMATRIX_H_ */
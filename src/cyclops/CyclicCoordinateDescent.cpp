@@ -15,10 +15,17 @@
 #include <time.h>
 #include <set>
 #include <list>
+#include <algorithm>
+#include <numeric>
 
 #include "CyclicCoordinateDescent.h"
 #include "Iterators.h"
 #include "Timing.h"
+#include "PerformanceCounters.h"
+#include "Trace.h"
+#include "Thread.h"
+
+#include "boost/iterator/counting_iterator.hpp"
 
 namespace bsccs {
 
@@ -48,6 +55,7 @@ CyclicCoordinateDescent::CyclicCoordinateDescent(
 	updateCount = 0;
 	likelihoodCount = 0;
 	noiseLevel = NOISY;
+	nThreads = 1;
 	initialBound = 2.0;
 
 	init(hXI.getHasOffsetCovariate());
@@ -83,6 +91,7 @@ CyclicCoordinateDescent::CyclicCoordinateDescent(const CyclicCoordinateDescent&
 	updateCount = 0;
 	likelihoodCount = 0;
 	noiseLevel = copy.noiseLevel;
+	nThreads = copy.nThreads;
 	initialBound = copy.initialBound;
 
 	init(hXI.getHasOffsetCovariate());
@@ -142,6 +151,13 @@ CyclicCoordinateDescent::~CyclicCoordinateDescent(void) {
 #endif
 }
 
+void CyclicCoordinateDescent::setThreadCount(int threads) {
+	nThreads = (threads == -1) ? bsccs::thread::hardware_concurrency() : threads;
+	if (nThreads < 1) {
+		nThreads = 1;
+	}
+}
+
 void CyclicCoordinateDescent::setNoiseLevel(NoiseLevels noise) {
 	noiseLevel = noise;
 }
@@ -284,6 +300,63 @@ void CyclicCoordinateDescent::getPredictiveEstimates(double* y, double* weights)
 	modelSpecifics.getPredictiveEstimates(y, weights);
 }
 
+void CyclicCoordinateDescent::getBaselineHazard(std::vector<double>& times, std::vector<int>& strata,
+		std::vector<double>& cumulativeHazard) {
+
+	const ModelType modelType = hXI.getModelType();
+	if (modelType != ModelType::COX && modelType != ModelType::COX_RAW) {
+		std::ostringstream stream;
+		stream << "Baseline hazards are only defined for Cox models";
+		error->throwError(stream);
+	}
+
+	checkAllLazyFlags();
+
+	const std::vector<real>& y = hXI.getYVectorRef();
+	const std::vector<real>& time = hXI.getTimeVectorRef();
+	const std::vector<int>& pid = hXI.getPidVectorRef();
+
+	times.clear();
+	strata.clear();
+	cumulativeHazard.clear();
+
+	// Hazard increments come out by decreasing time; flip and sum each stratum once done
+	size_t stratumBegin = 0;
+	auto finishStratum = [&]() {
+		std::reverse(times.begin() + stratumBegin, times.end());
+		std::reverse(cumulativeHazard.begin() + stratumBegin, cumulativeHazard.end());
+		std::partial_sum(cumulativeHazard.begin() + stratumBegin, cumulativeHazard.end(),
+			cumulativeHazard.begin() + stratumBegin);
+	};
+
+	// Rows run by stratum and decreasing time, so each risk set is a running sum.  All rows
+	// tied at a time join the risk set before its events count (Breslow).  COX_RAW has one
+	// stratum, as in the former R implementation, but handles ties the same way.
+	const bool stratified = modelType == ModelType::COX;
+	double riskSet = 0.0;
+	for (int i = 0; i < K; ) {
+		if (stratified && i > 0 && pid[i] != pid[i - 1]) {
+			finishStratum();
+			stratumBegin = times.size();
+			riskSet = 0.0;
+		}
+
+		double events = 0.0;
+		int k = i;
+		for (; k < K && time[k] == time[i] && (!stratified || pid[k] == pid[i]); ++k) {
+			riskSet += std::exp(hXBeta[k]);
+			events += y[k];
+		}
+		const double increment = riskSet > 0.0 ? events / riskSet : 0.0;
+
+		times.push_back(time[i]);
+		strata.push_back(stratified ? pid[i] : 0);
+		cumulativeHazard.push_back(increment);
+		i = k;
+	}
+	finishStratum();
+}
+
 int CyclicCoordinateDescent::getBetaSize(void) {
 	return J;
 }
@@ -377,6 +450,20 @@ void CyclicCoordinateDescent::makeDirty(void) {
 	sufficientStatisticsKnown = false;
 }
 
+MemoryFootprint CyclicCoordinateDescent::getMemoryFootprint() const {
+	MemoryFootprint footprint = modelSpecifics.getMemoryFootprint();
+	const std::string owner = "solver";
+
+	memory::add(footprint, owner, "J", memory::bytes(hBeta) + memory::bytes(hDelta) +
+		memory::bytes(fixBeta));
+	memory::add(footprint, owner, "K", memory::bytes(hWeights));
+	memory::add(footprint, owner, "hessian",
+		(hessianMatrix.size() + varianceMatrix.size()) * sizeof(double) +
+		memory::bytes(hessianIndexMap));
+
+	return footprint;
+}
+
 void CyclicCoordinateDescent::setPriorType(int iPriorType) {
 	if (iPriorType < priors::NONE || iPriorType > priors::NORMAL) {
 	    std::ostringstream stream;
@@ -577,6 +664,9 @@ void CyclicCoordinateDescent::kktSwindle(const ModeFindingArguments& arguments)
 
 	while (!done) {
 
+		performance::ScopedCounter counter(performance::KKT_PASS);
+		trace::Span span("kktPass", "fit", "pass", swindleIterationCount);
+
 		if (noiseLevel >= QUIET) {
 			std::ostringstream stream;
 			stream << "\nKKT Swindle count " << swindleIterationCount << ", activeSet size =  " << activeSet.size();
@@ -769,6 +859,7 @@ void CyclicCoordinateDescent::findMode(
 	}
 
 	resetBounds();
+	buildSweepPlan();
 
 	bool done = false;
 	int iteration = 0;
@@ -782,24 +873,50 @@ void CyclicCoordinateDescent::findMode(
 
 	while (!done) {
 
+		trace::Span span("sweep", "fit", "iteration", iteration + 1);
+
 		// Do a complete cycle
-		for(int index = 0; index < J; index++) {
-
-			if (!fixBeta[index]) {
-				double delta = ccdUpdateBeta(index);
-				delta = applyBounds(delta, index);
-				if (delta != 0.0) {
-					sufficientStatisticsKnown = false;
-					updateSufficientStatistics(delta, index);
-				}
+		int finished = 0; // Coordinates reported so far
+		auto logFinished = [this, &finished](const int end) {
+			for (; finished + progressInterval <= end; finished += progressInterval) {
+				std::ostringstream stream;
+				stream << "Finished variable " << (finished + progressInterval);
+				logger->writeLine(stream);
 			}
+		};
 
-			if ( (noiseLevel > QUIET) && ((index+1) % 100 == 0)) {
-			    std::ostringstream stream;
-			    stream << "Finished variable " << (index+1);
-			    logger->writeLine(stream);
+		if (sweepPlan.empty()) {
+			for(int index = 0; index < J; index++) {
+
+				if (!fixBeta[index]) {
+					updateCoordinate(index);
+				}
+
+				if (noiseLevel > QUIET) {
+					logFinished(index + 1);
+				}
 			}
+		} else {
+			for (const auto& run : sweepPlan) {
+				if (noiseLevel > QUIET) {
+					logFinished(run.begin); // Fixed columns before this run
+				}
+
+				if (run.penalty.type == priors::PenaltyType::OTHER) {
+					for (int index = run.begin; index < run.end; ++index) {
+						updateCoordinate(index);
+					}
+				} else {
+					modelSpecifics.sweep(run, hBeta.data(), hDelta.data(), useCrossValidation);
+				}
 
+				if (noiseLevel > QUIET) {
+					logFinished(run.end);
+				}
+			}
+			if (noiseLevel > QUIET) {
+				logFinished(J); // Fixed columns at the end
+			}
 		}
 
 		iteration++;
@@ -987,6 +1104,8 @@ void CyclicCoordinateDescent::computeAsymptoticPrecisionMatrix(void) {
 			const int j = indices[jj];
 //			std::cerr << "(" << i << "," << j << ")" << std::endl;
 			double fisherInformation = 0.0;
+			PinnedColumn pinnedI(hXI, i);
+			PinnedColumn pinnedJ(hXI, j);
 			modelSpecifics.computeFisherInformation(i, j, &fisherInformation, useCrossValidation);
 //			if (fisherInformation != 0.0) {
 				// Add tuple to sparse matrix
@@ -1017,6 +1136,51 @@ void CyclicCoordinateDescent::computeAsymptoticVarianceMatrix(void) {
 // 	cout << varianceMatrix << endl;
 }
 
+/**
+ * Groups the free columns into runs that share a format and a closed-form prior, so the
+ * engine can update each run without per-column virtual calls or format switches.
+ * Coordinates keep their order, so results match the column-by-column path exactly.
+ * Columns without non-zero entries or a closed-form prior fall into runs of type OTHER.
+ * When progress is logged, runs also break every progressInterval columns.  The plan
+ * stays empty (column-by-column updates) for out-of-core data, whose columns are paged
+ * in one at a time.
+ */
+void CyclicCoordinateDescent::buildSweepPlan() {
+	sweepPlan.clear();
+	if (hXI.isOutOfCore()) {
+		return;
+	}
+	const bool logProgress = noiseLevel > QUIET;
+
+	for (int index = 0; index < J; ++index) {
+		if (fixBeta[index]) {
+			continue;
+		}
+		const FormatType format = hXI.getFormatType(index);
+		const priors::Penalty penalty = (hXI.getNumberOfNonZeroEntries(index) > 0) ?
+			jointPrior->getPenalty(index) : priors::Penalty();
+
+		if (!sweepPlan.empty() && sweepPlan.back().end == index &&
+				sweepPlan.back().format == format && sweepPlan.back().penalty == penalty &&
+				!(logProgress && index % progressInterval == 0)) {
+			++sweepPlan.back().end;
+		} else {
+			SweepRun run = { index, index + 1, format, penalty };
+			sweepPlan.push_back(run);
+		}
+	}
+}
+
+void CyclicCoordinateDescent::updateCoordinate(int index) {
+	PinnedColumn pinned(hXI, index);
+	double delta = ccdUpdateBeta(index);
+	delta = applyBounds(delta, index);
+	if (delta != 0.0) {
+		sufficientStatisticsKnown = false;
+		updateSufficientStatistics(delta, index);
+	}
+}
+
 double CyclicCoordinateDescent::ccdUpdateBeta(int index) {
 
 	if (!sufficientStatisticsKnown) {
@@ -1072,15 +1236,60 @@ void CyclicCoordinateDescent::axpyXBeta(const double beta, const int j) {
 }
 
 void CyclicCoordinateDescent::computeXBeta(void) {
-	// Note: X is current stored in (sparse) column-major format, which is
-	// inefficient for forming X\beta.
-	// TODO Make row-major version of X
+	// Note: X is stored in (sparse) column-major format; a full recompute from dense
+	// coefficients walks the cached row-major mirror instead.
+
+	bool denseBeta = false;
+	if (setBetaList.empty() && !hXI.isOutOfCore()) {
+		// Entries of X under a non-zero free coefficient; fixed columns such as the offset
+		// do not count, so cold starts and folds never build the mirror
+		uint64_t activeEntries = 0;
+		uint64_t totalEntries = 0;
+		for (int j = 0; j < J; ++j) {
+			const uint64_t entries = hXI.getNumberOfNonZeroEntries(j);
+			totalEntries += entries;
+			if (hBeta[j] != static_cast<double>(0.0) && !fixBeta[j]) {
+				activeEntries += entries;
+			}
+		}
+		denseBeta = activeEntries > 0 && activeEntries * denseXBetaRatio >= totalEntries;
+	}
 
-	if (setBetaList.empty()) { // Update all
-		// clear X\beta
+	if (setBetaList.empty() && !denseBeta) {
+		// Column updates touch only the non-zero coefficients; out-of-core the mirror
+		// would hold all of X in memory
 		zeroVector(hXBeta.data(), K);
 		for (int j = 0; j < J; ++j) {
-			axpyXBeta(hBeta[j], j);
+			if (hBeta[j] != static_cast<double>(0.0)) {
+				PinnedColumn pinned(hXI, j);
+				axpyXBeta(hBeta[j], j);
+			}
+		}
+	} else if (setBetaList.empty()) { // Update all
+		const ModelData::CompressedRowMatrixPtr mirror = hXI.getRowMajorMatrix();
+		const CompressedRowMatrix& rows = *mirror;
+
+		// Rows are independent, so any partition gives identical results
+		const size_t chunkSize = 16384;
+		const size_t nChunks = (K + chunkSize - 1) / chunkSize;
+
+		auto computeChunk = [this, &rows, chunkSize](size_t chunk) {
+			const size_t end = std::min(static_cast<size_t>(K), (chunk + 1) * chunkSize);
+			for (size_t k = chunk * chunkSize; k < end; ++k) {
+				hXBeta[k] = rows.innerProduct(k, hBeta);
+			}
+		};
+
+		if (nThreads > 1 && nChunks > 1) {
+			auto scheduler = TaskScheduler<boost::counting_iterator<size_t> >(
+				boost::make_counting_iterator(static_cast<size_t>(0)),
+				boost::make_counting_iterator(nChunks),
+				nThreads);
+			scheduler.execute(computeChunk);
+		} else {
+			for (size_t chunk = 0; chunk < nChunks; ++chunk) {
+				computeChunk(chunk);
+			}
 		}
 	} else {
 		while (!setBetaList.empty()) {
@@ -1123,22 +1332,7 @@ double CyclicCoordinateDescent::computeConvergenceCriterion(double newObjFxn, do
 }
 
 double CyclicCoordinateDescent::applyBounds(double delta, int index) {
-
-    auto doBound = true;
-    if (doBound) {
-	    if (delta < -hDelta[index]) {
-		    delta = -hDelta[index];
-	    } else if (delta > hDelta[index]) {
-		    delta = hDelta[index];
-	    }
-
-	    // TODO Remove magic numbers
-	    auto intermediate = std::max(std::abs(delta) * 2, hDelta[index] / 2);
-	    intermediate = std::max(intermediate, 1E-3);
-	    hDelta[index] = intermediate;
-    }
-
-	return delta;
+	return applyTrustRegion(delta, hDelta[index]);
 }
 
 /**
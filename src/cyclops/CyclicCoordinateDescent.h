@@ -77,6 +77,11 @@ public:
 
 	void getPredictiveEstimates(double* y, double* weights) const;
 
+	// Breslow cumulative baseline hazard of a Cox fit at each distinct time, by stratum
+	// and increasing time
+	void getBaselineHazard(std::vector<double>& times, std::vector<int>& strata,
+			std::vector<double>& cumulativeHazard);
+
 	double getLogPrior(void);
 
 	virtual double getObjectiveFunction(int convergenceType);
@@ -159,8 +164,17 @@ public:
 
 	void setNoiseLevel(NoiseLevels);
 
+	void setThreadCount(int threads);
+
+	bool getIsOutOfCore() const {
+		return hXI.isOutOfCore();
+	}
+
 	void makeDirty(void);
 
+	// State held by this solver and its engine, i.e. what each cross-validation clone adds
+	MemoryFootprint getMemoryFootprint() const;
+
 	void setInitialBound(double bound);
 
 	Matrix computeFisherInformation(const std::vector<size_t>& indices) const;
@@ -255,6 +269,10 @@ protected:
 
 	double ccdUpdateBeta(int index);
 
+	void updateCoordinate(int index);
+
+	void buildSweepPlan(void);
+
 	double applyBounds(
 			double inDelta,
 			int index);
@@ -337,6 +355,8 @@ protected:
 	int likelihoodCount;
 
 	NoiseLevels noiseLevel;
+	int nThreads; // for row-wise passes
+	static const int denseXBetaRatio = 2; // Use the mirror once 1 / ratio of X has non-zero coefficients
 	UpdateReturnFlags lastReturnFlag;
 	int lastIterationCount;
 
@@ -351,6 +371,9 @@ protected:
 
 	SetBetaContainer setBetaList;
 
+	std::vector<SweepRun> sweepPlan; // Free columns of the current findMode(), in order
+	static const int progressInterval = 100; // Columns per "Finished variable" line
+
 	string crossValidationInfo;
 
 	loggers::ProgressLoggerPtr logger;
@@ -0,0 +1,203 @@
+/*
+ * GroupBy.cpp
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <stdexcept>
+
+#include "GroupBy.h"
+#include "Thread.h"
+
+namespace bsccs {
+
+namespace {
+
+const size_t minimumSliceLength = 1 << 16;
+
+// All requested powers of one entry accumulate into out[power * nGroups + group]
+inline void accumulate(double* out, const std::vector<int>& powers, const size_t nGroups,
+		const size_t group, const double x) {
+	for (size_t p = 0; p < powers.size(); ++p) {
+		double term;
+		switch (powers[p]) {
+			case 0 :
+				term = (x == 0.0) ? 0.0 : 1.0;
+				break;
+			case 1 :
+				term = x;
+				break;
+			default :
+				term = x * x;
+				break;
+		}
+		out[p * nGroups + group] += term;
+	}
+}
+
+} // namespace
+
+std::vector<double> GroupBy::reduceColumns(const CompressedDataMatrix& data,
+		const std::vector<size_t>& columns, const int* groups, size_t nGroups,
+		const std::vector<int>& powers, int nThreads) {
+
+	for (int power : powers) {
+		if (power < 0 || power > 2) {
+			throw std::invalid_argument("Only powers 0, 1 and 2 are allowed");
+		}
+	}
+	nGroups = std::max(nGroups, static_cast<size_t>(1));
+
+	const size_t stride = powers.size() * nGroups;
+	std::vector<double> result(columns.size() * stride, 0.0);
+
+	nThreads = data.getColumnThreadCount(nThreads);
+
+	const size_t nRows = data.getNumberOfRows();
+	forEachTask(columns.size(), nThreads, [&](const size_t c) {
+		const PinnedColumn pinned(data, columns[c]);
+		const CompressedDataColumn& column = data.getColumn(columns[c]);
+		double* out = &result[c * stride];
+
+		switch (column.getFormatType()) {
+			case INDICATOR : {
+				const std::vector<int>& rows = column.getColumnsVector();
+				for (int row : rows) {
+					accumulate(out, powers, nGroups, groups ? groups[row] : 0, 1.0);
+				}
+				break;
+			}
+			case SPARSE : {
+				const std::vector<int>& rows = column.getColumnsVector();
+				const std::vector<real>& values = column.getDataVector();
+				for (size_t k = 0; k < rows.size(); ++k) {
+					accumulate(out, powers, nGroups, groups ? groups[rows[k]] : 0, values[k]);
+				}
+				break;
+			}
+			case DENSE : {
+				const std::vector<real>& values = column.getDataVector();
+				for (size_t row = 0; row < nRows; ++row) {
+					accumulate(out, powers, nGroups, groups ? groups[row] : 0, values[row]);
+				}
+				break;
+			}
+			case INTERCEPT : {
+				for (size_t row = 0; row < nRows; ++row) {
+					accumulate(out, powers, nGroups, groups ? groups[row] : 0, 1.0);
+				}
+				break;
+			}
+		}
+	});
+
+	return result;
+}
+
+GroupBySum::GroupBySum(size_t nValues, int nThreads)
+	: nValues(nValues), nThreads(std::max(nThreads, 1)), partials(this->nThreads) {
+	for (auto& partial : partials) {
+		partial.missingSums.resize(nValues, 0.0);
+	}
+}
+
+void GroupBySum::addSlice(Partial& partial, const double* keys,
+		const std::vector<const double*>& values, size_t begin, size_t end) {
+
+	double lastKey = 0.0;
+	size_t lastGroup = 0;
+	bool haveLast = false;
+
+	for (size_t i = begin; i < end; ++i) {
+		const double key = keys[i];
+		double* sums;
+		if (std::isnan(key)) {
+			partial.hasMissing = true;
+			sums = partial.missingSums.data();
+		} else {
+			if (!haveLast || key != lastKey) { // sorted runs reuse the previous group
+				auto inserted = partial.index.insert(std::make_pair(key, partial.keys.size()));
+				if (inserted.second) {
+					partial.keys.push_back(key);
+					partial.sums.resize(partial.sums.size() + nValues, 0.0);
+				}
+				lastKey = key;
+				lastGroup = inserted.first->second;
+				haveLast = true;
+			}
+			sums = &partial.sums[lastGroup * nValues];
+		}
+		for (size_t v = 0; v < nValues; ++v) {
+			sums[v] += values[v][i];
+		}
+	}
+}
+
+void GroupBySum::add(const double* keys, const std::vector<const double*>& values, size_t length) {
+
+	if (values.size() != nValues) {
+		throw std::invalid_argument("Number of value vectors does not match");
+	}
+
+	const size_t nSlices = std::max(static_cast<size_t>(1),
+		std::min(static_cast<size_t>(nThreads), length / minimumSliceLength));
+
+	forEachTask(nSlices, nThreads, [&](const size_t s) {
+		addSlice(partials[s], keys, values, length * s / nSlices, length * (s + 1) / nSlices);
+	});
+}
+
+void GroupBySum::finish(std::vector<double>& keys, std::vector<double>& sums) const {
+
+	// Merge partials in thread order, so sums do not depend on scheduling
+	std::unordered_map<double, size_t> index;
+	std::vector<double> mergedKeys;
+	std::vector<double> mergedSums;
+	std::vector<double> missingSums(nValues, 0.0);
+	bool hasMissing = false;
+
+	for (const auto& partial : partials) {
+		for (size_t g = 0; g < partial.keys.size(); ++g) {
+			auto inserted = index.insert(std::make_pair(partial.keys[g], mergedKeys.size()));
+			if (inserted.second) {
+				mergedKeys.push_back(partial.keys[g]);
+				mergedSums.resize(mergedSums.size() + nValues, 0.0);
+			}
+			const size_t group = inserted.first->second;
+			for (size_t v = 0; v < nValues; ++v) {
+				mergedSums[group * nValues + v] += partial.sums[g * nValues + v];
+			}
+		}
+		if (partial.hasMissing) {
+			hasMissing = true;
+			for (size_t v = 0; v < nValues; ++v) {
+				missingSums[v] += partial.missingSums[v];
+			}
+		}
+	}
+
+	std::vector<size_t> order(mergedKeys.size());
+	std::iota(order.begin(), order.end(), 0);
+	std::sort(order.begin(), order.end(), [&mergedKeys](size_t lhs, size_t rhs) {
+		return mergedKeys[lhs] < mergedKeys[rhs];
+	});
+
+	const size_t nGroups = order.size() + (hasMissing ? 1 : 0);
+	keys.resize(nGroups);
+	sums.resize(nValues * nGroups);
+	for (size_t g = 0; g < order.size(); ++g) {
+		keys[g] = mergedKeys[order[g]];
+		for (size_t v = 0; v < nValues; ++v) {
+			sums[v * nGroups + g] = mergedSums[order[g] * nValues + v];
+		}
+	}
+	if (hasMissing) {
+		keys[nGroups - 1] = NAN;
+		for (size_t v = 0; v < nValues; ++v) {
+			sums[v * nGroups + nGroups - 1] = missingSums[v];
+		}
+	}
+}
+
+} // namespace
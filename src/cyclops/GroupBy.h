@@ -0,0 +1,68 @@
+/*
+ * GroupBy.h
+ *
+ * Native grouped reductions, over ModelData columns (groups given per row, e.g. strata)
+ * and over external key / value vectors (groups found by hashing the keys).  Neither
+ * calls back into R; external vectors are fed chunk by chunk.
+ */
+
+#ifndef GROUPBY_H_
+#define GROUPBY_H_
+
+#include <unordered_map>
+#include <vector>
+
+#include "CompressedDataMatrix.h"
+
+namespace bsccs {
+
+class GroupBy {
+public:
+
+	/**
+	 * Sums of x^p over the entries of each column by group, for p in {0, 1, 2}, where
+	 * x^0 counts non-zeros.  groups maps rows to [0, nGroups); null places every row in
+	 * a single group.  All powers of a column come from one pass and columns are spread
+	 * over threads.  Returns sums laid out as [column][power][group].
+	 */
+	static std::vector<double> reduceColumns(const CompressedDataMatrix& data,
+		const std::vector<size_t>& columns, const int* groups, size_t nGroups,
+		const std::vector<int>& powers, int nThreads = 1);
+};
+
+/**
+ * Hashed sum of several value vectors by a shared key.  Each thread aggregates its
+ * slice of every chunk into a private partial; runs of equal keys skip the hash
+ * lookup.  NaN keys form one group, reported last.
+ */
+class GroupBySum {
+public:
+	GroupBySum(size_t nValues, int nThreads = 1);
+
+	void add(const double* keys, const std::vector<const double*>& values, size_t length);
+
+	// Keys in increasing order and sums laid out as [value][group]
+	void finish(std::vector<double>& keys, std::vector<double>& sums) const;
+
+private:
+	struct Partial {
+		std::unordered_map<double, size_t> index;
+		std::vector<double> keys;
+		std::vector<double> sums; // [group][value]
+		std::vector<double> missingSums;
+		bool hasMissing;
+
+		Partial() : hasMissing(false) { }
+	};
+
+	void addSlice(Partial& partial, const double* keys,
+		const std::vector<const double*>& values, size_t begin, size_t end);
+
+	size_t nValues;
+	int nThreads;
+	std::vector<Partial> partials;
+};
+
+} // namespace
+
+#endif /* GROUPBY_H_ */
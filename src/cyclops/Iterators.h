@@ -383,8 +383,8 @@ class GenericIterator {
 
   protected:
     const FormatType mFormatType;
-    Scalar* mValues;
-    Index* mIndices;
+    const Scalar* mValues;
+    const Index* mIndices;
     Index mId;
     Index mEnd;
 };
@@ -0,0 +1,93 @@
+/*
+ * MemoryFootprint.h
+ *
+ * Bytes held by the data, engine and solver, by component.  Vectors count their
+ * capacity; maps count their nodes and buckets at typical libstdc++ / libc++ overheads.
+ * Storage shared between objects (duplicate columns, the data referenced by every
+ * cross-validation clone) is counted once, by its owner.
+ *
+ * Owners are "data" (ModelData), "engine" (AbstractModelSpecifics) and "solver"
+ * (CyclicCoordinateDescent).  Engine components are grouped by length: "K" (rows),
+ * "N" (strata) and "J" (columns), plus "sparseIndices", "hessianCrossTerms",
+ * "hessianSparseCrossTerms" and "ties".
+ */
+
+#ifndef MEMORYFOOTPRINT_H_
+#define MEMORYFOOTPRINT_H_
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace bsccs {
+
+struct MemoryRecord {
+	std::string owner;
+	std::string component;
+	uint64_t bytes;
+};
+
+typedef std::vector<MemoryRecord> MemoryFootprint;
+
+namespace memory {
+
+template <typename T>
+inline uint64_t bytes(const std::vector<T>& vector) {
+	return vector.capacity() * sizeof(T);
+}
+
+inline uint64_t bytes(const std::vector<bool>& vector) {
+	return (vector.capacity() + 7) / 8;
+}
+
+template <typename Key, typename Value>
+inline uint64_t bytes(const std::map<Key, Value>& map) {
+	return map.size() * (sizeof(std::pair<const Key, Value>) + 4 * sizeof(void*));
+}
+
+// Any unordered map, including std::tr1 on older Windows toolchains
+template <typename HashMap>
+inline uint64_t hashBytes(const HashMap& map) {
+	return map.bucket_count() * sizeof(void*) +
+		map.size() * (sizeof(typename HashMap::value_type) + 2 * sizeof(void*));
+}
+
+// Adds to the record of the same owner and component, if any
+inline void add(MemoryFootprint& footprint, const std::string& owner,
+		const std::string& component, uint64_t bytes) {
+	for (auto& record : footprint) {
+		if (record.owner == owner && record.component == component) {
+			record.bytes += bytes;
+			return;
+		}
+	}
+	MemoryRecord record = { owner, component, bytes };
+	footprint.push_back(record);
+}
+
+inline uint64_t total(const MemoryFootprint& footprint) {
+	uint64_t sum = 0;
+	for (const auto& record : footprint) {
+		sum += record.bytes;
+	}
+	return sum;
+}
+
+/**
+ * Expected peak when cross-validating with the given number of threads.  Each thread
+ * after the first works on a clone of the solver and engine, which share the data;
+ * every thread also holds a fold selector (one int per row) and weights (one real per
+ * row).
+ */
+inline uint64_t estimateForThreads(const MemoryFootprint& data, const MemoryFootprint& clone,
+		size_t rows, size_t realSize, int threads) {
+	const uint64_t perThread = rows * (sizeof(int) + realSize);
+	return total(data) + threads * (total(clone) + perThread);
+}
+
+} // namespace memory
+
+} // namespace bsccs
+
+#endif /* MEMORYFOOTPRINT_H_ */
@@ -16,9 +16,11 @@
 #include <numeric>
 #include <list>
 #include <functional>
+#include <limits>
 
 #include <boost/iterator/permutation_iterator.hpp>
 #include <boost/iterator/transform_iterator.hpp>
+#include <boost/iterator/counting_iterator.hpp>
 
 #include "ModelData.h"
 
@@ -32,7 +34,8 @@ ModelData::ModelData(
     loggers::ProgressLoggerPtr _log,
     loggers::ErrorHandlerPtr _error
     ) : modelType(_modelType), nPatients(0), nStrata(0), hasOffsetCovariate(false), hasInterceptCovariate(false), isFinalized(false),
-        lastStratumMap(0,0), sparseIndexer(*this), log(_log), error(_error), touchedY(true), touchedX(true) {
+        lastStratumMap(0,0), sparseIndexer(*this), log(_log), error(_error), touchedY(true), touchedX(true),
+        columnQuantilesValid(false), columnStatisticsRows(0) {
 	// Do nothing
 }
 
@@ -49,6 +52,160 @@ size_t ModelData::getColumnIndex(const IdType covariate) const {
 
 void ModelData::moveTimeToCovariate(bool takeLog) {
     push_back(NULL, make_shared<RealVector>(offs.begin(), offs.end()), DENSE); // TODO Remove copy?
+    touchX();
+}
+
+void ModelData::checkInMemory() const {
+    if (isOutOfCore()) {
+        std::ostringstream stream;
+        stream << "Covariates paged from disk are read-only";
+        error->throwError(stream);
+    }
+}
+
+void ModelData::touchX() {
+    {
+        std::lock_guard<bsccs::mutex> guard(rowMajorLock);
+        touchedX = true;
+        rowMajor.reset();
+    }
+    std::lock_guard<bsccs::mutex> guard(columnStatisticsLock);
+    columnStatistics.reset();
+    columnQuantilesValid = false;
+}
+
+ModelData::ColumnStatisticsPtr ModelData::getColumnStatistics(bool withQuantiles,
+        int nThreads) const {
+    std::lock_guard<bsccs::mutex> guard(columnStatisticsLock);
+
+    const size_t nColumns = getNumberOfColumns();
+    const bool needMoments = !(columnStatistics && columnStatistics->size() == nColumns
+            && columnStatisticsRows == getNumberOfRows());
+    const bool needQuantiles = withQuantiles && (needMoments || !columnQuantilesValid);
+    if (!needMoments && !needQuantiles) {
+        return columnStatistics;
+    }
+
+    // Fill a copy, so callers still holding the previous statistics are unaffected
+    auto updated = needMoments ?
+        make_shared<std::vector<ColumnStatistics>>(nColumns) :
+        make_shared<std::vector<ColumnStatistics>>(*columnStatistics);
+    std::vector<ColumnStatistics>& statisticsList = *updated;
+
+    nThreads = getColumnThreadCount(nThreads);
+
+    TaskScheduler<boost::counting_iterator<size_t>> scheduler(
+        boost::make_counting_iterator(static_cast<size_t>(0)),
+        boost::make_counting_iterator(nColumns),
+        std::max(nThreads, 1));
+    std::vector<std::vector<real>> scratch(scheduler.getThreadCount()); // per-thread copies for selection
+
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+
+    scheduler.execute([this, &scheduler, &scratch, &statisticsList, needMoments, needQuantiles,
+            nan](const size_t index) {
+        const PinnedColumn pinned(*this, index);
+        const CompressedDataColumn& column = getColumn(index);
+        ColumnStatistics& statistics = statisticsList[index];
+
+        const FormatType format = column.getFormatType();
+        if (format == INDICATOR || format == INTERCEPT) {
+            const double count = (format == INDICATOR) ?
+                column.getNumberOfEntries() : getNumberOfRows();
+            const double one = count > 0 ? 1.0 : 0.0;
+            statistics = ColumnStatistics{count, count, one, one, one};
+            return;
+        }
+
+        const std::vector<real>& data = column.getDataVector();
+        if (needMoments) {
+            double sum = 0.0;
+            double squaredSum = 0.0;
+            double maxAbs = 0.0;
+            for (const real x : data) {
+                sum += x;
+                squaredSum += x * x;
+                maxAbs = std::max(maxAbs, static_cast<double>(std::abs(x)));
+            }
+            statistics = ColumnStatistics{sum, squaredSum, maxAbs, nan, nan};
+        }
+
+        if (needQuantiles && !data.empty()) {
+            std::vector<real>& values = scratch[scheduler.getThreadIndex(index)];
+            values.resize(data.size());
+            std::transform(data.begin(), data.end(), values.begin(), [](real x) {
+                return std::abs(x);
+            });
+            statistics.quantile95Abs = quantile(values.begin(), values.end(), 0.95);
+            statistics.medianAbs = median(values.begin(), values.end());
+        }
+    });
+
+    columnStatistics = updated;
+    columnQuantilesValid = withQuantiles || (!needMoments && columnQuantilesValid);
+    columnStatisticsRows = getNumberOfRows();
+    return columnStatistics;
+}
+
+MemoryFootprint ModelData::getMemoryFootprint() const {
+	MemoryFootprint footprint = CompressedDataMatrix::getMemoryFootprint();
+
+	memory::add(footprint, "data", "outcomes",
+		memory::bytes(y) + memory::bytes(z) + memory::bytes(offs) + memory::bytes(nevents));
+	memory::add(footprint, "data", "strata", memory::bytes(pid));
+
+	uint64_t labelBytes = memory::bytes(labels) + memory::hashBytes(rowIdMap);
+	for (const auto& label : labels) {
+		if (label.capacity() >= sizeof(std::string)) { // Not held in place
+			labelBytes += label.capacity() + 1;
+		}
+	}
+	memory::add(footprint, "data", "rowLabels", labelBytes);
+
+	std::lock_guard<bsccs::mutex> guard(rowMajorLock);
+	memory::add(footprint, "data", "rowMajor", rowMajor ?
+		memory::bytes(rowMajor->offsets) + memory::bytes(rowMajor->columns) +
+		memory::bytes(rowMajor->values) : 0);
+	return footprint;
+}
+
+ModelData::CompressedRowMatrixPtr ModelData::getRowMajorMatrix() const {
+    std::lock_guard<bsccs::mutex> guard(rowMajorLock);
+    if (!rowMajor || rowMajor->getNumberOfRows() != getNumberOfRows()) {
+        auto newRowMajor = make_shared<CompressedRowMatrix>();
+        fillRowMajor(*newRowMajor);
+        rowMajor = newRowMajor;
+    }
+    return rowMajor;
+}
+
+uint64_t ModelData::getPendingRowMajorBytes() const {
+    if (isOutOfCore()) {
+        return 0;
+    }
+    {
+        std::lock_guard<bsccs::mutex> guard(rowMajorLock);
+        if (rowMajor && rowMajor->getNumberOfRows() == getNumberOfRows()) {
+            return 0;
+        }
+    }
+
+    uint64_t entries = 0; // dense columns counted in full, an upper bound
+    for (size_t j = 0; j < getNumberOfColumns(); ++j) {
+        const CompressedDataColumn& column = getColumn(j);
+        entries += (column.getFormatType() == DENSE || column.getFormatType() == INTERCEPT) ?
+            getNumberOfRows() : column.getNumberOfEntries();
+    }
+    return (getNumberOfRows() + 1) * sizeof(size_t) + entries * (sizeof(int) + sizeof(real));
+}
+
+void ModelData::getDataRow(int row, real* x) const {
+    const auto mirror = getRowMajorMatrix();
+    const CompressedRowMatrix& rows = *mirror;
+    std::fill(x, x + getNumberOfColumns(), static_cast<real>(0));
+    for (size_t i = rows.offsets[row]; i < rows.offsets[row + 1]; ++i) {
+        x[rows.columns[i]] = rows.values[i];
+    }
 }
 
 void ModelData::loadY(
@@ -139,93 +296,146 @@ int ModelData::loadMultipleX(
 		const bool checkCovariateIds,
 		const bool checkCovariateBounds,
 		const bool append,
-		const bool forceSparse) {
+		const bool forceSparse,
+		const int nThreads) {
 
-	auto columnIdItr = std::begin(covariateIds);
-	const auto columnIdEnd = std::end(covariateIds);
-	auto rowIdItr = std::begin(rowIds);
-	auto covariateValueItr = std::begin(covariateValues);
+	if (covariateValues.size() > 0 && covariateValues.size() != covariateIds.size()) {
+		std::ostringstream stream;
+		stream << "Mismatched covariate column dimensions";
+		error->throwError(stream);
+	}
 
-	int firstColumnIndex = getNumberOfColumns();
+	return loadMultipleX(covariateIds.data(), rowIds.data(),
+		covariateValues.size() > 0 ? covariateValues.data() : nullptr,
+		covariateIds.size(), append, forceSparse, nThreads);
+}
 
-	auto previousColumnId = *columnIdItr;
+int ModelData::loadMultipleX(
+		const int64_t* covariateIds,
+		const int64_t* rowIds,
+		const double* covariateValues,
+		const size_t length,
+		const bool append,
+		const bool forceSparse,
+		const int nThreads) {
+
+	checkInMemory();
 
-	auto index = getColumnIndexByName(previousColumnId);
+	int firstColumnIndex = getNumberOfColumns();
+	if (length == 0) {
+		return firstColumnIndex;
+	}
+
+	const auto index = getColumnIndexByName(covariateIds[0]);
 	if (index >= 0) {
 		if (!append) {
             std::ostringstream stream;
-            stream << "Variable " << previousColumnId << " already exists";
+            stream << "Variable " << covariateIds[0] << " already exists";
             error->throwError(stream);
 		}
 		firstColumnIndex = index;
-	} else {
-		--previousColumnId; // not found
 	}
 
-	const bool hasCovariateValues = covariateValues.size() > 0;
+	const bool hasCovariateValues = covariateValues != nullptr;
 	const bool useRowMap = rowIdMap.size() > 0;
 
-// 	std::function<size_t(IdType)>
-//     xform = [this](IdType id) {
-//         return rowIdMap[id];
-//     };
-
-
-	while (columnIdItr != columnIdEnd) {
-
-		if (index < 0) { // Create new column if necessary
-		    const auto format =
-		        (hasCovariateValues &&
-		            (!(*covariateValueItr == 1.0 || *covariateValueItr == 0.0) // not 0 or 1
-                    || forceSparse)) ?
-		                SPARSE : INDICATOR;
-	        push_back(format);
-	        index = getNumberOfColumns() - 1;
-	        getColumn(index).add_label(*columnIdItr);
-        }
-
-		// Append data into CompressedDataColumn
-		CompressedDataColumn& column = getColumn(index);
-		FormatType format = column.getFormatType();
-
-		// Grab whole column worth of data
-		const auto columnId = *columnIdItr;
-		auto lastRowId = *rowIdItr - 1;
-
-		while (columnIdItr != columnIdEnd && *columnIdItr == columnId) {
-		    if (*rowIdItr == lastRowId) {
+	// Pass 1: split into runs of one covariate, count entries and fix formats up front
+	struct ColumnRun {
+		size_t begin;
+		size_t end;
+		size_t entries;
+		bool upcast; // holds a value other than 0 or 1
+	};
+	std::vector<ColumnRun> runs;
+
+	for (size_t i = 0; i < length; ) {
+		ColumnRun run = { i, i, 0, false };
+		const auto columnId = covariateIds[i];
+		for (; i < length && covariateIds[i] == columnId; ++i) {
+		    if (i > run.begin && rowIds[i] == rowIds[i - 1]) {
 		        std::ostringstream stream;
 		        stream << "Repeated row-column entry at ";
-		        stream << *rowIdItr << " - " << *columnIdItr;
+		        stream << rowIds[i] << " - " << columnId;
 		        throw std::range_error(stream.str());
 		    }
-		    const auto mappedRow = (useRowMap) ? rowIdMap[*rowIdItr] : *rowIdItr;
 		    if (hasCovariateValues) {
-                if (*covariateValueItr != 0.0) {
-                    if (format == INDICATOR && *covariateValueItr != 1.0) {
-                        // Upcast
-                        column.convertColumnToSparse();
-                        format = SPARSE;
-                    }
-                    if (format == SPARSE) {
-                        column.getDataVector().push_back(*covariateValueItr);
-                    }
-                    column.getColumnsVector().push_back(mappedRow);
-                }
-		        ++covariateValueItr;
+		        const double value = covariateValues[i];
+		        if (value != 0.0) {
+		            ++run.entries;
+		            run.upcast |= (value != 1.0);
+		        }
 		    } else {
-		        column.getColumnsVector().push_back(mappedRow);
+		        ++run.entries;
 		    }
+		}
+		run.end = i;
+		runs.push_back(run);
+	}
 
-		    lastRowId = *rowIdItr;
+	// Pass 2: create (or extend) each column once, with exact capacity
+	std::vector<CompressedDataColumn*> columns(runs.size());
+	for (size_t r = 0; r < runs.size(); ++r) {
+		const ColumnRun& run = runs[r];
+		if (r == 0 && index >= 0) {
+			CompressedDataColumn& column = getColumn(index);
+			column.detachStorage(); // appending must not alter duplicate columns
+			if (column.getFormatType() == INDICATOR && run.upcast) {
+				column.convertColumnToSparse();
+			}
+			columns[r] = &column;
+		} else {
+			const auto format = (hasCovariateValues && (run.upcast || forceSparse)) ?
+				SPARSE : INDICATOR;
+			push_back(format);
+			columns[r] = &getColumn(getNumberOfColumns() - 1);
+			setColumnLabel(getNumberOfColumns() - 1, covariateIds[run.begin]);
+		}
 
-			++columnIdItr;
-			++rowIdItr;
+		CompressedDataColumn& column = *columns[r];
+		column.getColumnsVector().reserve(column.getColumnsVector().size() + run.entries);
+		if (column.getFormatType() == SPARSE) {
+			column.getDataVector().reserve(column.getDataVector().size() + run.entries);
+		}
+	}
+
+	// Pass 3: fill columns independently
+	auto fillColumn = [&](size_t r) {
+		const ColumnRun& run = runs[r];
+		CompressedDataColumn& column = *columns[r];
+		const bool isSparse = column.getFormatType() == SPARSE;
+		std::vector<int>& rows = column.getColumnsVector();
+
+		for (size_t i = run.begin; i < run.end; ++i) {
+			const double value = hasCovariateValues ? covariateValues[i] : 1.0;
+			if (value == 0.0) {
+				continue;
+			}
+			if (useRowMap) {
+				const auto it = rowIdMap.find(rowIds[i]);
+				rows.push_back(it != rowIdMap.end() ? it->second : 0);
+			} else {
+				rows.push_back(rowIds[i]);
+			}
+			if (isSparse) {
+				column.getDataVector().push_back(value);
+			}
+		}
+	};
+
+	const int threads = (nThreads == -1) ? bsccs::thread::hardware_concurrency() : nThreads;
+	if (threads > 1 && runs.size() > 1) {
+		auto scheduler = TaskScheduler<boost::counting_iterator<size_t> >(
+			boost::make_counting_iterator(static_cast<size_t>(0)),
+			boost::make_counting_iterator(runs.size()),
+			threads);
+		scheduler.execute(fillColumn);
+	} else {
+		for (size_t r = 0; r < runs.size(); ++r) {
+			fillColumn(r);
 		}
-		index = -1; // new column
 	}
 
-	touchedX = true;
+	touchX();
 	return firstColumnIndex;
 }
 
@@ -237,6 +447,8 @@ int ModelData::loadX(
 		const bool append,
 		const bool forceSparse) {
 
+    checkInMemory();
+
     const bool hasCovariateValues = covariateValue.size() > 0;
     const bool useRowMap = rowIdMap.size() > 0;
 
@@ -342,7 +554,7 @@ int ModelData::loadX(
         }
 
         index = getNumberOfColumns() - 1;
-        getColumn(index).add_label(covariateId);
+        setColumnLabel(index, covariateId);
     }
 
     if (newType == INTERCEPT) {
@@ -351,7 +563,7 @@ int ModelData::loadX(
             moveToFront(index);
         }
     }
-    touchedX = true;
+    touchX();
     return index;
 }
 
@@ -364,6 +576,8 @@ size_t ModelData::append(
         const std::vector<IdType>& cCovariateId,
         const std::vector<double>& cCovariateValue) {
 
+    checkInMemory();
+
     // Check covariate dimensions
     if ((cRowId.size() != cCovariateId.size()) ||
         (cRowId.size() != cCovariateValue.size())) {
@@ -399,63 +613,22 @@ size_t ModelData::append(
 
     for (size_t i = 0; i < nOutcomes; ++i) {
 
-    	// TODO Begin code duplication with 'loadY'
-        IdType cInStratum = oStratumId[i];
-        if (nRows == 0) {
-        	lastStratumMap.first = cInStratum;
-        	lastStratumMap.second = 0;
-        	nPatients++;
-        } else {
-        	if (cInStratum != lastStratumMap.first) {
-          	    lastStratumMap.first = cInStratum;
-            	lastStratumMap.second++;
-            	nPatients++;
-        	}
-        }
-        pid.push_back(lastStratumMap.second);
-        y.push_back(oY[i]);
-        if (hasTime) {
-            offs.push_back(oTime[i]);
-        }
-
-        IdType currentRowId = oRowId[i];
-        // TODO Check timing on adding label as string
-        std::stringstream ss;
-        ss << currentRowId;
-        labels.push_back(ss.str());
-        // TODO End code duplication with 'loadY;
+        const IdType currentRowId = oRowId[i];
+        appendRow(oStratumId[i], currentRowId, oY[i], hasTime, hasTime ? oTime[i] : 0.0);
 
 #ifdef DEBUG_64BIT
         std::cout << currentRowId << std::endl;
 #endif
         while (cOffset < nCovariates && cRowId[cOffset] == currentRowId) {
             IdType covariate = cCovariateId[cOffset];
-            real value = cCovariateValue[cOffset];
 
 			if (!sparseIndexer.hasColumn(covariate)) {
 				// Add new column
 				sparseIndexer.addColumn(covariate, INDICATOR);
 			}
 
-			CompressedDataColumn& column = sparseIndexer.getColumn(covariate);
-			if (value != static_cast<real>(1) && value != static_cast<real>(0)) {
-				if (column.getFormatType() == INDICATOR) {
-					std::ostringstream stream;
-					stream << "Up-casting covariate " << column.getLabel() << " to sparse!";
-					log->writeLine(stream);
-					column.convertColumnToSparse();
-				}
-			}
-
-			// Add to storage
-			bool valid = column.add_data(nRows, value);
-			if (!valid) {
-				std::ostringstream stream;
-				stream << "Warning: repeated sparse entries in data row: "
-						<< cRowId[cOffset]
-						<< ", column: " << column.getLabel();
-				log->writeLine(stream);
-			}
+			appendEntry(sparseIndexer.getColumn(covariate), nRows, currentRowId,
+				cCovariateValue[cOffset]);
 			++cOffset;
         }
         ++nRows;
@@ -463,9 +636,55 @@ size_t ModelData::append(
     return nOutcomes;
 }
 
-std::vector<double> ModelData::normalizeCovariates(const NormalizationType type) {
+void ModelData::appendRow(IdType stratumId, IdType rowId, double outcome, bool hasTime, double time) {
+    // TODO Begin code duplication with 'loadY'
+    if (nRows == 0) {
+        lastStratumMap.first = stratumId;
+        lastStratumMap.second = 0;
+        nPatients++;
+    } else if (stratumId != lastStratumMap.first) {
+        lastStratumMap.first = stratumId;
+        lastStratumMap.second++;
+        nPatients++;
+    }
+    pid.push_back(lastStratumMap.second);
+    y.push_back(outcome);
+    if (hasTime) {
+        offs.push_back(time);
+    }
+    labels.push_back(std::to_string(rowId));
+    // TODO End code duplication with 'loadY'
+}
+
+void ModelData::appendEntry(CompressedDataColumn& column, size_t row, IdType rowId, real value) {
+    if (value != static_cast<real>(1) && value != static_cast<real>(0)) {
+        if (column.getFormatType() == INDICATOR) {
+            std::ostringstream stream;
+            stream << "Up-casting covariate " << column.getLabel() << " to sparse!";
+            log->writeLine(stream);
+            column.convertColumnToSparse();
+        }
+    }
+
+    // Add to storage
+    if (!column.add_data(static_cast<int>(row), value)) {
+        std::ostringstream stream;
+        stream << "Warning: repeated sparse entries in data row: " << rowId
+               << ", column: " << column.getLabel();
+        log->writeLine(stream);
+    }
+}
+
+std::vector<double> ModelData::normalizeCovariates(const NormalizationType type, int nThreads) {
+    checkInMemory();
+
+    const bool withQuantiles = type == NormalizationType::MEDIAN || type == NormalizationType::Q95;
+    const ColumnStatisticsPtr statisticsList = getColumnStatistics(withQuantiles, nThreads);
+    const std::vector<ColumnStatistics>& statistics = *statisticsList;
+
     std::vector<double> normalizations;
     normalizations.reserve(getNumberOfColumns());
+    std::vector<size_t> scaledColumns;
 
     size_t index = hasOffsetCovariate ? 1 : 0;
     if (hasInterceptCovariate) {
@@ -474,59 +693,47 @@ std::vector<double> ModelData::normalizeCovariates(const NormalizationType type)
     }
 
     for ( ; index < getNumberOfColumns(); ++index) {
-        CompressedDataColumn& column = getColumn(index);
-        FormatType format = column.getFormatType();
+        FormatType format = getColumn(index).getFormatType();
         if (format == DENSE || format == SPARSE) {
 
             double scale = 1.0;
             if (type == NormalizationType::STANDARD_DEVIATION) {
-                auto sumOp = [](double x, double y) {
-                    return x + y;
-                };
-
-                auto squaredSumOp = [](double x, double y) {
-                    return x + y * y;
-                };
-
-                auto mean = column.accumulate(sumOp, 0.0) / nRows;
-                auto newSS = column.accumulate(squaredSumOp, 0.0);
-                auto variance = (newSS - (mean * mean * nRows)) / nRows;
+                auto mean = statistics[index].sum / nRows;
+                auto variance = (statistics[index].squaredSum - (mean * mean * nRows)) / nRows;
                 scale = 1.0 / std::sqrt(variance);
 
             } else if (type == NormalizationType::MAX) {
-                auto maxOp = [](double max, double x) {
-                    auto abs = std::abs(x);
-                    if (abs > max) {
-                        max = abs;
-                    }
-                    return max;
-                };
-                scale = 1.0 / column.accumulate(maxOp, 0.0);
+                scale = 1.0 / statistics[index].maxAbs;
 
             } else if ( type == NormalizationType::MEDIAN) {
-                auto data = column.copyData();
-                std::transform(data.begin(), data.end(), data.begin(), [](double x) {
-                    return std::abs(x);
-                }); // TODO Copy and transform in single loop
-                scale = 1.0 / median(data.begin(), data.end());
+                scale = 1.0 / statistics[index].medianAbs;
+
             } else {  // type == NormalizationType::Q95
-                auto data = column.copyData();
-                std::transform(data.begin(), data.end(), data.begin(), [](double x) {
-                    return std::abs(x);
-                }); // TODO Copy and transform in single loop
-                scale = 1.0 / quantile(data.begin(), data.end(), 0.95);
+                scale = 1.0 / statistics[index].quantile95Abs;
             }
 
-            auto scaleOp = [scale](double x) {
-                return x * scale;
-            };
-
-            column.transform(scaleOp);
             normalizations.push_back(scale);
+            scaledColumns.push_back(index);
         } else {
             normalizations.push_back(1.0);
         }
     }
+
+    // Columns transform independently; normalizations[] is offset by any offset covariate
+    const size_t offset = hasOffsetCovariate ? 1 : 0;
+    TaskScheduler<boost::counting_iterator<size_t>>(
+        boost::make_counting_iterator(static_cast<size_t>(0)),
+        boost::make_counting_iterator(scaledColumns.size()),
+        std::max(nThreads, 1)
+    ).execute([this, &scaledColumns, &normalizations, offset](const size_t i) {
+        const size_t index = scaledColumns[i];
+        const double scale = normalizations[index - offset];
+        getColumn(index).transform([scale](double x) {
+            return x * scale;
+        });
+    });
+
+    touchX();
     return normalizations;
 }
 
@@ -597,13 +804,15 @@ double ModelData::getSquaredNorm() const {
 	if (hasInterceptCovariate) ++startIndex;
 	if (hasOffsetCovariate) ++startIndex;
 
-	std::vector<double> squaredNorm;
+	const ColumnStatisticsPtr statisticsList = getColumnStatistics();
+	const std::vector<ColumnStatistics>& statistics = *statisticsList;
 
+	double squaredNorm = 0.0;
 	for (size_t index = startIndex; index < getNumberOfColumns(); ++index) {
-		squaredNorm.push_back(getColumn(index).squaredSumColumn(getNumberOfRows()));
+		squaredNorm += statistics[index].squaredSum;
 	}
 
-	return std::accumulate(squaredNorm.begin(), squaredNorm.end(), 0.0);
+	return squaredNorm;
 }
 
 size_t ModelData::getNumberOfStrata() const {
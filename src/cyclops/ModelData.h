@@ -23,6 +23,7 @@
 // using std::stringstream;
 
 #include "CompressedDataMatrix.h"
+#include "Thread.h"
 #include "io/ProgressLogger.h"
 #include "io/SparseIndexer.h"
 
@@ -72,6 +73,7 @@ public:
 		, sparseIndexer(*this)
 		, log(_log), error(_error)
 		, touchedY(true), touchedX(true)
+		, columnQuantilesValid(false), columnStatisticsRows(0)
 		{
 
 	}
@@ -113,7 +115,22 @@ public:
 		const bool checkCovariateIds,
 		const bool checkCovariateBounds,
 		const bool append,
-		const bool forceSparse
+		const bool forceSparse,
+		const int nThreads = 1
+	);
+
+	/**
+	 * Bulk load from contiguous (covariateId, rowId, value) arrays sorted by covariate;
+	 * covariateValues may be null for indicator data
+	 */
+	int loadMultipleX(
+		const int64_t* covariateIds,
+		const int64_t* rowIds,
+		const double* covariateValues,
+		const size_t length,
+		const bool append,
+		const bool forceSparse,
+		const int nThreads = 1
 	);
 
 	const int* getPidVector() const;
@@ -188,6 +205,25 @@ public:
 
 	void sortDataColumns(std::vector<int> sortedInds);
 
+	struct ColumnStatistics {
+		double sum;
+		double squaredSum;
+		double maxAbs;
+		double medianAbs;     // NaN until requested with quantiles
+		double quantile95Abs; // NaN until requested with quantiles
+	};
+
+	typedef bsccs::shared_ptr<const std::vector<ColumnStatistics>> ColumnStatisticsPtr;
+
+	/**
+	 * Statistics over the stored entries of each column, computed in parallel across
+	 * columns and cached until the next touchX().  Quantiles of |x| need a selection per
+	 * column, so are only filled in on request.  The returned statistics stay valid for
+	 * as long as the pointer is held, even across a touchX().
+	 */
+	ColumnStatisticsPtr getColumnStatistics(bool withQuantiles = false,
+		int nThreads = 1) const;
+
 	double getSquaredNorm() const;
 
 	double getNormalBasedDefaultVar() const;
@@ -204,7 +240,7 @@ public:
 
     void moveTimeToCovariate(bool takeLog);
 
-    std::vector<double> normalizeCovariates(const NormalizationType type);
+    std::vector<double> normalizeCovariates(const NormalizationType type, int nThreads = 1);
 
 	const std::string& getRowLabel(size_t i) const {
 		if (i >= labels.size()) {
@@ -220,6 +256,30 @@ public:
 
 	const bool getTouchedX() const { return touchedX; }
 
+	/**
+	 * Must be called after covariates are modified outside of ModelData
+	 */
+	void touchX();
+
+	typedef bsccs::shared_ptr<const CompressedRowMatrix> CompressedRowMatrixPtr;
+
+	/**
+	 * Lazily built row-major mirror of X, cached until the next touchX().  The mirror
+	 * stays valid for as long as the pointer is held, even across a touchX().
+	 */
+	CompressedRowMatrixPtr getRowMajorMatrix() const;
+
+	/**
+	 * Bytes the row-major mirror will take once built; zero when it is already built
+	 * (and so counted by getMemoryFootprint()) or when X is paged from disk
+	 */
+	uint64_t getPendingRowMajorBytes() const;
+
+	// Column storage plus outcomes, strata, row labels and any row-major mirror
+	MemoryFootprint getMemoryFootprint() const;
+
+	void getDataRow(int row, real* x) const;
+
 	// TODO Improve encapsulation
 	friend class SCCSInputReader;
 	friend class CLRInputReader;
@@ -227,6 +287,10 @@ public:
 	friend class CoxInputReader;
 	friend class CCTestInputReader;
 	friend class GenericSparseReader;
+	friend class BinaryModelData;
+	friend class ArrowImport;
+	friend class IngestionSession;
+	friend class SyntheticDataGenerator;
 
 	template <class FormatType, class MissingPolicy> friend class BaseInputReader;
 	template <class ImputationPolicy> friend class BBRInputReader;
@@ -257,6 +321,14 @@ private:
 	ModelData(const ModelData&);
 	ModelData& operator = (const ModelData&);
 
+	void checkInMemory() const;
+
+	// Appends one outcome row, numbering strata in order of appearance; shared with IngestionSession
+	void appendRow(IdType stratumId, IdType rowId, double outcome, bool hasTime, double time);
+
+	// Adds one covariate entry at row, up-casting an indicator column for values other than 0 / 1
+	void appendEntry(CompressedDataColumn& column, size_t row, IdType rowId, real value);
+
 	static const std::string missing;
 
     std::pair<IdType,int> lastStratumMap;
@@ -273,6 +345,14 @@ protected:
 
     mutable bool touchedY;
     mutable bool touchedX;
+
+    mutable CompressedRowMatrixPtr rowMajor;
+    mutable bsccs::mutex rowMajorLock;
+
+    mutable ColumnStatisticsPtr columnStatistics;
+    mutable bool columnQuantilesValid;
+    mutable size_t columnStatisticsRows;
+    mutable bsccs::mutex columnStatisticsLock;
 };
 
 
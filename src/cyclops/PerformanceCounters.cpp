@@ -0,0 +1,156 @@
+/*
+ * PerformanceCounters.cpp
+ */
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include "PerformanceCounters.h"
+#include "CompressedDataMatrix.h"
+#include "Thread.h"
+
+namespace bsccs {
+
+namespace performance {
+
+namespace {
+
+// Written only by the owning thread, so updates are a plain load and store; atomic so
+// that snapshot() and reset() may read and clear them from another thread
+struct Counter {
+	std::atomic<uint64_t> calls;
+	std::atomic<uint64_t> nanoseconds;
+
+	Counter() : calls(0), nanoseconds(0) { }
+};
+
+struct ThreadCounters {
+	bool inUse;
+	Counter counters[KERNEL_COUNT][FORMAT_COUNT];
+};
+
+// Tables are never freed; one released by an exiting thread is handed to the next new
+// thread, so counts of finished cross-validation threads are kept
+bsccs::mutex registryLock;
+std::vector<std::unique_ptr<ThreadCounters>> tables;
+
+ThreadCounters* acquire() {
+	std::lock_guard<bsccs::mutex> lock(registryLock);
+	for (auto& table : tables) {
+		if (!table->inUse) {
+			table->inUse = true;
+			return table.get();
+		}
+	}
+	tables.emplace_back(new ThreadCounters());
+	tables.back()->inUse = true;
+	return tables.back().get();
+}
+
+struct LocalCounters {
+	ThreadCounters* table;
+
+	LocalCounters() : table(nullptr) { }
+
+	~LocalCounters() {
+		if (table != nullptr) {
+			std::lock_guard<bsccs::mutex> lock(registryLock);
+			table->inUse = false;
+		}
+	}
+
+	Counter& get(Kernel kernel, int format) {
+		if (table == nullptr) {
+			table = acquire();
+		}
+		return table->counters[kernel][format];
+	}
+};
+
+thread_local LocalCounters local;
+
+inline void add(std::atomic<uint64_t>& value, uint64_t increment) {
+	value.store(value.load(std::memory_order_relaxed) + increment, std::memory_order_relaxed);
+}
+
+} // namespace
+
+void record(Kernel kernel, int format, uint64_t nanoseconds, uint64_t calls) {
+	Counter& counter = local.get(kernel, format);
+	add(counter.calls, calls);
+	add(counter.nanoseconds, nanoseconds);
+}
+
+std::vector<CounterRecord> snapshot() {
+	uint64_t calls[KERNEL_COUNT][FORMAT_COUNT] = {};
+	uint64_t nanoseconds[KERNEL_COUNT][FORMAT_COUNT] = {};
+	{
+		std::lock_guard<bsccs::mutex> lock(registryLock);
+		for (const auto& table : tables) {
+			for (int kernel = 0; kernel < KERNEL_COUNT; ++kernel) {
+				for (int format = 0; format < FORMAT_COUNT; ++format) {
+					const Counter& counter = table->counters[kernel][format];
+					calls[kernel][format] += counter.calls.load(std::memory_order_relaxed);
+					nanoseconds[kernel][format] += counter.nanoseconds.load(std::memory_order_relaxed);
+				}
+			}
+		}
+	}
+
+	std::vector<CounterRecord> records;
+	for (int kernel = 0; kernel < KERNEL_COUNT; ++kernel) {
+		for (int format = 0; format < FORMAT_COUNT; ++format) {
+			if (calls[kernel][format] > 0) {
+				CounterRecord record = {
+					kernelName(static_cast<Kernel>(kernel)),
+					formatName(format),
+					calls[kernel][format],
+					nanoseconds[kernel][format]
+				};
+				records.push_back(record);
+			}
+		}
+	}
+	return records;
+}
+
+void reset() {
+	std::lock_guard<bsccs::mutex> lock(registryLock);
+	for (auto& table : tables) {
+		for (auto& kernel : table->counters) {
+			for (auto& counter : kernel) {
+				counter.calls.store(0, std::memory_order_relaxed);
+				counter.nanoseconds.store(0, std::memory_order_relaxed);
+			}
+		}
+	}
+}
+
+const char* kernelName(Kernel kernel) {
+	switch (kernel) {
+		case COMPUTE_GRADIENT_HESSIAN : return "compGradHess";
+		case COMPUTE_NUMERATOR_FOR_GRADIENT : return "compNumGrad";
+		case UPDATE_XBETA : return "updateXBeta";
+		case SWEEP : return "sweep";
+		case COMPUTE_REMAINING_STATISTICS : return "compRS";
+		case COMPUTE_LOG_LIKELIHOOD : return "compLogLike";
+		case CROSS_VALIDATION_FOLD : return "cvFold";
+		case KKT_PASS : return "kktPass";
+		default : return "unknown";
+	}
+}
+
+const char* formatName(int format) {
+	switch (format) {
+		case DENSE : return "dense";
+		case SPARSE : return "sparse";
+		case INDICATOR : return "indicator";
+		case INTERCEPT : return "intercept";
+		default : return "all";
+	}
+}
+
+} // namespace performance
+
+} // namespace bsccs
@@ -0,0 +1,82 @@
+/*
+ * PerformanceCounters.h
+ *
+ * Process-wide call counts and elapsed times of the main fitting kernels, split by
+ * column format where the kernel dispatches on it.  Each thread adds into a table it
+ * owns, without locked instructions or shared cache lines, and snapshot() sums the
+ * tables, so the counters stay on in release builds.  reset() should be called while no
+ * counted work is running.
+ */
+
+#ifndef PERFORMANCECOUNTERS_H_
+#define PERFORMANCECOUNTERS_H_
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "Timing.h"
+
+namespace bsccs {
+
+namespace performance {
+
+enum Kernel {
+	COMPUTE_GRADIENT_HESSIAN,
+	COMPUTE_NUMERATOR_FOR_GRADIENT,
+	UPDATE_XBETA,
+	SWEEP,
+	COMPUTE_REMAINING_STATISTICS,
+	COMPUTE_LOG_LIKELIHOOD,
+	CROSS_VALIDATION_FOLD,
+	KKT_PASS,
+	KERNEL_COUNT
+};
+
+// Formats are indexed by FormatType; kernels that do not dispatch on one use ANY_FORMAT
+const int ANY_FORMAT = 4;
+const int FORMAT_COUNT = 5;
+
+struct CounterRecord {
+	std::string kernel;
+	std::string format;
+	uint64_t calls;
+	uint64_t nanoseconds;
+};
+
+void record(Kernel kernel, int format, uint64_t nanoseconds, uint64_t calls = 1);
+
+// Counters with at least one call, in kernel then format order
+std::vector<CounterRecord> snapshot();
+
+void reset();
+
+const char* kernelName(Kernel kernel);
+
+const char* formatName(int format);
+
+class ScopedCounter {
+public:
+	ScopedCounter(Kernel kernel, int format = ANY_FORMAT, uint64_t calls = 1)
+		: kernel(kernel), format(format), calls(calls), start(chrono::steady_clock::now()) { }
+
+	~ScopedCounter() {
+		record(kernel, format, chrono::duration_cast<chrono::TimingUnits>(
+			chrono::steady_clock::now() - start).count(), calls);
+	}
+
+private:
+	ScopedCounter(const ScopedCounter&);
+	ScopedCounter& operator = (const ScopedCounter&);
+
+	const Kernel kernel;
+	const int format;
+	const uint64_t calls;
+	const chrono::steady_clock::time_point start;
+};
+
+} // namespace performance
+
+} // namespace bsccs
+
+#endif /* PERFORMANCECOUNTERS_H_ */
@@ -0,0 +1,228 @@
+/*
+ * Scoring.cpp
+ */
+
+#include <algorithm>
+
+#include "Scoring.h"
+#include "Thread.h"
+#include "engine/AbstractModelSpecifics.h"
+
+namespace bsccs {
+
+namespace {
+
+const size_t minimumSliceLength = 1 << 16;
+
+size_t numberOfSlices(size_t length, int nThreads) {
+	return std::max(static_cast<size_t>(1),
+		std::min(static_cast<size_t>(std::max(nThreads, 1)), length / minimumSliceLength));
+}
+
+} // namespace
+
+Scorer::Scorer(const std::vector<IdType>& coefficientIds, const std::vector<double>& coefficients,
+		ModelType modelType, int nThreads)
+	: modelType(modelType), nThreads(std::max(nThreads, 1)), consecutiveRows(true), firstRow(0) {
+
+	const size_t length = std::min(coefficientIds.size(), coefficients.size());
+	beta.reserve(length);
+	for (size_t j = 0; j < length; ++j) {
+		if (coefficients[j] != 0.0) {
+			beta[coefficientIds[j]] = coefficients[j];
+		}
+	}
+}
+
+void Scorer::setRows(const std::vector<IdType>& rowIds) {
+
+	rowIndex.clear();
+	firstRow = rowIds.empty() ? 0 : rowIds[0];
+	consecutiveRows = true;
+	for (size_t i = 1; i < rowIds.size() && consecutiveRows; ++i) {
+		consecutiveRows = rowIds[i] == firstRow + static_cast<IdType>(i);
+	}
+	if (!consecutiveRows) {
+		rowIndex.reserve(rowIds.size());
+		for (size_t i = 0; i < rowIds.size(); ++i) {
+			rowIndex.emplace(rowIds[i], i);
+		}
+	}
+	linearPredictor.assign(rowIds.size(), 0.0);
+}
+
+void Scorer::addSlice(const IdType* rowIds, const IdType* covariateIds, const double* values,
+		size_t begin, size_t end, std::vector<std::vector<Contribution>>* partitions) {
+
+	const size_t nRows = linearPredictor.size();
+	const size_t nPartitions = partitions ? partitions->size() : 1;
+
+	// Triplets usually arrive sorted by row or by covariate; runs reuse the last lookup
+	IdType lastRowId = 0;
+	bool haveRow = false;
+	bool rowFound = false;
+	size_t row = 0;
+
+	IdType lastCovariateId = 0;
+	bool haveCovariate = false;
+	double coefficient = 0.0;
+
+	for (size_t k = begin; k < end; ++k) {
+		if (!haveCovariate || covariateIds[k] != lastCovariateId) {
+			auto found = beta.find(covariateIds[k]);
+			coefficient = (found != beta.end()) ? found->second : 0.0;
+			lastCovariateId = covariateIds[k];
+			haveCovariate = true;
+		}
+		if (coefficient == 0.0) {
+			continue;
+		}
+
+		if (!haveRow || rowIds[k] != lastRowId) {
+			if (consecutiveRows) {
+				const IdType offset = rowIds[k] - firstRow;
+				rowFound = offset >= 0 && static_cast<size_t>(offset) < nRows;
+				row = static_cast<size_t>(offset);
+			} else {
+				auto found = rowIndex.find(rowIds[k]);
+				rowFound = found != rowIndex.end();
+				row = rowFound ? found->second : 0;
+			}
+			lastRowId = rowIds[k];
+			haveRow = true;
+		}
+		if (!rowFound) {
+			continue;
+		}
+
+		const double value = coefficient * (values ? values[k] : 1.0);
+		if (partitions) {
+			(*partitions)[row * nPartitions / nRows].push_back({ row, value });
+		} else {
+			linearPredictor[row] += value;
+		}
+	}
+}
+
+void Scorer::addCovariates(const IdType* rowIds, const IdType* covariateIds, const double* values,
+		size_t length) {
+
+	const size_t nRows = linearPredictor.size();
+	if (nRows == 0 || beta.empty()) {
+		return;
+	}
+
+	const size_t nSlices = numberOfSlices(length, nThreads);
+	if (nSlices == 1) {
+		addSlice(rowIds, covariateIds, values, 0, length, nullptr);
+		return;
+	}
+
+	// Each slice of triplets routes its terms to the row partition they land in; each
+	// partition then adds its terms slice by slice, so every row sums in triplet order
+	std::vector<std::vector<std::vector<Contribution>>> routed(nSlices,
+		std::vector<std::vector<Contribution>>(nSlices));
+
+	forEachTask(nSlices, nThreads, [&](const size_t s) {
+		addSlice(rowIds, covariateIds, values,
+			length * s / nSlices, length * (s + 1) / nSlices, &routed[s]);
+	});
+
+	forEachTask(nSlices, nThreads, [&](const size_t p) {
+		for (size_t s = 0; s < nSlices; ++s) {
+			for (const Contribution& term : routed[s][p]) {
+				linearPredictor[term.row] += term.value;
+			}
+		}
+	});
+}
+
+std::vector<double> Scorer::getLinearPredictor(const ModelData& modelData) const {
+
+	const size_t nRows = modelData.getNumberOfRows();
+	std::vector<double> xBeta(nRows, 0.0);
+
+	std::vector<std::pair<size_t, double>> columns;
+	for (size_t j = 0; j < modelData.getNumberOfColumns(); ++j) {
+		if (j == 0 && modelData.getHasOffsetCovariate()) {
+			columns.push_back(std::make_pair(j, 1.0));
+		} else {
+			auto found = beta.find(modelData.getColumn(j).getNumericalLabel());
+			if (found != beta.end()) {
+				columns.push_back(std::make_pair(j, found->second));
+			}
+		}
+	}
+
+	// Threads own contiguous row ranges and visit columns in order; entries within a
+	// column are sorted by row, so each thread starts at its range by bisection
+	const size_t nPartitions = modelData.isOutOfCore() ? 1 : numberOfSlices(nRows, nThreads);
+
+	forEachTask(nPartitions, nThreads, [&](const size_t p) {
+		const int begin = static_cast<int>(nRows * p / nPartitions);
+		const int end = static_cast<int>(nRows * (p + 1) / nPartitions);
+
+		for (const auto& column : columns) {
+			const PinnedColumn pinned(modelData, column.first);
+			const CompressedDataColumn& x = modelData.getColumn(column.first);
+			const double coefficient = column.second;
+
+			switch (x.getFormatType()) {
+				case INDICATOR : {
+					const std::vector<int>& rows = x.getColumnsVector();
+					for (auto it = std::lower_bound(rows.begin(), rows.end(), begin);
+							it != rows.end() && *it < end; ++it) {
+						xBeta[*it] += coefficient;
+					}
+					break;
+				}
+				case SPARSE : {
+					const std::vector<int>& rows = x.getColumnsVector();
+					const std::vector<real>& data = x.getDataVector();
+					for (size_t k = std::lower_bound(rows.begin(), rows.end(), begin) - rows.begin();
+							k < rows.size() && rows[k] < end; ++k) {
+						xBeta[rows[k]] += coefficient * data[k];
+					}
+					break;
+				}
+				case DENSE : {
+					const std::vector<real>& data = x.getDataVector();
+					for (int row = begin; row < end; ++row) {
+						xBeta[row] += coefficient * data[row];
+					}
+					break;
+				}
+				case INTERCEPT : {
+					for (int row = begin; row < end; ++row) {
+						xBeta[row] += coefficient;
+					}
+					break;
+				}
+			}
+		}
+	});
+
+	return xBeta;
+}
+
+std::vector<double> Scorer::predict(const std::vector<double>& xBeta, double intercept) const {
+
+	const size_t length = xBeta.size();
+	std::vector<double> shifted(xBeta);
+	std::vector<double> result(length);
+	const size_t nSlices = numberOfSlices(length, nThreads);
+
+	forEachTask(nSlices, nThreads, [&](const size_t s) {
+		const size_t begin = length * s / nSlices;
+		const size_t end = length * (s + 1) / nSlices;
+		for (size_t i = begin; i < end; ++i) {
+			shifted[i] += intercept;
+		}
+		AbstractModelSpecifics::predictEstimates(modelType, shifted.data() + begin,
+			result.data() + begin, end - begin);
+	});
+
+	return result;
+}
+
+} // namespace
@@ -0,0 +1,75 @@
+/*
+ * Scoring.h
+ *
+ * Native scoring of new data with fitted coefficients.  Linear predictors come from
+ * covariate triplets, fed chunk by chunk, or from the columns of a ModelData, and are
+ * mapped to the response scale by the model's predictEstimate().  Nothing calls back
+ * into R and no intermediate tables are built.
+ */
+
+#ifndef SCORING_H_
+#define SCORING_H_
+
+#include <unordered_map>
+#include <vector>
+
+#include "ModelData.h"
+
+namespace bsccs {
+
+class Scorer {
+public:
+
+	/**
+	 * Coefficients are looked up by covariate ID through a hash table; zero coefficients
+	 * are dropped.  Work on triplets is split over row partitions and threads.
+	 */
+	Scorer(const std::vector<IdType>& coefficientIds, const std::vector<double>& coefficients,
+		ModelType modelType, int nThreads = 1);
+
+	// Rows to score, in output order; must be unique.  Resets the linear predictors.
+	void setRows(const std::vector<IdType>& rowIds);
+
+	// Entries for other rows or for covariates without a coefficient are skipped;
+	// null values mark indicator covariates
+	void addCovariates(const IdType* rowIds, const IdType* covariateIds, const double* values,
+		size_t length);
+
+	const std::vector<double>& getLinearPredictor() const { return linearPredictor; }
+
+	// Linear predictor of every ModelData row; an offset column enters with coefficient 1
+	std::vector<double> getLinearPredictor(const ModelData& modelData) const;
+
+	// Response-scale values of xBeta + intercept
+	std::vector<double> predict(const std::vector<double>& xBeta, double intercept = 0.0) const;
+
+	std::vector<double> predict(double intercept = 0.0) const {
+		return predict(linearPredictor, intercept);
+	}
+
+private:
+
+	struct Contribution {
+		size_t row;
+		double value;
+	};
+
+	void addSlice(const IdType* rowIds, const IdType* covariateIds, const double* values,
+		size_t begin, size_t end, std::vector<std::vector<Contribution>>* partitions);
+
+	const ModelType modelType;
+	const int nThreads;
+
+	std::unordered_map<IdType, double> beta;
+
+	// Row ID -> output position: an offset while IDs are consecutive, else a hash table
+	bool consecutiveRows;
+	IdType firstRow;
+	std::unordered_map<IdType, size_t> rowIndex;
+
+	std::vector<double> linearPredictor;
+};
+
+} // namespace
+
+#endif /* SCORING_H_ */
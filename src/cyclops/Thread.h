@@ -4,8 +4,11 @@
 #include <algorithm>
 #include <thread>
 #include <mutex>
+#include <condition_variable>
 #include "tinythread/tinythread.h"
 
+#include <boost/iterator/counting_iterator.hpp>
+
 #if defined(_WIN32) || defined(__WIN32__) || defined(__WINDOWS__) || defined(WIN_BUILD)
     #define USE_TTHREAD
 #else
@@ -16,9 +19,11 @@ namespace bsccs {
 #ifdef USE_TTHREAD
     using tthread::mutex;
     using tthread::thread;
+    typedef tthread::condition_variable condition_variable;
 #else
     using std::mutex;
     using std::thread;
+    typedef std::condition_variable_any condition_variable; // waits directly on a bsccs::mutex
 #endif
 
 namespace threading {
@@ -141,6 +146,22 @@ private:
 	const size_t chunkSize;
 };
 
+// Calls function(i) for i in [0, nTasks), in contiguous blocks over nThreads threads
+template <typename Function>
+void forEachTask(size_t nTasks, int nThreads, Function function) {
+	if (nThreads <= 1 || nTasks <= 1) {
+		for (size_t i = 0; i < nTasks; ++i) {
+			function(i);
+		}
+	} else {
+		TaskScheduler<boost::counting_iterator<size_t>>(
+			boost::make_counting_iterator(static_cast<size_t>(0)),
+			boost::make_counting_iterator(nTasks),
+			nThreads
+		).execute(function);
+	}
+}
+
 } // namespace bsccs
 
 #endif // THREAD_TYPES_H_
@@ -0,0 +1,167 @@
+/*
+ * Trace.cpp
+ */
+
+#include <memory>
+#include <vector>
+
+#include "Trace.h"
+#include "Types.h"
+#include "Thread.h"
+#include "Timing.h"
+#include "io/BufferedWriter.h"
+
+namespace bsccs {
+
+namespace trace {
+
+namespace detail {
+
+std::atomic<bool> recording(false);
+
+} // namespace detail
+
+namespace {
+
+struct Event {
+	const char* name;
+	const char* category;
+	const char* argumentName;
+	int64_t argument;
+	int64_t begin;
+	int64_t end;
+};
+
+struct ThreadBuffer {
+	int id;
+	bool inUse;
+	std::vector<Event> events;
+};
+
+// Buffers are never freed; one released by an exiting thread is handed to the next new
+// thread, so worker threads of successive parallel loops share trace rows
+bsccs::mutex registryLock;
+std::vector<std::unique_ptr<ThreadBuffer>> buffers;
+
+chrono::steady_clock::time_point origin = chrono::steady_clock::now();
+
+ThreadBuffer* acquire() {
+	std::lock_guard<bsccs::mutex> lock(registryLock);
+	for (auto& buffer : buffers) {
+		if (!buffer->inUse) {
+			buffer->inUse = true;
+			return buffer.get();
+		}
+	}
+	buffers.emplace_back(new ThreadBuffer());
+	buffers.back()->id = static_cast<int>(buffers.size());
+	buffers.back()->inUse = true;
+	return buffers.back().get();
+}
+
+struct LocalBuffer {
+	ThreadBuffer* buffer;
+
+	LocalBuffer() : buffer(nullptr) { }
+
+	~LocalBuffer() {
+		if (buffer != nullptr) {
+			std::lock_guard<bsccs::mutex> lock(registryLock);
+			buffer->inUse = false;
+		}
+	}
+
+	std::vector<Event>& events() {
+		if (buffer == nullptr) {
+			buffer = acquire();
+		}
+		return buffer->events;
+	}
+};
+
+thread_local LocalBuffer local;
+
+// Microseconds with three decimals, exactly
+void writeMicroseconds(BufferedWriter& out, int64_t nanoseconds) {
+	if (nanoseconds < 0) {
+		out.write('-');
+		nanoseconds = -nanoseconds;
+	}
+	out.write(nanoseconds / 1000).write('.');
+	const int64_t fraction = nanoseconds % 1000;
+	out.write(static_cast<char>('0' + fraction / 100))
+		.write(static_cast<char>('0' + fraction / 10 % 10))
+		.write(static_cast<char>('0' + fraction % 10));
+}
+
+} // namespace
+
+namespace detail {
+
+int64_t now() {
+	return chrono::duration_cast<chrono::TimingUnits>(chrono::steady_clock::now() - origin).count();
+}
+
+void record(const char* name, const char* category, const char* argumentName,
+		int64_t argument, int64_t begin, int64_t end) {
+	Event event = { name, category, argumentName, argument, begin, end };
+	local.events().push_back(event);
+}
+
+} // namespace detail
+
+void start() {
+	std::lock_guard<bsccs::mutex> lock(registryLock);
+	for (auto& buffer : buffers) {
+		buffer->events.clear();
+	}
+	origin = chrono::steady_clock::now();
+	detail::recording.store(true, std::memory_order_relaxed);
+}
+
+void stop() {
+	detail::recording.store(false, std::memory_order_relaxed);
+}
+
+bool write(const std::string& fileName) {
+	BufferedWriter out;
+	if (!out.open(fileName)) {
+		return false;
+	}
+
+	std::lock_guard<bsccs::mutex> lock(registryLock);
+	out.write("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[");
+	bool first = true;
+	for (const auto& buffer : buffers) {
+		for (const Event& event : buffer->events) {
+			out.write(first ? "\n" : ",\n");
+			first = false;
+			out.write("{\"name\":\"").write(event.name)
+				.write("\",\"cat\":\"").write(event.category)
+				.write("\",\"ph\":\"X\",\"pid\":1,\"tid\":").write(buffer->id)
+				.write(",\"ts\":");
+			writeMicroseconds(out, event.begin);
+			out.write(",\"dur\":");
+			writeMicroseconds(out, event.end - event.begin);
+			if (event.argumentName != nullptr) {
+				out.write(",\"args\":{\"").write(event.argumentName).write("\":")
+					.write(event.argument).write('}');
+			}
+			out.write('}');
+		}
+	}
+	out.write("\n]}\n");
+	out.close();
+	return true;
+}
+
+void clear() {
+	std::lock_guard<bsccs::mutex> lock(registryLock);
+	for (auto& buffer : buffers) {
+		std::vector<Event>().swap(buffer->events);
+	}
+}
+
+} // namespace trace
+
+} // namespace bsccs
@@ -0,0 +1,77 @@
+/*
+ * Trace.h
+ *
+ * Optional timeline of spans (mode-finding sweeps, cross-validation tasks, KKT passes,
+ * profile evaluations, and data reading in ccd) written as Chrome trace-event JSON, for
+ * viewing in Perfetto or about:tracing.  Each thread appends to a buffer it owns, so
+ * recording a span takes no lock.  start(), write() and clear() must be called while no
+ * traced work is running.
+ */
+
+#ifndef TRACE_H_
+#define TRACE_H_
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+namespace bsccs {
+
+namespace trace {
+
+namespace detail {
+
+extern std::atomic<bool> recording;
+
+int64_t now(); // nanoseconds since start()
+
+void record(const char* name, const char* category, const char* argumentName,
+	int64_t argument, int64_t begin, int64_t end);
+
+} // namespace detail
+
+// Discards earlier spans, resets the time origin and turns recording on
+void start();
+
+void stop();
+
+inline bool isRecording() {
+	return detail::recording.load(std::memory_order_relaxed);
+}
+
+// Writes all recorded spans; returns false if the file cannot be opened
+bool write(const std::string& fileName);
+
+// Discards recorded spans and releases their memory
+void clear();
+
+class Span {
+public:
+	Span(const char* name, const char* category, const char* argumentName = nullptr,
+			int64_t argument = 0)
+		: name(name), category(category), argumentName(argumentName), argument(argument),
+		  active(isRecording()), begin(active ? detail::now() : 0) { }
+
+	~Span() {
+		if (active) {
+			detail::record(name, category, argumentName, argument, begin, detail::now());
+		}
+	}
+
+private:
+	Span(const Span&);
+	Span& operator = (const Span&);
+
+	const char* name;
+	const char* category;
+	const char* argumentName;
+	const int64_t argument;
+	const bool active;
+	const int64_t begin;
+};
+
+} // namespace trace
+
+} // namespace bsccs
+
+#endif /* TRACE_H_ */
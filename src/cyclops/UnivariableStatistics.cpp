@@ -0,0 +1,285 @@
+/*
+ * UnivariableStatistics.cpp
+ *
+ * In grouped models the score at beta = 0 is linear in x apart from the squared
+ * risk-set sums S1_G = sum_{j in R(G)} w_j x_j.  S1_G only changes at groups holding a
+ * non-zero entry, so prefix sums of events_G / S0_G^2 over the groups reduce that term
+ * to one step per entry as well.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include "UnivariableStatistics.h"
+#include "Thread.h"
+
+namespace bsccs {
+
+namespace {
+
+template <typename Function>
+void forEachEntry(const CompressedDataColumn& column, const size_t nRows, Function function) {
+	switch (column.getFormatType()) {
+		case INDICATOR : {
+			const std::vector<int>& rows = column.getColumnsVector();
+			for (int row : rows) {
+				function(row, 1.0);
+			}
+			break;
+		}
+		case SPARSE : {
+			const std::vector<int>& rows = column.getColumnsVector();
+			const std::vector<real>& values = column.getDataVector();
+			for (size_t k = 0; k < rows.size(); ++k) {
+				function(rows[k], values[k]);
+			}
+			break;
+		}
+		case DENSE : {
+			const std::vector<real>& values = column.getDataVector();
+			for (size_t row = 0; row < nRows; ++row) {
+				function(row, values[row]);
+			}
+			break;
+		}
+		case INTERCEPT : {
+			for (size_t row = 0; row < nRows; ++row) {
+				function(row, 1.0);
+			}
+			break;
+		}
+	}
+}
+
+inline double ratio(const double numerator, const double denominator) {
+	return denominator > 0.0 ? numerator / denominator : 0.0;
+}
+
+} // namespace
+
+UnivariableStatistics::UnivariableStatistics(const ModelData& modelData)
+	: modelData(modelData), nRows(modelData.getNumberOfRows()), grouped(false) {
+
+	const std::vector<real>& y = modelData.getYVectorRef();
+
+	double sumY = 0.0;
+	double sumY2 = 0.0;
+	for (size_t i = 0; i < nRows; ++i) {
+		sumY += y[i];
+		sumY2 += y[i] * y[i];
+	}
+	meanY = sumY / nRows;
+	varianceY = sumY2 / nRows - meanY * meanY;
+
+	std::vector<double> xBeta(nRows, 0.0);
+	if (modelData.getHasOffsetCovariate()) {
+		const PinnedColumn pinned(modelData, 0);
+		forEachEntry(modelData.getColumn(0), nRows, [&xBeta](const size_t row, const double x) {
+			xBeta[row] = x;
+		});
+	}
+
+	switch (modelData.getModelType()) {
+		case ModelType::CONDITIONAL_LOGISTIC :
+		case ModelType::TIED_CONDITIONAL_LOGISTIC :
+		case ModelType::CONDITIONAL_POISSON :
+		case ModelType::SELF_CONTROLLED_MODEL :
+		case ModelType::COX :
+		case ModelType::COX_RAW :
+			initializeGrouped(xBeta);
+			break;
+		default :
+			initializeIndependent(xBeta);
+			break;
+	}
+}
+
+void UnivariableStatistics::initializeIndependent(const std::vector<double>& xBeta) {
+
+	const std::vector<real>& y = modelData.getYVectorRef();
+	const ModelType modelType = modelData.getModelType();
+
+	residual.resize(nRows);
+	curvature.resize(nRows);
+	for (size_t i = 0; i < nRows; ++i) {
+		double mean;
+		double variance;
+		if (modelType == ModelType::LOGISTIC) {
+			mean = 1.0 / (1.0 + std::exp(-xBeta[i]));
+			variance = mean * (1.0 - mean);
+		} else if (modelType == ModelType::POISSON) {
+			mean = std::exp(xBeta[i]);
+			variance = mean;
+		} else { // NORMAL
+			mean = xBeta[i];
+			variance = 1.0;
+		}
+		residual[i] = y[i] - mean;
+		curvature[i] = variance;
+	}
+}
+
+void UnivariableStatistics::initializeGrouped(const std::vector<double>& xBeta) {
+
+	grouped = true;
+
+	const std::vector<real>& y = modelData.getYVectorRef();
+	const std::vector<real>& time = modelData.getTimeVectorRef();
+	const std::vector<int>& pid = modelData.getPidVectorRef();
+	const ModelType modelType = modelData.getModelType();
+
+	const bool isCox = modelType == ModelType::COX || modelType == ModelType::COX_RAW;
+	const bool hasTime = time.size() == nRows;
+
+	// Conditional models: one group per stratum.  Cox: strata of groups with tied times,
+	// each at risk through the end of its group; COX_RAW: one stratum, no tie handling.
+	weight.resize(nRows);
+	rowGroup.resize(nRows);
+	std::vector<double> events;
+	std::vector<double> atRisk;
+	std::vector<int> stratumBegin;
+
+	for (size_t i = 0; i < nRows; ++i) {
+		const bool newStratum = (i == 0) ||
+			(modelType != ModelType::COX_RAW && pid[i] != pid[i - 1]);
+		const bool newGroup = newStratum ||
+			modelType == ModelType::COX_RAW ||
+			(modelType == ModelType::COX && hasTime && time[i] != time[i - 1]);
+
+		if (newGroup) {
+			stratumBegin.push_back(newStratum ? events.size() : stratumBegin.back());
+			atRisk.push_back((newStratum || !isCox) ? 0.0 : atRisk.back());
+			events.push_back(0.0);
+		}
+
+		weight[i] = std::exp(xBeta[i]);
+		if (modelType == ModelType::SELF_CONTROLLED_MODEL && hasTime) {
+			weight[i] *= time[i];
+		}
+		rowGroup[i] = events.size() - 1;
+		events.back() += y[i];
+		atRisk.back() += weight[i];
+	}
+
+	const size_t nGroups = events.size();
+	stratumEnd.resize(nGroups);
+	for (size_t g = nGroups; g > 0; --g) {
+		const size_t group = g - 1;
+		stratumEnd[group] = (group + 1 == nGroups || stratumBegin[group + 1] == static_cast<int>(group + 1)) ?
+			group + 1 : stratumEnd[group + 1];
+	}
+
+	// Cumulative hazard increments summed over the groups each row is at risk in
+	std::vector<double> hazard(nGroups);
+	for (size_t g = nGroups; g > 0; --g) {
+		const size_t group = g - 1;
+		hazard[group] = ratio(events[group], atRisk[group]) +
+			(stratumEnd[group] > static_cast<int>(group + 1) ? hazard[group + 1] : 0.0);
+	}
+
+	groupPrefix.resize(nGroups + 1);
+	groupPrefix[0] = 0.0;
+	for (size_t g = 0; g < nGroups; ++g) {
+		groupPrefix[g + 1] = groupPrefix[g] + ratio(events[g], atRisk[g] * atRisk[g]);
+	}
+
+	residual.resize(nRows);
+	curvature.resize(nRows);
+	for (size_t i = 0; i < nRows; ++i) {
+		curvature[i] = weight[i] * hazard[rowGroup[i]];
+		residual[i] = y[i] - curvature[i];
+	}
+}
+
+template <typename Function>
+void UnivariableStatistics::forEachColumn(const std::vector<size_t>& columns, int nThreads,
+		Function function) const {
+
+	// Contiguous blocks of columns per thread; every column writes only its own slot
+	auto oneColumn = [this, &columns, &function](const size_t c) {
+		const PinnedColumn pinned(modelData, columns[c]);
+		function(c, modelData.getColumn(columns[c]));
+	};
+
+	forEachTask(columns.size(), modelData.getColumnThreadCount(nThreads), oneColumn);
+}
+
+std::vector<double> UnivariableStatistics::correlation(const std::vector<size_t>& columns,
+		int nThreads) const {
+
+	const std::vector<real>& y = modelData.getYVectorRef();
+	std::vector<double> result(columns.size());
+
+	forEachColumn(columns, nThreads, [this, &y, &result](const size_t c,
+			const CompressedDataColumn& column) {
+
+		double sumX = 0.0;
+		double sumXY = 0.0;
+		forEachEntry(column, nRows, [&y, &sumX, &sumXY](const size_t row, const double x) {
+			sumX += x;
+			sumXY += x * y[row];
+		});
+		const double sumX2 = column.squaredSumColumn(nRows);
+
+		const double meanX = sumX / nRows;
+		const double varianceX = sumX2 / nRows - meanX * meanX;
+		const double covariance = sumXY / nRows - meanX * meanY;
+
+		result[c] = (varianceX > 0.0 && varianceY > 0.0) ?
+			covariance / std::sqrt(varianceX) / std::sqrt(varianceY) :
+			std::numeric_limits<double>::quiet_NaN();
+	});
+
+	return result;
+}
+
+void UnivariableStatistics::score(const std::vector<size_t>& columns, std::vector<double>& gradient,
+		std::vector<double>& information, int nThreads) const {
+
+	gradient.assign(columns.size(), 0.0);
+	information.assign(columns.size(), 0.0);
+
+	forEachColumn(columns, nThreads, [this, &gradient, &information](const size_t c,
+			const CompressedDataColumn& column) {
+
+		double g = 0.0;
+		double h = 0.0;
+		forEachEntry(column, nRows, [this, &g, &h](const size_t row, const double x) {
+			g += x * residual[row];
+			h += x * x * curvature[row];
+		});
+
+		if (grouped) {
+			// S1 holds from group 'last' until the next group with an entry or the end of the stratum
+			double squared = 0.0;
+			double s1 = 0.0;
+			int last = -1;
+			forEachEntry(column, nRows, [this, &squared, &s1, &last](const size_t row, const double x) {
+				if (x == 0.0) {
+					return;
+				}
+				const int group = rowGroup[row];
+				if (last >= 0) {
+					if (stratumEnd[last] > group) {
+						squared += s1 * s1 * (groupPrefix[group] - groupPrefix[last]);
+					} else {
+						squared += s1 * s1 * (groupPrefix[stratumEnd[last]] - groupPrefix[last]);
+						s1 = 0.0;
+					}
+				}
+				last = group;
+				s1 += weight[row] * x;
+			});
+			if (last >= 0) {
+				squared += s1 * s1 * (groupPrefix[stratumEnd[last]] - groupPrefix[last]);
+			}
+			h -= squared;
+		}
+
+		gradient[c] = g;
+		information[c] = h;
+	});
+}
+
+} // namespace
@@ -0,0 +1,64 @@
+/*
+ * UnivariableStatistics.h
+ *
+ * Batch screening statistics for many covariates at once: the correlation of each
+ * column with the outcome, and the score (gradient and Fisher information of the
+ * log-likelihood) of each column at beta = 0.  Everything that depends only on the
+ * outcomes is computed once, so each column costs one pass over its entries.
+ */
+
+#ifndef UNIVARIABLESTATISTICS_H_
+#define UNIVARIABLESTATISTICS_H_
+
+#include <vector>
+
+#include "ModelData.h"
+
+namespace bsccs {
+
+class UnivariableStatistics {
+public:
+
+	/**
+	 * Grouped models assume the ModelData row order: sorted by stratum and, for Cox
+	 * models, by decreasing time within stratum.  A fixed offset covariate enters the
+	 * linear predictor; all other coefficients are zero.
+	 */
+	UnivariableStatistics(const ModelData& modelData);
+
+	// NaN when the column or the outcome is constant
+	std::vector<double> correlation(const std::vector<size_t>& columns, int nThreads = 1) const;
+
+	void score(const std::vector<size_t>& columns, std::vector<double>& gradient,
+		std::vector<double>& information, int nThreads = 1) const;
+
+private:
+
+	template <typename Function>
+	void forEachColumn(const std::vector<size_t>& columns, int nThreads, Function function) const;
+
+	void initializeIndependent(const std::vector<double>& xBeta);
+
+	void initializeGrouped(const std::vector<double>& xBeta);
+
+	const ModelData& modelData;
+	const size_t nRows;
+
+	double meanY;
+	double varianceY;
+
+	// Score at beta = 0: gradient = sum x_i residual_i; information = sum x_i^2 curvature_i,
+	// less sum_G events_G (S1_G / S0_G)^2 for risk-set groups G in grouped models
+	std::vector<double> residual;
+	std::vector<double> curvature;
+
+	bool grouped;
+	std::vector<double> weight;       // risk-set weight of each row
+	std::vector<int> rowGroup;        // risk-set group of each row
+	std::vector<double> groupPrefix;  // prefix sums of events_G / S0_G^2
+	std::vector<int> stratumEnd;      // one past the last group in the stratum of each group
+};
+
+} // namespace
+
+#endif /* UNIVARIABLESTATISTICS_H_ */
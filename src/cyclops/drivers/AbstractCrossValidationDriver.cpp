@@ -12,6 +12,8 @@
 
 #include "Types.h"
 #include "Thread.h"
+#include "PerformanceCounters.h"
+#include "Trace.h"
 #include "AbstractCrossValidationDriver.h"
 
 namespace bsccs {
@@ -54,7 +56,7 @@ void AbstractCrossValidationDriver::drive(
         bsccs::thread::hardware_concurrency() :
 	    allArguments.threads;
 
-    if (nThreads < 1) {
+    if (nThreads < 1 || ccd.getIsOutOfCore()) { // Folds would evict each other's columns
         nThreads = 1;
     }
 
@@ -65,10 +67,12 @@ void AbstractCrossValidationDriver::drive(
 	std::vector<CyclicCoordinateDescent*> ccdPool;
 	std::vector<AbstractSelector*> selectorPool;
 
+	ccd.setThreadCount(1); // Parallelize across folds only
 	ccdPool.push_back(&ccd);
 	selectorPool.push_back(&selector);
 
 	for (int i = 1; i < nThreads; ++i) {
+		trace::Span span("clone", "crossValidation", "thread", i);
 		ccdPool.push_back(ccd.clone());
 		selectorPool.push_back(selector.clone());
 	}
@@ -141,6 +145,8 @@ double AbstractCrossValidationDriver::doCrossValidationStep(
     const auto& arguments = allArguments.crossValidation;
     bool coldStart = allArguments.resetCoefficients;
 
+	trace::Span span("crossValidationStep", "crossValidation", "step", step);
+
 	predLogLikelihood.resize(arguments.foldToCompute);
 
 	auto& weightsExclude = this->weightsExclude;
@@ -159,6 +165,9 @@ double AbstractCrossValidationDriver::doCrossValidationStep(
 		 		, &scheduler
 			](int task) {
 
+				performance::ScopedCounter counter(performance::CROSS_VALIDATION_FOLD);
+				trace::Span span("fold", "crossValidation", "task", task);
+
 			    const auto uniqueId = scheduler.getThreadIndex(task);
 				auto ccdTask = ccdPool[uniqueId];
 				auto selectorTask = selectorPool[uniqueId];
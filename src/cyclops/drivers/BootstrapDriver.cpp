@@ -15,6 +15,7 @@
 
 #include "BootstrapDriver.h"
 #include "AbstractSelector.h"
+#include "io/OutputWriter.h"
 
 namespace bsccs {
 
@@ -76,30 +77,41 @@ void BootstrapDriver::logResults(const CCDArguments& arguments) {
     error->throwError(stream);
 }
 
-void BootstrapDriver::logResults(const CCDArguments& arguments, std::vector<double>& savedBeta, std::string conditionId) {
+template <typename Stream>
+void BootstrapDriver::logResults(Stream& out, const CCDArguments& arguments,
+		std::vector<double>& savedBeta, std::string conditionId, bool header) {
 
-	ofstream outLog(arguments.outFileName.c_str());
-	if (!outLog) {
-        std::ostringstream stream;        
-		stream << "Unable to open log file: " << arguments.bsFileName;
+	if (!out.open(arguments.outFileName.c_str(), std::ios::out)) {
+        std::ostringstream stream;
+		stream << "Unable to open log file: " << arguments.outFileName;
 		error->throwError(stream);
 	}
 
-	string sep(","); // TODO Make option
-
-	if (!arguments.reportRawEstimates) {
-		outLog << "Drug_concept_id" << sep << "Condition_concept_id" << sep <<
-				"score" << sep << "standard_error" << sep << "bs_mean" << sep << "bs_lower" << sep <<
-				"bs_upper" << sep << "bs_prob0" << endl;
+	if (arguments.reportRawEstimates) {
+		if (header) {
+			out.addHeader("label").addDelimitor().addHeader("condition");
+			for (int step = 0; step < replicates; ++step) {
+				std::ostringstream name;
+				name << "replicate_" << (step + 1);
+				out.addDelimitor().addHeader(name.str());
+			}
+			out.addEndl();
+		}
+	} else {
+		out.addHeader("Drug_concept_id").addDelimitor().addHeader("Condition_concept_id").addDelimitor()
+			.addHeader("score").addDelimitor().addHeader("standard_error").addDelimitor()
+			.addHeader("bs_mean").addDelimitor().addHeader("bs_lower").addDelimitor()
+			.addHeader("bs_upper").addDelimitor().addHeader("bs_prob0").addEndl();
 	}
 
 	for (int j = 0; j < J; ++j) {
-		outLog << modelData->getColumn(j).getLabel() <<
-			sep << conditionId << sep;
+		out.addValue(modelData->getColumn(j).getLabel()).addDelimitor()
+			.addValue(conditionId).addDelimitor();
 		if (arguments.reportRawEstimates) {
-			ostream_iterator<real> output(outLog, sep.c_str());
-			copy(estimates[j]->begin(), estimates[j]->end(), output);
-			outLog << endl;
+			for (rvector::iterator it = estimates[j]->begin(); it != estimates[j]->end(); ++it) {
+				out.addValue(*it).addDelimitor();
+			}
+			out.addEndl();
 		} else {
 			real mean = 0.0;
 			real var = 0.0;
@@ -124,11 +136,27 @@ void BootstrapDriver::logResults(const CCDArguments& arguments, std::vector<doub
 			real lower = *(estimates[j]->begin() + offsetLower);
 			real upper = *(estimates[j]->begin() + offsetUpper);
 
-			outLog << savedBeta[j] << sep;
-			outLog << std::sqrt(var) << sep << mean << sep << lower << sep << upper << sep << prob0 << endl;
+			out.addValue(savedBeta[j]).addDelimitor();
+			out.addValue(std::sqrt(var)).addDelimitor().addValue(mean).addDelimitor()
+				.addValue(lower).addDelimitor().addValue(upper).addDelimitor()
+				.addValue(prob0).addEndl();
 		}
 	}
-	outLog.close();
+	out.endTable("bootstrap");
+}
+
+void BootstrapDriver::logResults(const CCDArguments& arguments, std::vector<double>& savedBeta, std::string conditionId) {
+
+	string sep(","); // TODO Make option
+
+	if (arguments.binaryOutput) {
+		OutputHelper::BinaryColumnStream out(sep);
+		logResults(out, arguments, savedBeta, conditionId, true);
+	} else {
+		// Raw estimates have no header line
+		OutputHelper::OFStream out(sep);
+		logResults(out, arguments, savedBeta, conditionId, false);
+	}
 }
 
 } // namespace
@@ -40,6 +40,10 @@ public:
 	void logResults(const CCDArguments& arguments, std::vector<double>& savedBeta, std::string conditionId);
 
 private:
+	template <typename Stream>
+	void logResults(Stream& out, const CCDArguments& arguments, std::vector<double>& savedBeta,
+			std::string conditionId, bool header);
+
 	const int replicates;
 	ModelData* modelData;
 	const int J;
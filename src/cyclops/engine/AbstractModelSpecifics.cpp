@@ -7,6 +7,8 @@
 
 #include <stdexcept>
 #include <set>
+#include <unordered_set>
+#include <atomic>
 
 #include "AbstractModelSpecifics.h"
 #include "ModelData.h"
@@ -87,6 +89,55 @@ AbstractModelSpecifics* AbstractModelSpecifics::factory(const ModelType modelTyp
 	return model;
 }
 
+namespace {
+
+template <class BaseModel>
+void predictWith(const real* xBeta, real* y, size_t length) {
+	BaseModel model;
+	for (size_t i = 0; i < length; ++i) {
+		y[i] = xBeta[i];
+		model.predictEstimate(y[i], xBeta[i]);
+	}
+}
+
+} // namespace
+
+void AbstractModelSpecifics::predictEstimates(const ModelType modelType, const real* xBeta,
+		real* y, size_t length) {
+	switch (modelType) {
+		case ModelType::SELF_CONTROLLED_MODEL :
+			predictWith<SelfControlledCaseSeries<real>>(xBeta, y, length);
+			break;
+		case ModelType::CONDITIONAL_LOGISTIC :
+			predictWith<ConditionalLogisticRegression<real>>(xBeta, y, length);
+			break;
+		case ModelType::TIED_CONDITIONAL_LOGISTIC :
+			predictWith<TiedConditionalLogisticRegression<real>>(xBeta, y, length);
+			break;
+		case ModelType::LOGISTIC :
+			predictWith<LogisticRegression<real>>(xBeta, y, length);
+			break;
+		case ModelType::NORMAL :
+			predictWith<LeastSquares<real>>(xBeta, y, length);
+			break;
+		case ModelType::POISSON :
+			predictWith<PoissonRegression<real>>(xBeta, y, length);
+			break;
+		case ModelType::CONDITIONAL_POISSON :
+			predictWith<ConditionalPoissonRegression<real>>(xBeta, y, length);
+			break;
+		case ModelType::COX_RAW :
+			predictWith<CoxProportionalHazards<real>>(xBeta, y, length);
+			break;
+		case ModelType::COX :
+			predictWith<BreslowTiedCoxProportionalHazards<real>>(xBeta, y, length);
+			break;
+		default :
+			std::copy(xBeta, xBeta + length, y);
+			break;
+	}
+}
+
 //AbstractModelSpecifics::AbstractModelSpecifics(
 //		const std::vector<real>& y,
 //		const std::vector<real>& z) : hY(y), hZ(z) {
@@ -104,7 +155,8 @@ AbstractModelSpecifics::AbstractModelSpecifics(const ModelData& input)
 	  hOffs(input.getTimeVectorRef()),
 // 	  hPid(const_cast<int*>(input.getPidVectorRef().data()))
 // 	  hPid(input.getPidVectorRef())
-      hPidOriginal(input.getPidVectorRef()), hPid(const_cast<int*>(hPidOriginal.data()))
+      hPidOriginal(input.getPidVectorRef()), hPid(const_cast<int*>(hPidOriginal.data())),
+      pagerKey(0), sparseIndicesMax(0)
 	  {
 	// Do nothing
 }
@@ -120,6 +172,50 @@ void AbstractModelSpecifics::makeDirty(void) {
 //	}
 }
 
+MemoryFootprint AbstractModelSpecifics::getMemoryFootprint() const {
+	MemoryFootprint footprint;
+	const std::string owner = "engine";
+
+	memory::add(footprint, owner, "K", memory::bytes(hXBeta) + memory::bytes(hXBetaSave) +
+		memory::bytes(offsExpXBeta) + memory::bytes(hPidInternal));
+	memory::add(footprint, owner, "N", memory::bytes(denomPid) + memory::bytes(numerPid) +
+		memory::bytes(numerPid2) + memory::bytes(accDenomPid) + memory::bytes(accNumerPid) +
+		memory::bytes(accNumerPid2) + memory::bytes(accReset));
+	memory::add(footprint, owner, "J", memory::bytes(hXjY) + memory::bytes(hXjX));
+
+	// Columns with the same row indices share one IndexVector; count it once
+	uint64_t indexBytes = memory::bytes(sparseIndices);
+	std::unordered_set<const IndexVector*> seen;
+	for (const auto& indices : sparseIndices) {
+		if (indices && seen.insert(indices.get()).second) {
+			indexBytes += sizeof(IndexVector) + memory::bytes(*indices);
+		}
+	}
+	memory::add(footprint, owner, "sparseIndices", indexBytes);
+
+	uint64_t crossBytes = memory::bytes(hessianCrossTerms);
+	for (const auto& entry : hessianCrossTerms) {
+		crossBytes += memory::bytes(entry.second);
+	}
+	memory::add(footprint, owner, "hessianCrossTerms", crossBytes);
+
+	uint64_t sparseCrossBytes = memory::bytes(hessianSparseCrossTerms);
+	for (const auto& entry : hessianSparseCrossTerms) {
+		if (entry.second) {
+			sparseCrossBytes += entry.second->getStorageBytes();
+		}
+	}
+	memory::add(footprint, owner, "hessianSparseCrossTerms", sparseCrossBytes);
+
+	uint64_t tieBytes = memory::bytes(ties) + memory::bytes(beginTies) + memory::bytes(endTies);
+	for (const auto& tie : ties) {
+		tieBytes += memory::bytes(tie);
+	}
+	memory::add(footprint, owner, "ties", tieBytes);
+
+	return footprint;
+}
+
 int AbstractModelSpecifics::getAlignedLength(int N) {
 	return (N / 16) * 16 + (N % 16 == 0 ? 0 : 16);
 }
@@ -186,27 +282,66 @@ void AbstractModelSpecifics::setPidForAccumulation(const real* weights) {
 
 void AbstractModelSpecifics::setupSparseIndices(const int max) {
 	sparseIndices.clear(); // empty if full!
+	sparseIndicesMax = max;
+
+	if (modelData.isOutOfCore()) {
+		// Independent models never read the indices.  Grouped models index each paged
+		// column on first use and keep the result with the column, within the pager's
+		// budget; a fresh key drops indices built for an earlier hPid.
+		static std::atomic<uint64_t> nextPagerKey(1);
+		if (pagerKey) {
+			modelData.getColumnPager()->detach(pagerKey);
+		}
+		pagerKey = hasIndependentRows() ? 0 : nextPagerKey++;
+		pagedIndices.reset();
+		return;
+	}
+	pagerKey = 0;
+
+	const auto shared = modelData.getSharedColumnMap();
 
 	for (size_t j = 0; j < J; ++j) {
 		if (modelData.getFormatType(j) == DENSE || modelData.getFormatType(j) == INTERCEPT) {
 			sparseIndices.push_back(NULL);
+		} else if (shared[j] != j) { // Identical column already indexed
+			sparseIndices.push_back(sparseIndices[shared[j]]);
 		} else {
-			std::set<int> unique;
-			const size_t n = modelData.getNumberOfEntries(j);
-			const int* indicators = modelData.getCompressedColumnVector(j);
-			for (size_t j = 0; j < n; j++) { // Loop through non-zero entries only
-				const int k = indicators[j];
-				const int i = hPid[k];  // TODO container-overflow #Generate some simulated data: #Fit the model
-				if (i < max) {
-					unique.insert(i);
-				}
-			}
-			auto indices = bsccs::make_shared<IndexVector>(unique.begin(), unique.end());
-            sparseIndices.push_back(indices);
+			sparseIndices.push_back(buildSparseIndices(j, max));
 		}
 	}
 }
 
+AbstractModelSpecifics::IndexVectorPtr AbstractModelSpecifics::buildSparseIndices(int index,
+		int max) const {
+	std::set<int> unique;
+	const size_t n = modelData.getNumberOfEntries(index);
+	const int* indicators = modelData.getCompressedColumnVector(index);
+	for (size_t j = 0; j < n; j++) { // Loop through non-zero entries only
+		const int k = indicators[j];
+		const int i = hPid[k];  // TODO container-overflow #Generate some simulated data: #Fit the model
+		if (i < max) {
+			unique.insert(i);
+		}
+	}
+	return bsccs::make_shared<IndexVector>(unique.begin(), unique.end());
+}
+
+AbstractModelSpecifics::IndexVector* AbstractModelSpecifics::getPagedSparseIndices(int index) {
+	const FormatType format = modelData.getFormatType(index);
+	if (format == DENSE || format == INTERCEPT) {
+		return nullptr;
+	}
+
+	const CompressedDataColumn& column = modelData.getColumn(index); // Pages the column in
+	ColumnPager& pager = *modelData.getColumnPager();
+	pagedIndices = pager.getAttached(column, pagerKey);
+	if (!pagedIndices) {
+		pagedIndices = buildSparseIndices(index, sparseIndicesMax);
+		pager.attach(column, pagerKey, pagedIndices);
+	}
+	return pagedIndices.get();
+}
+
 void AbstractModelSpecifics::initialize(
 		int iN,
 		int iK,
@@ -256,8 +391,8 @@ void AbstractModelSpecifics::initialize(
 // 	denomPid = numerPid + alignedLength; // Nested in denomPid allocation
 // 	numerPid2 = numerPid + 2 * alignedLength;
 	denomPid.resize(alignedLength);
-	numerPid.resize(alignedLength);
-	numerPid2.resize(alignedLength);
+	numerPid.assign(alignedLength, static_cast<real>(0)); // Grouped gradients expect zeros
+	numerPid2.assign(alignedLength, static_cast<real>(0));
 
 }
 
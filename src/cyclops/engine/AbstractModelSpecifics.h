@@ -12,13 +12,15 @@
 #include <cmath>
 #include <map>
 #include <cstddef>
+#include <algorithm>
 
 #include "Types.h"
+#include "MemoryFootprint.h"
+#include "CompressedDataMatrix.h"
+#include "priors/CovariatePrior.h"
 
 namespace bsccs {
 
-class CompressedDataMatrix;  // forward declaration
-class CompressedDataColumn; // forward declaration
 class ModelData; // forward declaration
 enum class ModelType; // forward declaration
 
@@ -28,6 +30,33 @@ enum class ModelType; // forward declaration
 	typedef float real;
 #endif
 
+/**
+ * Consecutive free columns [begin, end) that share a storage format and a closed-form
+ * prior, updated in one call to AbstractModelSpecifics::sweep().
+ */
+struct SweepRun {
+	int begin;
+	int end;
+	FormatType format;
+	priors::Penalty penalty;
+};
+
+// Clamps a coordinate step to its trust region and adapts the region for the next pass
+inline double applyTrustRegion(double delta, double& bound) {
+	if (delta < -bound) {
+		delta = -bound;
+	} else if (delta > bound) {
+		delta = bound;
+	}
+
+	// TODO Remove magic numbers
+	auto intermediate = std::max(std::abs(delta) * 2, bound / 2);
+	intermediate = std::max(intermediate, 1E-3);
+	bound = intermediate;
+
+	return delta;
+}
+
 // #define DEBUG_COX // Uncomment to get output for Cox model
 // #define DEBUG_COX_MIN
 // #define DEBUG_POISSON
@@ -84,6 +113,13 @@ public:
     virtual void getPredictiveEstimates(real* y, real* weights) = 0; // pure virtual
 
     virtual void makeDirty();
+
+    // One cyclic pass over a run of columns: gradient and Hessian, penalized Newton step
+    // within the trust region in bound, and linear predictor update for each column in turn
+    virtual void sweep(const SweepRun& run, double* beta, double* bound, bool useWeights) = 0; // pure virtual
+
+    // Engine state by component; the data it references are not counted
+    virtual MemoryFootprint getMemoryFootprint() const;
     
     virtual void printTiming() = 0; // pure virtual
 
@@ -94,6 +130,10 @@ public:
 	virtual AbstractModelSpecifics* clone() const = 0; // pure virtual
 	
 	static AbstractModelSpecifics* factory(const ModelType modelType, const ModelData& modelData);
+
+	// Response-scale values of linear predictors under the model's predictEstimate();
+	// models without one return the linear predictor
+	static void predictEstimates(const ModelType modelType, const real* xBeta, real* y, size_t length);
 	
 	// TODO Remove the following
 	RealVector& getXBeta() { return hXBeta; }
@@ -108,6 +148,8 @@ protected:
 	
 	void setupSparseIndices(const int max);	
 
+	virtual bool hasIndependentRows(void) = 0; // pure virtual
+
 	virtual bool allocateXjY(void) = 0; // pure virtual
 
 	virtual bool allocateXjX(void) = 0; // pure virtual
@@ -196,6 +238,19 @@ protected:
 
 	std::vector<IndexVectorPtr> sparseIndices; // TODO in c++11, are pointers necessary?
 
+	// Strata touched by a column; null for dense columns
+	IndexVector* getSparseIndices(int index) {
+		return pagerKey ? getPagedSparseIndices(index) : sparseIndices[index].get();
+	}
+
+	IndexVector* getPagedSparseIndices(int index);
+
+	IndexVectorPtr buildSparseIndices(int index, int max) const;
+
+	uint64_t pagerKey; // Out-of-core grouped models keep sparse indices with the pager
+	int sparseIndicesMax;
+	IndexVectorPtr pagedIndices; // Last paged-in indices, kept alive while in use
+
 	typedef std::map<int, std::vector<real> > HessianMap;
 	HessianMap hessianCrossTerms;
 
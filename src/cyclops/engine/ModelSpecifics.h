@@ -16,11 +16,6 @@
 #include <complex>
 
 // #define CYCLOPS_DEBUG_TIMING
-// #define CYCLOPS_DEBUG_TIMING_LOW
-
-#ifdef CYCLOPS_DEBUG_TIMING
-    #include "Timing.h"
-#endif
 
 #include <type_traits>
 #include <iterator>
@@ -194,6 +189,8 @@ protected:
 
 	void updateXBeta(real realDelta, int index, bool useWeights);
 
+	void sweep(const SweepRun& run, double* beta, double* bound, bool useWeights);
+
 	void computeRemainingStatistics(bool useWeights);
 
 	void computeAccumlatedNumerator(bool useWeights);
@@ -226,8 +223,12 @@ protected:
 
 	bool hasResetableAccumulators(void);
 
+	bool hasIndependentRows(void);
+
 	void printTiming(void);
 
+	MemoryFootprint getMemoryFootprint() const;
+
 private:
 	template <class IteratorType, class Weights>
 	void computeGradientAndHessianImpl(
@@ -235,9 +236,23 @@ private:
 			double *gradient,
 			double *hessian, Weights w);
 
+	template <class IteratorType>
+	void computeNumeratorForGradientImpl(int index);
+
 	template <class IteratorType>
 	void incrementNumeratorForGradientImpl(int index);
 
+	template <class IteratorType>
+	void dispatchSweep(const SweepRun& run, double* beta, double* bound, bool useWeights);
+
+	template <class IteratorType, class Prior>
+	void dispatchSweep(const SweepRun& run, const Prior& prior, double* beta, double* bound,
+			bool useWeights);
+
+	template <class IteratorType, class Prior, class Weights>
+	void sweepImpl(const SweepRun& run, const Prior& prior, double* beta, double* bound,
+			bool useWeights, Weights w);
+
 	template <class IteratorType>
 	void updateXBetaImpl(real delta, int index, bool useWeights);
 
@@ -279,12 +294,6 @@ private:
 	ParallelInfo info;
 
 //	C11ThreadPool threadPool;
-
-#ifdef CYCLOPS_DEBUG_TIMING
-//	std::vector<double> duration;
-	std::map<std::string,long long> duration;
-#endif
-
 };
 
 template <typename WeightType>
@@ -769,6 +778,73 @@ struct TestGradientKernel : private BaseModel {
     }
 };
 
+/**
+ * Grouped models, sparse columns: scatters the gradient numerators into their strata.
+ * Numerators must be zero on entry; GroupedGradientKernel resets them as it reads them.
+ */
+template <class BaseModel, class IteratorType, class RealType, class IntType>
+struct GroupedNumeratorKernel : private BaseModel {
+
+    typedef typename IteratorType::XTuple XTuple;
+
+	GroupedNumeratorKernel(RealType* _numerator, RealType* _numerator2,
+			const RealType* _expXBeta, const IntType* _pid)
+			: numerator(_numerator), numerator2(_numerator2), expXBeta(_expXBeta), pid(_pid) { }
+
+	void operator()(XTuple tuple) {
+
+		const IntType k = boost::get<0>(tuple);
+		const auto x = TupleXGetter<IteratorType, RealType>()(tuple);
+		const auto n = BaseModel::getGroup(pid, k);
+
+		numerator[n] += BaseModel::gradientNumeratorContrib(x, expXBeta[k], 0.0, 0.0);
+		if (!IteratorType::isIndicator && BaseModel::hasTwoNumeratorTerms) {
+			numerator2[n] += BaseModel::gradientNumerator2Contrib(x, expXBeta[k]);
+		}
+	}
+
+private:
+	RealType* numerator;
+	RealType* numerator2;
+	const RealType* expXBeta;
+	const IntType* pid;
+};
+
+/**
+ * Grouped models, sparse columns: gradient and Hessian over the touched strata.  Each
+ * stratum's numerators are reset once read, so the next column starts from zero
+ * without a separate fill.
+ */
+template <class BaseModel, class IteratorType, class WeightType, class RealType, class IntType>
+struct GroupedGradientKernel : private BaseModel {
+
+	GroupedGradientKernel(RealType* _numerator, RealType* _numerator2,
+			const RealType* _denominator, const RealType* _weight)
+			: numerator(_numerator), numerator2(_numerator2),
+			  denominator(_denominator), weight(_weight) { }
+
+	Fraction<RealType> operator()(const Fraction<RealType>& lhs, const IntType n) {
+
+		const RealType numerator1 = numerator[n];
+		numerator[n] = static_cast<RealType>(0);
+
+		RealType numerator2n = static_cast<RealType>(0);
+		if (!IteratorType::isIndicator && BaseModel::hasTwoNumeratorTerms) {
+			numerator2n = numerator2[n];
+			numerator2[n] = static_cast<RealType>(0);
+		}
+
+		return BaseModel::template incrementGradientAndHessian<IteratorType, WeightType, RealType>(
+			lhs, numerator1, numerator2n, denominator[n], weight[n], 0.0, 0.0);
+	}
+
+private:
+	RealType* numerator;
+	RealType* numerator2;
+	const RealType* denominator;
+	const RealType* weight;
+};
+
 // template <class BaseModel, class IteratorType, class WeightOperationType,
 // class RealType, class IntType>
 // struct AccumulateGradientAndHessianKernel : private BaseModel {
@@ -1472,8 +1548,13 @@ public:
 	}
 
 	void predictEstimate(real& yi, real xBeta){
-		real t = exp(xBeta);
-		yi = t/(t+1);
+		// exp() of a non-positive argument cannot overflow
+		if (xBeta >= 0) {
+			yi = 1 / (1 + exp(-xBeta));
+		} else {
+			const real t = exp(xBeta);
+			yi = t / (1 + t);
+		}
 	}
 };
 
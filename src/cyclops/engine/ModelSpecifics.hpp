@@ -23,16 +23,9 @@
 #include "Recursions.hpp"
 #include "ParallelLoops.h"
 #include "Ranges.h"
+#include "PointerKernels.h"
 
-#ifdef CYCLOPS_DEBUG_TIMING
-	#include "Timing.h"
-	namespace bsccs {
-		const std::string DenseIterator::name = "Den";
-		const std::string IndicatorIterator::name = "Ind";
-		const std::string SparseIterator::name = "Spa";
-		const std::string InterceptIterator::name = "Icp";
-	}
-#endif
+#include "PerformanceCounters.h"
 
 //#define OLD_WAY
 //#define NEW_WAY1
@@ -295,14 +288,22 @@ void ModelSpecifics<BaseModel,WeightType>::printTiming() {
 #ifdef CYCLOPS_DEBUG_TIMING
 
 	std::cout << std::endl;
-	for (auto& d : duration) {
-		std::cout << d.first << " " << d.second << std::endl;
+	for (const auto& counter : performance::snapshot()) {
+		std::cout << counter.kernel << " " << counter.format << " " << counter.calls
+			<< " " << counter.nanoseconds << std::endl;
 	}
-	std::cout << "NEW LOOPS" << std::endl;
 
 #endif
 }
 
+template <class BaseModel, typename WeightType>
+MemoryFootprint ModelSpecifics<BaseModel,WeightType>::getMemoryFootprint() const {
+	MemoryFootprint footprint = AbstractModelSpecifics::getMemoryFootprint();
+	memory::add(footprint, "engine", "K", memory::bytes(hKWeight));
+	memory::add(footprint, "engine", "N", memory::bytes(hNWeight) + memory::bytes(hNtoK));
+	return footprint;
+}
+
 template <class BaseModel,typename WeightType>
 ModelSpecifics<BaseModel,WeightType>::~ModelSpecifics() {
 	// TODO Memory release here
@@ -336,6 +337,9 @@ bool ModelSpecifics<BaseModel,WeightType>::allocateNtoKIndices(void) { return Ba
 template <class BaseModel,typename WeightType>
 bool ModelSpecifics<BaseModel,WeightType>::hasResetableAccumulators(void) { return BaseModel::hasResetableAccumulators; }
 
+template <class BaseModel,typename WeightType>
+bool ModelSpecifics<BaseModel,WeightType>::hasIndependentRows(void) { return BaseModel::hasIndependentRows; }
+
 template <class BaseModel,typename WeightType>
 void ModelSpecifics<BaseModel,WeightType>::setWeights(real* inWeights, bool useCrossValidation) {
 	// Set K weights
@@ -373,7 +377,12 @@ void ModelSpecifics<BaseModel,WeightType>::setWeights(real* inWeights, bool useC
 
 template<class BaseModel, typename WeightType>
 void ModelSpecifics<BaseModel, WeightType>::computeXjY(bool useCrossValidation) {
+	const auto shared = modelData.getSharedColumnMap();
 	for (size_t j = 0; j < J; ++j) {
+		if (shared[j] != j) { // Identical column already computed
+			hXjY[j] = hXjY[shared[j]];
+			continue;
+		}
 		hXjY[j] = 0;
 
 		GenericIterator it(modelData, j);
@@ -405,7 +414,12 @@ void ModelSpecifics<BaseModel, WeightType>::computeXjY(bool useCrossValidation)
 
 template<class BaseModel, typename WeightType>
 void ModelSpecifics<BaseModel, WeightType>::computeXjX(bool useCrossValidation) {
+	const auto shared = modelData.getSharedColumnMap();
 	for (size_t j = 0; j < J; ++j) {
+		if (shared[j] != j) { // Identical column already computed
+			hXjX[j] = hXjX[shared[j]];
+			continue;
+		}
 		hXjX[j] = 0;
 		GenericIterator it(modelData, j);
 
@@ -485,9 +499,7 @@ void ModelSpecifics<BaseModel,WeightType>::computeFixedTermsInGradientAndHessian
 template <class BaseModel,typename WeightType>
 double ModelSpecifics<BaseModel,WeightType>::getLogLikelihood(bool useCrossValidation) {
 
-#ifdef CYCLOPS_DEBUG_TIMING
-	auto start = bsccs::chrono::steady_clock::now();
-#endif
+	performance::ScopedCounter counter(performance::COMPUTE_LOG_LIKELIHOOD);
 
 //     auto rangeNumerator = helper::getRangeAll(K);
 //
@@ -552,12 +564,6 @@ double ModelSpecifics<BaseModel,WeightType>::getLogLikelihood(bool useCrossValid
 		logLikelihood += logLikelihoodFixedTerm;
 	}
 
-#ifdef CYCLOPS_DEBUG_TIMING
-	auto end = bsccs::chrono::steady_clock::now();
-	///////////////////////////"
-	duration["compLogLike      "] += bsccs::chrono::duration_cast<chrono::TimingUnits>(end - start).count();
-#endif
-
 	return static_cast<double>(logLikelihood);
 }
 
@@ -631,17 +637,14 @@ template <class BaseModel,typename WeightType>
 void ModelSpecifics<BaseModel,WeightType>::computeGradientAndHessian(int index, double *ogradient,
 		double *ohessian, bool useWeights) {
 
-#ifdef CYCLOPS_DEBUG_TIMING
-#ifndef CYCLOPS_DEBUG_TIMING_LOW
-	auto start = bsccs::chrono::steady_clock::now();
-#endif
-#endif
-
 	if (modelData.getNumberOfNonZeroEntries(index) == 0) {
 	    *ogradient = 0.0; *ohessian = 0.0;
 	    return;
 	}
 
+	performance::ScopedCounter counter(performance::COMPUTE_GRADIENT_HESSIAN,
+		modelData.getFormatType(index));
+
 	// Run-time dispatch, so virtual call should not effect speed
 	if (useWeights) {
 		switch (modelData.getFormatType(index)) {
@@ -674,15 +677,6 @@ void ModelSpecifics<BaseModel,WeightType>::computeGradientAndHessian(int index,
 				break;
 		}
 	}
-
-#ifdef CYCLOPS_DEBUG_TIMING
-#ifndef CYCLOPS_DEBUG_TIMING_LOW
-	auto end = bsccs::chrono::steady_clock::now();
-	///////////////////////////"
-	duration["compGradAndHess  "] += bsccs::chrono::duration_cast<chrono::TimingUnits>(end - start).count();
-#endif
-#endif
-
 }
 
 template <class RealType>
@@ -697,12 +691,6 @@ template <class BaseModel,typename WeightType> template <class IteratorType, cla
 void ModelSpecifics<BaseModel,WeightType>::computeGradientAndHessianImpl(int index, double *ogradient,
 		double *ohessian, Weights w) {
 
-#ifdef CYCLOPS_DEBUG_TIMING
-#ifdef CYCLOPS_DEBUG_TIMING_LOW
-	auto start = bsccs::chrono::steady_clock::now();
-#endif
-#endif
-
 	real gradient = static_cast<real>(0);
 	real hessian = static_cast<real>(0);
 
@@ -713,7 +701,8 @@ void ModelSpecifics<BaseModel,WeightType>::computeGradientAndHessianImpl(int ind
 	    real lastH = hessian;
 #endif
 
-    	if (sparseIndices[index] == nullptr || sparseIndices[index]->size() > 0) {
+    	IndexVector* indices = getSparseIndices(index);
+    	if (indices == nullptr || indices->size() > 0) {
 
 		// TODO
 		// x. Fill numerators <- 0
@@ -721,7 +710,7 @@ void ModelSpecifics<BaseModel,WeightType>::computeGradientAndHessianImpl(int ind
 		// x. Segmented scan of numerators
 		// x. Transformation/reduction of [begin,end)
 
-		IteratorType it(sparseIndices[index].get(), N);
+		IteratorType it(indices, N);
 
 
 		real accNumerPid  = static_cast<real>(0);
@@ -822,6 +811,11 @@ void ModelSpecifics<BaseModel,WeightType>::computeGradientAndHessianImpl(int ind
 
 	} else if (BaseModel::hasIndependentRows) {
 
+#ifdef CYCLOPS_POINTER_KERNELS
+		const auto result = pointer::GradientAndHessianIndependent<BaseModel,IteratorType,Weights,real>()(
+		        modelData, index, begin(offsExpXBeta), begin(hXBeta), begin(hY),
+		        begin(denomPid), begin(hNWeight));
+#else
 		auto range = helper::independent::getRangeX(modelData, index,
 		        offsExpXBeta, hXBeta, hY, denomPid, hNWeight,
 		        typename IteratorType::tag());
@@ -831,6 +825,7 @@ void ModelSpecifics<BaseModel,WeightType>::computeGradientAndHessianImpl(int ind
  	        SerialOnly()
 // 		RcppParallel()
 		);
+#endif
 
 
 // 		const auto result2 = variants::reduce(range.begin(), range.end(), Fraction<real>(0,0),
@@ -883,13 +878,50 @@ void ModelSpecifics<BaseModel,WeightType>::computeGradientAndHessianImpl(int ind
 //
 // #ifdef NEW_WAY2
 
+		if (IteratorType::isSparse) { // Compile-time switch
+
+		// Numerators are scattered into their strata, then reduced over the strata the
+		// column touches; the reduction leaves them zero for the next column.  Neither
+		// pass branches on stratum boundaries, which are irregular in sparse columns.
+#ifdef CYCLOPS_POINTER_KERNELS
+		const auto result = pointer::GradientAndHessianGrouped<BaseModel,IteratorType,Weights,real>()(
+		        modelData, index, hPid, begin(offsExpXBeta), getSparseIndices(index), N,
+		        begin(numerPid), begin(numerPid2), begin(denomPid), begin(hNWeight));
+#else
+		auto rangeX = helper::getRangeX(modelData, index, typename IteratorType::tag());
+
+		variants::for_each(
+		        rangeX.begin(), rangeX.end(),
+		        GroupedNumeratorKernel<BaseModel,IteratorType,real,int>(
+		            begin(numerPid), begin(numerPid2), begin(offsExpXBeta), hPid),
+		        SerialOnly());
+
+		auto rangeStrata = helper::dependent::getRangeStrata(getSparseIndices(index), N,
+		        typename IteratorType::tag());
+
+		const auto result = variants::reduce(
+		        rangeStrata.begin(), rangeStrata.end(), Fraction<real>(0,0),
+		        GroupedGradientKernel<BaseModel,IteratorType,Weights,real,int>(
+		            begin(numerPid), begin(numerPid2), begin(denomPid), begin(hNWeight)),
+		        SerialOnly());
+#endif
+		gradient = result.real();
+		hessian = result.imag();
+
+		} else { // Every row present; a segmented reduction predicts well and avoids the scatter
+
+#ifdef CYCLOPS_POINTER_KERNELS
+		const auto result = pointer::GradientAndHessianDependent<BaseModel,IteratorType,Weights,real>()(
+		        modelData, index, hPid, begin(offsExpXBeta), getSparseIndices(index),
+		        begin(denomPid), begin(hNWeight));
+#else
 		auto rangeKey = helper::dependent::getRangeKey(modelData, index, hPid,
 		        typename IteratorType::tag());
 
         auto rangeXNumerator = helper::dependent::getRangeX(modelData, index, offsExpXBeta,
                 typename IteratorType::tag());
 
-        auto rangeGradient = helper::dependent::getRangeGradient(sparseIndices[index].get(), N, // runtime error: reference binding to null pointer of type 'struct vector'
+        auto rangeGradient = helper::dependent::getRangeGradient(getSparseIndices(index), N, // runtime error: reference binding to null pointer of type 'struct vector'
                 denomPid, hNWeight,
                 typename IteratorType::tag());
 
@@ -899,9 +931,12 @@ void ModelSpecifics<BaseModel,WeightType>::computeGradientAndHessianImpl(int ind
 		        std::pair<real,real>{0,0}, Fraction<real>{0,0},
                 TestNumeratorKernel<BaseModel,IteratorType,real>(), // Inner transform-reduce
 		       	TestGradientKernel<BaseModel,IteratorType,Weights,real>()); // Outer transform-reduce
+#endif
 
 		gradient = result.real();
 		hessian = result.imag();
+
+		}
 // #endif
 
 //       std::cerr << std::endl
@@ -923,16 +958,6 @@ void ModelSpecifics<BaseModel,WeightType>::computeGradientAndHessianImpl(int ind
 
  	*ogradient = static_cast<double>(gradient);
 	*ohessian = static_cast<double>(hessian);
-
-#ifdef CYCLOPS_DEBUG_TIMING
-#ifdef CYCLOPS_DEBUG_TIMING_LOW
-	auto end = bsccs::chrono::steady_clock::now();
-	///////////////////////////"
-	auto name = "compGradHess" + IteratorType::name + "  ";
-	duration[name] += bsccs::chrono::duration_cast<chrono::TimingUnits>(end - start).count();
-#endif
-#endif
-
  }
 
 template <class BaseModel,typename WeightType>
@@ -1098,89 +1123,53 @@ void ModelSpecifics<BaseModel,WeightType>::computeFisherInformationImpl(int inde
 template <class BaseModel,typename WeightType>
 void ModelSpecifics<BaseModel,WeightType>::computeNumeratorForGradient(int index) {
 
-#ifdef CYCLOPS_DEBUG_TIMING
-#ifndef CYCLOPS_DEBUG_TIMING_LOW
-	auto start = bsccs::chrono::steady_clock::now();
-#endif
-#endif
+	performance::ScopedCounter counter(performance::COMPUTE_NUMERATOR_FOR_GRADIENT,
+		modelData.getFormatType(index));
 
 	if (BaseModel::cumulativeGradientAndHessian) {
-//
-// 		// Run-time delegation
-// 		switch (modelData.getFormatType(index)) {
-// 			case INDICATOR :
-// 				incrementNumeratorForGradientImpl<IndicatorIterator>(index);
-// 				break;
-// 			case SPARSE :
-// 				incrementNumeratorForGradientImpl<SparseIterator>(index);
-// 				break;
-// 			case DENSE :
-// 				incrementNumeratorForGradientImpl<DenseIterator>(index);
-// 				break;
-// 			case INTERCEPT :
-// 				incrementNumeratorForGradientImpl<InterceptIterator>(index);
-// 				break;
-// 			default : break;
-// 				// throw error
-// 		}
 		switch (modelData.getFormatType(index)) {
-			case INDICATOR : {
-				IndicatorIterator it(*(sparseIndices)[index]);
-				for (; it; ++it) { // Only affected entries
-					numerPid[it.index()] = static_cast<real>(0.0);
-				}
-				incrementNumeratorForGradientImpl<IndicatorIterator>(index);
-				}
+			case INDICATOR :
+				computeNumeratorForGradientImpl<IndicatorIterator>(index);
 				break;
-			case SPARSE : {
-				SparseIterator it(*(sparseIndices)[index]);
-				for (; it; ++it) { // Only affected entries
-					numerPid[it.index()] = static_cast<real>(0.0);
-					if (BaseModel::hasTwoNumeratorTerms) { // Compile-time switch
-						numerPid2[it.index()] = static_cast<real>(0.0); // TODO Does this invalid the cache line too much?
-					}
-				}
-				incrementNumeratorForGradientImpl<SparseIterator>(index); }
+			case SPARSE :
+				computeNumeratorForGradientImpl<SparseIterator>(index);
 				break;
 			case DENSE :
-				zeroVector(numerPid.data(), N);
-				if (BaseModel::hasTwoNumeratorTerms) { // Compile-time switch
-					zeroVector(numerPid2.data(), N);
-				}
-				incrementNumeratorForGradientImpl<DenseIterator>(index);
+				computeNumeratorForGradientImpl<DenseIterator>(index);
 				break;
 			case INTERCEPT :
-				zeroVector(numerPid.data(), N);
-				if (BaseModel::hasTwoNumeratorTerms) { // Compile-time switch
-					zeroVector(numerPid2.data(), N);
-				}
-				incrementNumeratorForGradientImpl<InterceptIterator>(index);
+				computeNumeratorForGradientImpl<InterceptIterator>(index);
 				break;
 			default : break;
 				// throw error
 				//exit(-1);
 		}
 	}
+}
 
-#ifdef CYCLOPS_DEBUG_TIMING
-#ifndef CYCLOPS_DEBUG_TIMING_LOW
-	auto end = bsccs::chrono::steady_clock::now();
-	///////////////////////////"
-	duration["compNumForGrad   "] += bsccs::chrono::duration_cast<chrono::TimingUnits>(end - start).count();;
-#endif
-#endif
-
+template <class BaseModel,typename WeightType> template <class IteratorType>
+void ModelSpecifics<BaseModel,WeightType>::computeNumeratorForGradientImpl(int index) {
+
+	if (IteratorType::isSparse) { // Compile-time switch
+		IteratorType it(getSparseIndices(index), N);
+		for (; it; ++it) { // Only affected entries
+			numerPid[it.index()] = static_cast<real>(0.0);
+			if (!IteratorType::isIndicator && BaseModel::hasTwoNumeratorTerms) { // Compile-time switch
+				numerPid2[it.index()] = static_cast<real>(0.0); // TODO Does this invalid the cache line too much?
+			}
+		}
+	} else {
+		zeroVector(numerPid.data(), N);
+		if (BaseModel::hasTwoNumeratorTerms) { // Compile-time switch
+			zeroVector(numerPid2.data(), N);
+		}
+	}
+	incrementNumeratorForGradientImpl<IteratorType>(index);
 }
 
 template <class BaseModel,typename WeightType> template <class IteratorType>
 void ModelSpecifics<BaseModel,WeightType>::incrementNumeratorForGradientImpl(int index) {
 
-#ifdef CYCLOPS_DEBUG_TIMING
-#ifdef CYCLOPS_DEBUG_TIMING_LOW
-	auto start = bsccs::chrono::steady_clock::now();
-#endif
-#endif
-
 // #ifdef NEW_LOOPS
 
 // 	auto zeroRange = helper::getRangeNumerator(sparseIndices[index], N, typename IteratorType::tag());
@@ -1269,26 +1258,12 @@ using namespace std;
 
 // #endif // NEW_LOOPS
 
-
-#ifdef CYCLOPS_DEBUG_TIMING
-#ifdef CYCLOPS_DEBUG_TIMING_LOW
-	auto end = bsccs::chrono::steady_clock::now();
-	///////////////////////////"
-	auto name = "compNumGrad" + IteratorType::name + "   ";
-	duration[name] += bsccs::chrono::duration_cast<chrono::TimingUnits>(end - start).count();
-#endif
-#endif
-
 }
 
 template <class BaseModel,typename WeightType>
 void ModelSpecifics<BaseModel,WeightType>::updateXBeta(real realDelta, int index, bool useWeights) {
 
-#ifdef CYCLOPS_DEBUG_TIMING
-#ifndef CYCLOPS_DEBUG_TIMING_LOW
-	auto start = bsccs::chrono::steady_clock::now();
-#endif
-#endif
+	performance::ScopedCounter counter(performance::UPDATE_XBETA, modelData.getFormatType(index));
 
 	// Run-time dispatch to implementation depending on covariate FormatType
 	switch(modelData.getFormatType(index)) {
@@ -1308,29 +1283,19 @@ void ModelSpecifics<BaseModel,WeightType>::updateXBeta(real realDelta, int index
 			// throw error
 			//exit(-1);
 	}
-
-#ifdef CYCLOPS_DEBUG_TIMING
-#ifndef CYCLOPS_DEBUG_TIMING_LOW
-	auto end = bsccs::chrono::steady_clock::now();
-	///////////////////////////"
-	duration["updateXBeta      "] += bsccs::chrono::duration_cast<chrono::TimingUnits>(end - start).count();
-#endif
-#endif
-
 }
 
 template <class BaseModel,typename WeightType> template <class IteratorType>
 inline void ModelSpecifics<BaseModel,WeightType>::updateXBetaImpl(real realDelta, int index, bool useWeights) {
 
-#ifdef CYCLOPS_DEBUG_TIMING
-#ifdef CYCLOPS_DEBUG_TIMING_LOW
-	auto start = bsccs::chrono::steady_clock::now();
-#endif
-#endif
-
 // #ifdef NEW_LOOPS
 
 #if 1
+#ifdef CYCLOPS_POINTER_KERNELS
+	pointer::UpdateXBeta<BaseModel,IteratorType,real>()(
+			modelData, index, realDelta, begin(offsExpXBeta), begin(hXBeta),
+			begin(hY), hPid, begin(denomPid), begin(hOffs));
+#else
 	auto range = helper::getRangeX(modelData, index, typename IteratorType::tag());
 
 	auto kernel = UpdateXBetaKernel<BaseModel,IteratorType,real,int>(
@@ -1350,6 +1315,7 @@ inline void ModelSpecifics<BaseModel,WeightType>::updateXBetaImpl(real realDelta
 // 		RcppParallel() // TODO Currently *not* thread-safe
           SerialOnly()
 		);
+#endif
 
 #else
 
@@ -1375,7 +1341,7 @@ inline void ModelSpecifics<BaseModel,WeightType>::updateXBetaImpl(real realDelta
  		auto rangeKey = helper::dependent::getRangeKey(modelData, index, hPid,
 		        typename IteratorType::tag());
 
-		auto rangeDenominator = helper::dependent::getRangeDenominator(sparseIndices[index].get(), N,
+		auto rangeDenominator = helper::dependent::getRangeDenominator(getSparseIndices(index), N,
 		        denomPid, typename IteratorType::tag());
 
         auto kernel = TestUpdateXBetaKernelDependent<BaseModel,IteratorType,real>(realDelta);
@@ -1431,25 +1397,96 @@ inline void ModelSpecifics<BaseModel,WeightType>::updateXBetaImpl(real realDelta
 // #endif
 
 	computeAccumlatedDenominator(useWeights);
+}
 
-#ifdef CYCLOPS_DEBUG_TIMING
-#ifdef CYCLOPS_DEBUG_TIMING_LOW
-	auto end = bsccs::chrono::steady_clock::now();
-	///////////////////////////"
-	auto name = "updateXBeta" + IteratorType::name + "   ";
-	duration[name] += bsccs::chrono::duration_cast<chrono::TimingUnits>(end - start).count();
-#endif
-#endif
+template <class BaseModel,typename WeightType>
+void ModelSpecifics<BaseModel,WeightType>::sweep(const SweepRun& run, double* beta, double* bound,
+		bool useWeights) {
+
+	performance::ScopedCounter counter(performance::SWEEP, run.format, run.end - run.begin);
+
+	// Run-time dispatch once per run; everything below is resolved at compile time
+	switch (run.format) {
+		case INDICATOR :
+			dispatchSweep<IndicatorIterator>(run, beta, bound, useWeights);
+			break;
+		case SPARSE :
+			dispatchSweep<SparseIterator>(run, beta, bound, useWeights);
+			break;
+		case DENSE :
+			dispatchSweep<DenseIterator>(run, beta, bound, useWeights);
+			break;
+		case INTERCEPT :
+			dispatchSweep<InterceptIterator>(run, beta, bound, useWeights);
+			break;
+		default : break;
+			// throw error
+	}
+}
 
+template <class BaseModel,typename WeightType> template <class IteratorType>
+void ModelSpecifics<BaseModel,WeightType>::dispatchSweep(const SweepRun& run, double* beta,
+		double* bound, bool useWeights) {
+
+	switch (run.penalty.type) {
+		case priors::PenaltyType::NONE :
+			dispatchSweep<IteratorType>(run, priors::NoPenalty(), beta, bound, useWeights);
+			break;
+		case priors::PenaltyType::LAPLACE :
+			dispatchSweep<IteratorType>(run, priors::LaplacePenalty(run.penalty.parameter),
+				beta, bound, useWeights);
+			break;
+		case priors::PenaltyType::NORMAL :
+			dispatchSweep<IteratorType>(run, priors::NormalPenalty(run.penalty.parameter),
+				beta, bound, useWeights);
+			break;
+		default : break;
+			// Columns without a closed-form prior are updated one at a time by the caller
+	}
+}
+
+template <class BaseModel,typename WeightType> template <class IteratorType, class Prior>
+void ModelSpecifics<BaseModel,WeightType>::dispatchSweep(const SweepRun& run, const Prior& prior,
+		double* beta, double* bound, bool useWeights) {
+
+	if (useWeights) {
+		sweepImpl<IteratorType>(run, prior, beta, bound, useWeights, weighted);
+	} else {
+		sweepImpl<IteratorType>(run, prior, beta, bound, useWeights, unweighted);
+	}
+}
+
+template <class BaseModel,typename WeightType> template <class IteratorType, class Prior, class Weights>
+void ModelSpecifics<BaseModel,WeightType>::sweepImpl(const SweepRun& run, const Prior& prior,
+		double* beta, double* bound, bool useWeights, Weights w) {
+
+	for (int index = run.begin; index < run.end; ++index) {
+
+		if (BaseModel::cumulativeGradientAndHessian) { // Compile-time switch
+			computeNumeratorForGradientImpl<IteratorType>(index);
+		}
+
+		priors::GradientHessian gh;
+		computeGradientAndHessianImpl<IteratorType>(index, &gh.first, &gh.second, w);
+
+		if (gh.second < 0.0) {
+			gh.first = 0.0;
+			gh.second = 0.0;
+		}
+
+		const double delta = applyTrustRegion(prior.getDelta(gh, beta[index]), bound[index]);
+
+		if (delta != 0.0) {
+			beta[index] += delta;
+			updateXBetaImpl<IteratorType>(static_cast<real>(delta), index, useWeights);
+		}
+	}
 }
 
 template <class BaseModel,typename WeightType>
 void ModelSpecifics<BaseModel,WeightType>::computeRemainingStatistics(bool useWeights) {
 
-#ifdef CYCLOPS_DEBUG_TIMING
-	auto start = bsccs::chrono::steady_clock::now();
-#endif
-
+	performance::ScopedCounter counter(performance::COMPUTE_REMAINING_STATISTICS);
 
 	if (BaseModel::likelihoodHasDenominator) {
 		fillVector(denomPid.data(), N, BaseModel::getDenomNullValue());
@@ -1467,13 +1504,6 @@ void ModelSpecifics<BaseModel,WeightType>::computeRemainingStatistics(bool useWe
 		cerr << denomPid[i] << " " << accDenomPid[i] << " " << numerPid[i] << endl;
 	}
 #endif
-
-#ifdef CYCLOPS_DEBUG_TIMING
-	auto end = bsccs::chrono::steady_clock::now();
-	///////////////////////////"
-	duration["compRS           "] += bsccs::chrono::duration_cast<chrono::TimingUnits>(end - start).count();;
-#endif
-
 }
 
 template <class BaseModel,typename WeightType>
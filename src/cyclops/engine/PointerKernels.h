@@ -0,0 +1,250 @@
+/*
+ * PointerKernels.h
+ *
+ * Plain-pointer versions of the gradient / Hessian and X beta update kernels, as an
+ * alternative to the zip-iterator ranges in Ranges.h.  Each column is walked by entry
+ * with explicit gathers through its row indices, over restrict-qualified arrays, so the
+ * compiler sees simple loops instead of tuples of permutation iterators.  Entries are
+ * visited and accumulated in the same order as the range kernels, so results are
+ * identical.
+ *
+ * Selected at build time by defining CYCLOPS_POINTER_KERNELS.
+ */
+
+#ifndef POINTERKERNELS_H_
+#define POINTERKERNELS_H_
+
+#include <utility>
+
+#include "CompressedDataMatrix.h"
+
+namespace bsccs {
+
+namespace pointer {
+
+// Row and value of each entry in one column
+template <class IteratorType, class RealType>
+struct Column;
+
+template <class RealType>
+struct Column<IndicatorIterator, RealType> {
+	Column(const CompressedDataMatrix& mat, const int index)
+		: rows(mat.getCompressedColumnVector(index)),
+		  length(static_cast<int>(mat.getNumberOfEntries(index))) { }
+
+	inline int row(const int i) const { return rows[i]; }
+	inline OneValue x(const int i) const { return OneValue(); }
+
+	const int* __restrict rows;
+	const int length;
+};
+
+template <class RealType>
+struct Column<SparseIterator, RealType> {
+	Column(const CompressedDataMatrix& mat, const int index)
+		: rows(mat.getCompressedColumnVector(index)), data(mat.getDataVector(index)),
+		  length(static_cast<int>(mat.getNumberOfEntries(index))) { }
+
+	inline int row(const int i) const { return rows[i]; }
+	inline RealType x(const int i) const { return data[i]; }
+
+	const int* __restrict rows;
+	const RealType* __restrict data;
+	const int length;
+};
+
+template <class RealType>
+struct Column<DenseIterator, RealType> {
+	Column(const CompressedDataMatrix& mat, const int index)
+		: data(mat.getDataVector(index)),
+		  length(static_cast<int>(mat.getNumberOfRows())) { }
+
+	inline int row(const int i) const { return i; }
+	inline RealType x(const int i) const { return data[i]; }
+
+	const RealType* __restrict data;
+	const int length;
+};
+
+template <class RealType>
+struct Column<InterceptIterator, RealType> {
+	Column(const CompressedDataMatrix& mat, const int index)
+		: length(static_cast<int>(mat.getNumberOfRows())) { }
+
+	inline int row(const int i) const { return i; }
+	inline OneValue x(const int i) const { return OneValue(); }
+
+	const int length;
+};
+
+/**
+ * Gradient and Hessian over a column when each row is its own stratum; replaces
+ * helper::independent::getRangeX with TransformAndAccumulateGradientAndHessianKernelIndependent
+ */
+template <class BaseModel, class IteratorType, class WeightType, class RealType>
+struct GradientAndHessianIndependent : private BaseModel {
+
+	Fraction<RealType> operator()(const CompressedDataMatrix& mat, const int index,
+			const RealType* __restrict expXBeta, const RealType* __restrict xBeta,
+			const RealType* __restrict y, const RealType* __restrict denominator,
+			const RealType* __restrict weight) {
+
+		const Column<IteratorType, RealType> column(mat, index);
+		Fraction<RealType> result(0, 0);
+
+		for (int i = 0; i < column.length; ++i) {
+			const int k = column.row(i);
+			const auto x = column.x(i);
+
+			const RealType numerator = BaseModel::gradientNumeratorContrib(x, expXBeta[k], xBeta[k], y[k]);
+			const RealType numerator2 = (!IteratorType::isIndicator && BaseModel::hasTwoNumeratorTerms) ?
+					BaseModel::gradientNumerator2Contrib(x, expXBeta[k]) :
+					static_cast<RealType>(0);
+
+			result = BaseModel::template incrementGradientAndHessian<IteratorType, WeightType, RealType>(
+				result, numerator, numerator2, denominator[k], weight[k], xBeta[k], y[k]);
+		}
+		return result;
+	}
+};
+
+/**
+ * Gradient and Hessian over a column when rows are grouped into strata; replaces
+ * variants::trial::nested_reduce over helper::dependent::getRangeKey / getRangeX /
+ * getRangeGradient.  Numerators accumulate over the rows of a stratum and are folded into
+ * the gradient whenever the stratum changes.  Strata are visited in order: those in
+ * subset for sparse columns, or all N for dense columns (subset is nullptr).
+ */
+template <class BaseModel, class IteratorType, class WeightType, class RealType>
+struct GradientAndHessianDependent : private BaseModel {
+
+	Fraction<RealType> operator()(const CompressedDataMatrix& mat, const int index,
+			const int* __restrict pid, const RealType* __restrict expXBeta,
+			const std::vector<int>* subset,
+			const RealType* __restrict denominator, const RealType* __restrict weight) {
+
+		const Column<IteratorType, RealType> column(mat, index);
+		Fraction<RealType> result(0, 0);
+		if (column.length == 0) {
+			return result;
+		}
+
+		const int* __restrict outer = subset ? subset->data() : nullptr;
+		std::pair<RealType, RealType> numerator(0, 0);
+		int n = 0;
+
+		const int stop = column.length - 1;
+		for (int i = 0; i < stop; ++i) {
+			accumulate(numerator, column.x(i), expXBeta[column.row(i)]);
+
+			if (pid[column.row(i)] != pid[column.row(i + 1)]) {
+				const int g = outer ? outer[n] : n;
+				result = BaseModel::template incrementGradientAndHessian<IteratorType, WeightType, RealType>(
+					result, numerator.first, numerator.second, denominator[g], weight[g], 0.0, 0.0);
+				numerator = std::make_pair(static_cast<RealType>(0), static_cast<RealType>(0));
+				++n;
+			}
+		}
+
+		accumulate(numerator, column.x(stop), expXBeta[column.row(stop)]);
+		const int g = outer ? outer[n] : n;
+		return BaseModel::template incrementGradientAndHessian<IteratorType, WeightType, RealType>(
+			result, numerator.first, numerator.second, denominator[g], weight[g], 0.0, 0.0);
+	}
+
+private:
+	template <class XType>
+	inline void accumulate(std::pair<RealType, RealType>& numerator, const XType x,
+			const RealType expXBeta) {
+		numerator.first += BaseModel::gradientNumeratorContrib(x, expXBeta, 0.0, 0.0);
+		numerator.second = (!IteratorType::isIndicator && BaseModel::hasTwoNumeratorTerms) ?
+			numerator.second + BaseModel::gradientNumerator2Contrib(x, expXBeta) :
+			static_cast<RealType>(0);
+	}
+};
+
+/**
+ * As above, for sparse columns; replaces GroupedNumeratorKernel and GroupedGradientKernel.
+ * Numerators are scattered into their strata, then reduced over the strata the column
+ * touches: those in subset, or all N when subset is nullptr.  Numerators must be zero on
+ * entry and are left zero.
+ */
+template <class BaseModel, class IteratorType, class WeightType, class RealType>
+struct GradientAndHessianGrouped : private BaseModel {
+
+	Fraction<RealType> operator()(const CompressedDataMatrix& mat, const int index,
+			const int* __restrict pid, const RealType* __restrict expXBeta,
+			const std::vector<int>* subset, const int N,
+			RealType* __restrict numerator, RealType* __restrict numerator2,
+			const RealType* __restrict denominator, const RealType* __restrict weight) {
+
+		const bool twoTerms = !IteratorType::isIndicator && BaseModel::hasTwoNumeratorTerms;
+		const Column<IteratorType, RealType> column(mat, index);
+
+		for (int i = 0; i < column.length; ++i) {
+			const int k = column.row(i);
+			const int n = BaseModel::getGroup(pid, k);
+			const auto x = column.x(i);
+
+			numerator[n] += BaseModel::gradientNumeratorContrib(x, expXBeta[k], 0.0, 0.0);
+			if (twoTerms) {
+				numerator2[n] += BaseModel::gradientNumerator2Contrib(x, expXBeta[k]);
+			}
+		}
+
+		const int* __restrict strata = subset ? subset->data() : nullptr;
+		const int length = subset ? static_cast<int>(subset->size()) : N;
+
+		Fraction<RealType> result(0, 0);
+		for (int j = 0; j < length; ++j) {
+			const int n = strata ? strata[j] : j;
+
+			const RealType numerator1 = numerator[n];
+			numerator[n] = static_cast<RealType>(0);
+
+			RealType numerator2n = static_cast<RealType>(0);
+			if (twoTerms) {
+				numerator2n = numerator2[n];
+				numerator2[n] = static_cast<RealType>(0);
+			}
+
+			result = BaseModel::template incrementGradientAndHessian<IteratorType, WeightType, RealType>(
+				result, numerator1, numerator2n, denominator[n], weight[n], 0.0, 0.0);
+		}
+		return result;
+	}
+};
+
+/**
+ * X beta, exp(X beta) and denominator updates for a change of delta in one coefficient;
+ * replaces helper::getRangeX with UpdateXBetaKernel
+ */
+template <class BaseModel, class IteratorType, class RealType>
+struct UpdateXBeta : private BaseModel {
+
+	void operator()(const CompressedDataMatrix& mat, const int index, const RealType delta,
+			RealType* __restrict expXBeta, RealType* __restrict xBeta,
+			const RealType* __restrict y, const int* __restrict pid,
+			RealType* __restrict denominator, const RealType* __restrict offs) {
+
+		const Column<IteratorType, RealType> column(mat, index);
+
+		for (int i = 0; i < column.length; ++i) {
+			const int k = column.row(i);
+
+			xBeta[k] += delta * column.x(i);
+
+			if (BaseModel::likelihoodHasDenominator) { // Compile-time switch
+				const RealType oldEntry = expXBeta[k];
+				const RealType newEntry = expXBeta[k] = BaseModel::getOffsExpXBeta(offs, xBeta[k], y[k], k);
+				denominator[BaseModel::getGroup(pid, k)] += (newEntry - oldEntry);
+			}
+		}
+	}
+};
+
+} // namespace pointer
+
+} // namespace bsccs
+
+#endif /* POINTERKERNELS_H_ */
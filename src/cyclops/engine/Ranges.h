@@ -997,6 +997,40 @@ namespace dependent {
         };
     }
 
+	// Strata touched by a column, in order
+	template <class SubsetType, class IteratorType>
+    auto getRangeStrata(SubsetType* subset, const size_t N,
+                IteratorType) ->  // For indicator and sparse
+            boost::iterator_range<
+                decltype(std::begin(*subset))
+            > {
+        return { std::begin(*subset), std::end(*subset) };
+    }
+
+	template <class SubsetType> // For dense
+    auto getRangeStrata(SubsetType* subset, const size_t N,
+                DenseTag) ->
+            boost::iterator_range<
+                boost::counting_iterator<int>
+            > {
+        return {
+            boost::make_counting_iterator(0),
+            boost::make_counting_iterator(static_cast<int>(N))
+        };
+    }
+
+	template <class SubsetType> // For intercept
+    auto getRangeStrata(SubsetType* subset, const size_t N,
+                InterceptTag) ->
+            boost::iterator_range<
+                boost::counting_iterator<int>
+            > {
+        return {
+            boost::make_counting_iterator(0),
+            boost::make_counting_iterator(static_cast<int>(N))
+        };
+    }
+
 } // namespace dependent
 
 } // namespace helper
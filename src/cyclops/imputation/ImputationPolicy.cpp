@@ -187,7 +187,7 @@ void ImputationHelper::getMissingEntries(int col, vector<int>& missing){
 	missing = *missingEntries[col];
 }
 
-void ImputationHelper::getSampleMeanVariance(int col, real& Xmean, real& Xvar, real* dataVec, int* columnVec, FormatType formatType, int nRows, int nEntries){
+void ImputationHelper::getSampleMeanVariance(int col, real& Xmean, real& Xvar, const real* dataVec, const int* columnVec, FormatType formatType, int nRows, int nEntries){
 	real sumx2 = 0.0;
 	real sumx = 0.0;
 	int n = nRows - (int)missingEntries[col]->size();
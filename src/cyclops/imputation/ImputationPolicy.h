@@ -46,7 +46,7 @@ public:
 	int getOrigNumberOfColumns();
 	vector<real> getOrigYVector();
 	void getMissingEntries(int col, vector<int>& missing);
-	void getSampleMeanVariance(int col, real& Xmean, real& Xvar, real* dataVec, int* columnVec, FormatType formatType, int nRows, int nEntries);
+	void getSampleMeanVariance(int col, real& Xmean, real& Xvar, const real* dataVec, const int* columnVec, FormatType formatType, int nRows, int nEntries);
 protected:
 	vector<int> missingEntriesY;
 	int nMissingY;
@@ -80,7 +80,7 @@ public:
 	int getOrigNumberOfColumns() { return 0; }
 //	vector<real> getOrigYVector() {}
 	void getMissingEntries(int col, vector<int>& missing) {}
-	void getSampleMeanVariance(int col, real& Xmean, real& Xvar, real* dataVec, int* columnVec, FormatType formatType, int nRows, int nEntries) {}
+	void getSampleMeanVariance(int col, real& Xmean, real& Xvar, const real* dataVec, const int* columnVec, FormatType formatType, int nRows, int nEntries) {}
 };
 
 } // namespace
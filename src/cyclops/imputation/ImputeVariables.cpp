@@ -187,12 +187,12 @@ void ImputeVariables::imputeColumn(int col){
 void ImputeVariables::getColumnToImpute(int col, real* y){
 	int nRows = modelData->getNumberOfRows();
 	if(modelData->getFormatType(col) == DENSE){
-		real* dataVec = modelData->getDataVector(col);
+		const real* dataVec = modelData->getDataVector(col);
 		for(int i = 0; i < nRows; i++)
 			y[i] = dataVec[i];
 	}
 	else{
-		int* columnVec = modelData->getCompressedColumnVector(col);
+		const int* columnVec = modelData->getCompressedColumnVector(col);
 		for(int i = 0; i < modelData->getNumberOfEntries(col); i++)
 			y[columnVec[i]] = 1.0;
 	}
@@ -232,7 +232,7 @@ void ImputeVariables::randomizeImputationsLR(vector<real> yPred, vector<real> we
 		modelData->addToColumnVector(col,y);
 	}
 	else{
-		real* y = modelData->getDataVector(col);
+		std::vector<real>& y = modelData->getColumn(col).getDataVector();
 		for(int i = 0; i < modelData->getNumberOfRows(); i++){
 			if(weights[i]){
 				real r = (real)rand()/RAND_MAX;
@@ -243,6 +243,7 @@ void ImputeVariables::randomizeImputationsLR(vector<real> yPred, vector<real> we
 			}
 		}
 	}
+	modelData->touchX();
 }
 
 void ImputeVariables::randomizeImputationsLS(vector<real> yPred, vector<real> weights, int col){
@@ -256,8 +257,8 @@ void ImputeVariables::randomizeImputationsLS(vector<real> yPred, vector<real> we
 	vector<real> xVar;
 
 	for(int j = 0; j < col; j++){
-		real* dataVec;
-		int* columnVec;
+		const real* dataVec;
+		const int* columnVec;
 		int nEntries = 0;
 		FormatType formatType = modelData->getFormatType(j);
 		if(formatType == DENSE){
@@ -273,7 +274,7 @@ void ImputeVariables::randomizeImputationsLS(vector<real> yPred, vector<real> we
 		xVar.push_back(var);
 	}
 
-	real* y = modelData->getDataVector(col);
+	const real* y = modelData->getDataVector(col);
 
 	real sigma = 0.0;
 	for(int i = 0; i < nRows; i++){
@@ -299,6 +300,7 @@ void ImputeVariables::randomizeImputationsLS(vector<real> yPred, vector<real> we
 //			y[i] = yPred[i];
 		}
 	}
+	modelData->touchX();
 }
 
 void ImputeVariables::writeImputedData(int imputationNumber){
@@ -359,13 +361,13 @@ void ImputeVariables::excludeYVector(){
 	int colY = imputeHelper->getOrigNumberOfColumns()-1;
 	vector<real> y(modelData->getNumberOfRows(),0.0);
 	if(formatTypeY == DENSE){
-		real* y_real = modelData->getDataVector(colY);
+		const real* y_real = modelData->getDataVector(colY);
 		for(int i = 0; i < modelData->getNumberOfRows(); i++){
 			y[i] = y_real[i];
 		}
 	}
 	else{
-		int* y_int = modelData->getCompressedColumnVector(colY);
+		const int* y_int = modelData->getCompressedColumnVector(colY);
 		for(int i = 0; i < modelData->getNumberOfEntries(colY); i++){
 			y[y_int[i]] = 1.0;
 		}
@@ -0,0 +1,178 @@
+/*
+ * ArrowImport.cpp
+ *
+ * See ArrowImport.h for the expected table layout.
+ */
+
+#include <cstring>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "io/ArrowImport.h"
+
+namespace bsccs {
+
+namespace {
+
+struct ArrowColumn {
+	const ArrowSchema* schema;
+	const ArrowArray* array;
+	int64_t offset; // includes the parent struct offset
+	size_t length;
+
+	ArrowColumn() : schema(nullptr), array(nullptr), offset(0), length(0) { }
+
+	bool present() const { return array != nullptr; }
+
+	bool hasFormat(const char* format) const {
+		return std::strcmp(schema->format, format) == 0;
+	}
+
+	template <typename T>
+	const T* values() const {
+		return static_cast<const T*>(array->buffers[1]) + offset;
+	}
+};
+
+void throwError(loggers::ErrorHandler& error, const std::string& message) {
+	std::ostringstream stream;
+	stream << message;
+	error.throwError(stream);
+}
+
+void checkStruct(loggers::ErrorHandler& error, const ArrowSchema* schema, const ArrowArray* array) {
+	if (schema == nullptr || array == nullptr
+			|| schema->release == nullptr || array->release == nullptr) {
+		throwError(error, "Arrow array or schema is missing or already released");
+	}
+	if (std::strcmp(schema->format, "+s") != 0 || schema->n_children != array->n_children) {
+		throwError(error, "Arrow table must be a struct array");
+	}
+	if (array->null_count != 0 && array->n_buffers > 0 && array->buffers[0] != nullptr) {
+		throwError(error, "Arrow table must not contain null rows");
+	}
+}
+
+ArrowColumn findColumn(loggers::ErrorHandler& error, const ArrowSchema* schema, const ArrowArray* array,
+		const char* name, bool required) {
+	ArrowColumn column;
+	for (int64_t i = 0; i < schema->n_children; ++i) {
+		const ArrowSchema* child = schema->children[i];
+		if (child->name == nullptr || std::strcmp(child->name, name) != 0) {
+			continue;
+		}
+		column.schema = child;
+		column.array = array->children[i];
+		column.offset = array->offset + column.array->offset;
+		column.length = static_cast<size_t>(array->length);
+
+		if (child->dictionary != nullptr || column.array->n_buffers != 2
+				|| column.array->length < array->offset + array->length) {
+			std::ostringstream stream;
+			stream << "Arrow column " << name << " must be a flat primitive array";
+			error.throwError(stream);
+		}
+		if (column.array->null_count != 0 && column.array->buffers[0] != nullptr) {
+			std::ostringstream stream;
+			stream << "Arrow column " << name << " must not contain nulls";
+			error.throwError(stream);
+		}
+		return column;
+	}
+	if (required) {
+		std::ostringstream stream;
+		stream << "Arrow table is missing column " << name;
+		error.throwError(stream);
+	}
+	return column;
+}
+
+template <typename Target>
+void widen(loggers::ErrorHandler& error, const ArrowColumn& column, const char* name,
+		std::vector<Target>& out) {
+	out.resize(column.length);
+	if (column.hasFormat("l")) {
+		std::copy(column.values<int64_t>(), column.values<int64_t>() + column.length, out.begin());
+	} else if (column.hasFormat("i")) {
+		std::copy(column.values<int32_t>(), column.values<int32_t>() + column.length, out.begin());
+	} else if (column.hasFormat("g")) {
+		std::copy(column.values<double>(), column.values<double>() + column.length, out.begin());
+	} else if (column.hasFormat("f")) {
+		std::copy(column.values<float>(), column.values<float>() + column.length, out.begin());
+	} else {
+		std::ostringstream stream;
+		stream << "Unsupported Arrow format '" << column.schema->format
+		       << "' for column " << name;
+		error.throwError(stream);
+	}
+}
+
+// Borrow the buffer when it already has the target layout, otherwise widen into scratch
+template <typename Target>
+const Target* view(loggers::ErrorHandler& error, const ArrowColumn& column, const char* name,
+		const char* format, std::vector<Target>& scratch) {
+	if (!column.present()) {
+		return nullptr;
+	}
+	if (column.hasFormat(format)) {
+		return column.values<Target>();
+	}
+	widen(error, column, name, scratch);
+	return scratch.data();
+}
+
+} // namespace
+
+void ArrowImport::loadOutcomes(ModelData& modelData,
+		const ArrowSchema* schema, const ArrowArray* array) {
+
+	loggers::ErrorHandler& error = *modelData.error;
+	checkStruct(error, schema, array);
+
+	const ArrowColumn stratumId = findColumn(error, schema, array, "stratumId", false);
+	const ArrowColumn rowId = findColumn(error, schema, array, "rowId", true);
+	const ArrowColumn y = findColumn(error, schema, array, "y", true);
+	const ArrowColumn time = findColumn(error, schema, array, "time", false);
+
+	std::vector<IdType> oStratumId;
+	std::vector<IdType> oRowId;
+	std::vector<double> oY;
+	std::vector<double> oTime;
+
+	if (stratumId.present()) {
+		widen(error, stratumId, "stratumId", oStratumId);
+	}
+	widen(error, rowId, "rowId", oRowId);
+	widen(error, y, "y", oY);
+	if (time.present()) {
+		widen(error, time, "time", oTime);
+	}
+
+	modelData.loadY(oStratumId, oRowId, oY, oTime);
+}
+
+int ArrowImport::loadCovariates(ModelData& modelData,
+		const ArrowSchema* schema, const ArrowArray* array,
+		bool append, bool forceSparse, int nThreads) {
+
+	loggers::ErrorHandler& error = *modelData.error;
+	checkStruct(error, schema, array);
+
+	const ArrowColumn covariateId = findColumn(error, schema, array, "covariateId", true);
+	const ArrowColumn rowId = findColumn(error, schema, array, "rowId", true);
+	const ArrowColumn covariateValue = findColumn(error, schema, array, "covariateValue", false);
+
+	std::vector<int64_t> covariateIdScratch;
+	std::vector<int64_t> rowIdScratch;
+	std::vector<double> covariateValueScratch;
+
+	return modelData.loadMultipleX(
+		view(error, covariateId, "covariateId", "l", covariateIdScratch),
+		view(error, rowId, "rowId", "l", rowIdScratch),
+		view(error, covariateValue, "covariateValue", "g", covariateValueScratch),
+		static_cast<size_t>(array->length),
+		append, forceSparse, nThreads);
+}
+
+} // namespace
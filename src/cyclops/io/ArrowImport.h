@@ -0,0 +1,80 @@
+/*
+ * ArrowImport.h
+ *
+ * Load outcome and covariate tables handed over through the Arrow C Data Interface
+ * (https://arrow.apache.org/docs/format/CDataInterface.html).  Each table is a struct
+ * array whose children are matched by name:
+ *
+ *   outcomes   : stratumId (optional), rowId, y, time (optional)
+ *   covariates : covariateId, rowId, covariateValue (optional; absent -> indicators)
+ *
+ * Covariates must be sorted by covariateId, as for ModelData::loadMultipleX.  int64 /
+ * float64 buffers without nulls are read in place; int32 / float32 children are widened
+ * once.  The importer only borrows the arrays: the producer's release callbacks are
+ * never invoked here and remain the caller's responsibility.
+ */
+
+#ifndef ARROWIMPORT_H_
+#define ARROWIMPORT_H_
+
+#include <cstdint>
+
+#include "ModelData.h"
+
+#ifndef ARROW_C_DATA_INTERFACE
+#define ARROW_C_DATA_INTERFACE
+
+#define ARROW_FLAG_DICTIONARY_ORDERED 1
+#define ARROW_FLAG_NULLABLE 2
+#define ARROW_FLAG_MAP_KEYS_SORTED 4
+
+extern "C" {
+
+struct ArrowSchema {
+	const char* format;
+	const char* name;
+	const char* metadata;
+	int64_t flags;
+	int64_t n_children;
+	struct ArrowSchema** children;
+	struct ArrowSchema* dictionary;
+	void (*release)(struct ArrowSchema*);
+	void* private_data;
+};
+
+struct ArrowArray {
+	int64_t length;
+	int64_t null_count;
+	int64_t offset;
+	int64_t n_buffers;
+	int64_t n_children;
+	const void** buffers;
+	struct ArrowArray** children;
+	struct ArrowArray* dictionary;
+	void (*release)(struct ArrowArray*);
+	void* private_data;
+};
+
+} // extern "C"
+
+#endif /* ARROW_C_DATA_INTERFACE */
+
+namespace bsccs {
+
+class ArrowImport {
+public:
+
+	static void loadOutcomes(ModelData& modelData,
+		const ArrowSchema* schema, const ArrowArray* array);
+
+	/**
+	 * Returns the index of the first loaded column, as ModelData::loadMultipleX
+	 */
+	static int loadCovariates(ModelData& modelData,
+		const ArrowSchema* schema, const ArrowArray* array,
+		bool append, bool forceSparse, int nThreads = 1);
+};
+
+} // namespace
+
+#endif /* ARROWIMPORT_H_ */
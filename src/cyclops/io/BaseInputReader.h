@@ -9,10 +9,18 @@
 #define GENERICSPARSEREADER_H_
 
 #include <vector>
+#include <cstdlib>
+#include <algorithm>
+#include <exception>
+#include <stdexcept>
+
+#include "boost/iterator/counting_iterator.hpp"
 
 #include "InputReader.h"
 #include "SparseIndexer.h"
 #include "io/ProgressLogger.h"
+#include "io/MappedFile.h"
+#include "Thread.h"
  
 #define MAX_ENTRIES		1000000000
 #define MISSING_STRING	"NA"
@@ -103,15 +111,40 @@ public:
 
 			static_cast<DerivedFormat*>(this)->addFixedCovariateColumns();
 
-			while (getline(in, line) && (rowInfo.currentRow < MAX_ENTRIES)) {
-				if (!line.empty()) {
-					stringstream ss(line.c_str()); // Tokenize
-					static_cast<DerivedFormat*>(this)->parseRow(ss, rowInfo);
-					rowInfo.currentRow++;
+			const int threads = (nThreads == -1) ? bsccs::thread::hardware_concurrency() : nThreads;
+			const std::streamoff bodyStart = in.good() ? static_cast<std::streamoff>(in.tellg()) : -1;
+
+			if (threads > 1 && bodyStart >= 0) {
+				in.close();
+				parseInParallel(fileName, bodyStart, threads, rowInfo);
+			} else {
+				// Row errors unwind to here, to be reported with their line number
+				const loggers::ErrorHandlerPtr reportTo = error;
+				error = bsccs::make_shared<loggers::ThrowingErrorHandler>();
+				size_t bodyLine = 0;
+				while (getline(in, line) && (rowInfo.currentRow < MAX_ENTRIES)) {
+					++bodyLine;
+					if (!line.empty()) {
+						stringstream ss(line.c_str()); // Tokenize
+						try {
+							static_cast<DerivedFormat*>(this)->parseRow(ss, rowInfo);
+						} catch (const std::exception& e) {
+							error = reportTo;
+							throw std::runtime_error(atLine(
+								countLines(fileName, bodyStart) + bodyLine, e.what()));
+						}
+						rowInfo.currentRow++;
+					}
 				}
+				error = reportTo;
 			}
 			addEventEntry(rowInfo.numEvents); // Save last patient
 
+		} catch (const std::exception& e) {
+			std::ostringstream stream;
+			stream << "Exception while trying to read " << fileName << ": " << e.what();
+			in.close();
+			error->throwError(stream);
 		} catch (...) {
 			std::ostringstream stream;
 			stream << "Exception while trying to read " << fileName;
@@ -137,6 +170,212 @@ public:
 	}	 
 	
 protected:
+	/**
+	 * Memory-map the file body and split it into newline-aligned chunks.  Each chunk is
+	 * parsed by a copy of this reader into its own ModelData fragment; fragments are then
+	 * appended in file order, so the result matches a sequential read.  A chunk stops at its
+	 * first error, and the earliest error in the file is rethrown with its line number.
+	 */
+	void parseInParallel(const char* fileName, const std::streamoff bodyStart, const int threads,
+			RowInformation& rowInfo) {
+
+		MappedFile file(fileName);
+		const char* end = file.begin + file.length;
+		const char* begin = file.begin + std::min(static_cast<size_t>(bodyStart), file.length);
+
+		std::vector<const char*> bounds(1, begin);
+		for (int i = 1; i < threads; ++i) {
+			const char* split = std::max(begin + (end - begin) * i / threads, bounds.back());
+			const char* newline = static_cast<const char*>(std::memchr(split, '\n', end - split));
+			bounds.push_back(newline ? newline + 1 : end);
+		}
+		bounds.push_back(end);
+
+		const size_t nChunks = bounds.size() - 1;
+		const size_t nFixedColumns = modelData->getNumberOfColumns();
+
+		std::vector<bsccs::unique_ptr<ModelData> > fragments(nChunks);
+		std::vector<bsccs::unique_ptr<RowInformation> > fragmentRows(nChunks);
+		std::vector<string> firstPids(nChunks, MISSING_STRING);
+		std::vector<std::exception_ptr> failures(nChunks);
+		std::vector<const char*> failedLines(nChunks, nullptr);
+		const loggers::ErrorHandlerPtr chunkError = bsccs::make_shared<loggers::ThrowingErrorHandler>();
+
+		auto parseChunk = [&](size_t chunk) {
+			const char* position = bounds[chunk];
+			try {
+				DerivedFormat reader(*static_cast<DerivedFormat*>(this)); // Same grammar settings
+				reader.error = chunkError;
+				fragments[chunk] = bsccs::make_unique<ModelData>(modelData->modelType, logger, chunkError);
+				reader.modelData = fragments[chunk].get();
+				reader.deleteModelData = false;
+				reader.addFixedCovariateColumns();
+
+				fragmentRows[chunk] = bsccs::make_unique<RowInformation>(0, 0, 0,
+					MISSING_STRING, MISSING_STRING, *reader.modelData);
+				RowInformation& info = *fragmentRows[chunk];
+
+				string line;
+				const char* chunkEnd = bounds[chunk + 1];
+				while (position < chunkEnd) {
+					const char* newline = static_cast<const char*>(
+						std::memchr(position, '\n', chunkEnd - position));
+					const char* lineEnd = newline ? newline : chunkEnd;
+					if (lineEnd != position) {
+						line.assign(position, lineEnd);
+						stringstream ss(line); // Tokenize
+						reader.parseRow(ss, info);
+						if (info.currentRow == 0) {
+							firstPids[chunk] = info.currentPid;
+						}
+						info.currentRow++;
+					}
+					position = lineEnd + 1;
+				}
+			} catch (...) {
+				failures[chunk] = std::current_exception();
+				failedLines[chunk] = position;
+			}
+		};
+
+		logger->setConcurrent(true);
+		TaskScheduler<boost::counting_iterator<size_t> >(
+			boost::make_counting_iterator(static_cast<size_t>(0)),
+			boost::make_counting_iterator(nChunks),
+			threads).execute(parseChunk);
+		logger->setConcurrent(false);
+		logger->flush();
+
+		for (size_t chunk = 0; chunk < nChunks; ++chunk) {
+			if (failures[chunk]) {
+				const size_t line = 1 + std::count(file.begin, failedLines[chunk], '\n');
+				try {
+					std::rethrow_exception(failures[chunk]);
+				} catch (const std::exception& e) {
+					throw std::runtime_error(atLine(line, e.what()));
+				} catch (...) {
+					throw std::runtime_error(atLine(line, "unknown error"));
+				}
+			}
+		}
+
+		for (size_t chunk = 0; chunk < nChunks; ++chunk) {
+			appendFragment(*fragments[chunk], *fragmentRows[chunk], firstPids[chunk],
+				nFixedColumns, rowInfo);
+			fragments[chunk].reset();
+		}
+	}
+
+	static string atLine(const size_t line, const string& what) {
+		std::ostringstream stream;
+		stream << "line " << line << ": " << what;
+		return stream.str();
+	}
+
+	// Number of lines in the first length bytes of a file; only needed when reporting errors
+	static size_t countLines(const char* fileName, const std::streamoff length) {
+		ifstream in(fileName, std::ios::in | std::ios::binary);
+		size_t lines = 0;
+		char c;
+		for (std::streamoff i = 0; i < length && in.get(c); ++i) {
+			if (c == '\n') {
+				++lines;
+			}
+		}
+		return lines;
+	}
+
+	void appendFragment(const ModelData& fragment, const RowInformation& fragmentRow,
+			const string& firstPid, const size_t nFixedColumns, RowInformation& rowInfo) {
+
+		if (fragmentRow.outcomeId != MISSING_STRING) {
+			if (rowInfo.outcomeId == MISSING_STRING) {
+				rowInfo.outcomeId = fragmentRow.outcomeId;
+			} else if (fragmentRow.outcomeId != rowInfo.outcomeId) {
+				std::ostringstream stream;
+				stream << "More than one condition ID in input file";
+				error->throwError(stream);
+			}
+		}
+
+		// A stratum may continue across the chunk boundary
+		const bool stratified = (firstPid != MISSING_STRING);
+		const bool continued = stratified && (firstPid == rowInfo.currentPid);
+		const int caseOffset = rowInfo.numCases - (continued ? 1 : 0);
+
+		for (auto it = fragment.pid.begin(); it != fragment.pid.end(); ++it) {
+			modelData->pid.push_back(*it + caseOffset);
+		}
+
+		if (stratified) {
+			std::vector<int> events(fragment.nevents.begin(), fragment.nevents.end());
+			events.push_back(fragmentRow.numEvents); // Last stratum is still open
+			bool open = (rowInfo.currentPid != MISSING_STRING);
+			for (size_t i = 0; i < events.size(); ++i) {
+				if (i == 0 && continued) {
+					rowInfo.numEvents += events[i];
+				} else {
+					if (open) {
+						addEventEntry(rowInfo.numEvents);
+					}
+					rowInfo.numEvents = events[i];
+					open = true;
+				}
+			}
+			rowInfo.currentPid = fragmentRow.currentPid;
+		} else {
+			modelData->nevents.insert(modelData->nevents.end(),
+				fragment.nevents.begin(), fragment.nevents.end());
+			rowInfo.numEvents += fragmentRow.numEvents;
+		}
+		rowInfo.numCases = caseOffset + fragmentRow.numCases;
+
+		modelData->y.insert(modelData->y.end(), fragment.y.begin(), fragment.y.end());
+		modelData->z.insert(modelData->z.end(), fragment.z.begin(), fragment.z.end());
+		modelData->offs.insert(modelData->offs.end(), fragment.offs.begin(), fragment.offs.end());
+		modelData->labels.insert(modelData->labels.end(),
+			fragment.labels.begin(), fragment.labels.end());
+
+		// Fixed columns share positions; all others are matched by covariate id
+		const int rowOffset = rowInfo.currentRow;
+		for (size_t j = 0; j < fragment.getNumberOfColumns(); ++j) {
+			const CompressedDataColumn& source = fragment.getColumn(j);
+			const FormatType format = source.getFormatType();
+
+			if (j < nFixedColumns) {
+				appendColumn(source, rowOffset, modelData->getColumn(j));
+			} else {
+				const IdType covariate = source.getNumericalLabel();
+				if (!rowInfo.indexer.hasColumn(covariate)) {
+					rowInfo.indexer.addColumn(covariate, format);
+				}
+				CompressedDataColumn& target = rowInfo.indexer.getColumn(covariate);
+				if (format == SPARSE && target.getFormatType() == INDICATOR) {
+					target.convertColumnToSparse();
+				}
+				appendColumn(source, rowOffset, target);
+			}
+		}
+		rowInfo.currentRow += fragmentRow.currentRow;
+	}
+
+	void appendColumn(const CompressedDataColumn& source, const int rowOffset,
+			CompressedDataColumn& target) {
+		const FormatType format = source.getFormatType();
+		if (format == DENSE) {
+			const std::vector<real>& data = source.getDataVector();
+			for (size_t k = 0; k < data.size(); ++k) {
+				target.add_data(rowOffset + k, data[k]);
+			}
+		} else if (format == SPARSE || format == INDICATOR) {
+			const std::vector<int>& rows = source.getColumnsVector();
+			for (size_t i = 0; i < rows.size(); ++i) {
+				target.add_data(rowOffset + rows[i],
+					format == SPARSE ? source.getDataVector()[i] : static_cast<real>(1));
+			}
+		}
+	}
+
 	void parseHeader(ifstream& in) {
 		string line;
 		getline(in, line); // Read header
@@ -153,13 +392,29 @@ protected:
 			rowInfo.scratch.clear();
 			IdType drug;
 			real value;
+			const char* begin = entry.c_str();
+			char* end = nullptr;
+			drug = std::strtoll(begin, &end, 10);
+			bool valid = end != begin;
 			if (indicatorOnly) {
-				drug = atoi(entry.c_str());
 				value = static_cast<real>(1);
-			} else {
-				split(rowInfo.scratch, entry, getInnerDelimitor());
-				drug = atoi(rowInfo.scratch[0].c_str());
-				value = atof(rowInfo.scratch[1].c_str());
+				valid = valid && *end == '\0';
+			} else { // Parse "id:value" in place
+				const size_t delimitor = entry.find_first_of(getInnerDelimitor());
+				if (delimitor == string::npos) {
+					value = static_cast<real>(0);
+					valid = valid && *end == '\0';
+				} else {
+					valid = valid && end == begin + delimitor;
+					const char* valueBegin = begin + delimitor + 1;
+					value = std::strtod(valueBegin, &end);
+					valid = valid && end != valueBegin && *end == '\0';
+				}
+			}
+			if (!valid) {
+				std::ostringstream stream;
+				stream << "Unable to parse covariate entry '" << entry << "'";
+				error->throwError(stream);
 			}
 			if (!rowInfo.indexer.hasColumn(drug)) {
 				// Add new column
@@ -0,0 +1,582 @@
+/*
+ * BinaryModelData.cpp
+ *
+ *  Binary snapshot of ModelData
+ */
+
+#include <cstring>
+#include <cstdint>
+#include <fstream>
+#include <sstream>
+#include <list>
+
+#include "io/BinaryModelData.h"
+#include "io/MappedFile.h"
+#include "Thread.h"
+
+namespace bsccs {
+
+namespace {
+
+const char magic[8] = { 'C', 'Y', 'C', 'L', 'O', 'P', 'S', 'B' };
+const uint32_t byteOrderMark = 0x01020304;
+const size_t alignment = 8;
+
+enum Flags {
+	HAS_OFFSET_COVARIATE = 1,
+	HAS_INTERCEPT_COVARIATE = 2,
+	IS_FINALIZED = 4
+};
+
+class BinaryWriter {
+public:
+	BinaryWriter(const std::string& fileName)
+		: stream(fileName.c_str(), std::ios::out | std::ios::binary), position(0) { }
+
+	bool good() const { return stream.good(); }
+
+	template <typename T>
+	void value(const T& x) {
+		bytes(&x, sizeof(T));
+	}
+
+	void string(const std::string& s) {
+		value<uint64_t>(s.size());
+		bytes(s.data(), s.size());
+	}
+
+	template <typename T>
+	void vector(const std::vector<T>& v) {
+		value<uint64_t>(v.size());
+		pad();
+		bytes(v.data(), v.size() * sizeof(T));
+	}
+
+private:
+	void bytes(const void* data, size_t length) {
+		stream.write(static_cast<const char*>(data), length);
+		position += length;
+	}
+
+	void pad() {
+		static const char zeros[alignment] = { 0 };
+		const size_t extra = position % alignment;
+		if (extra != 0) {
+			bytes(zeros, alignment - extra);
+		}
+	}
+
+	std::ofstream stream;
+	size_t position;
+};
+
+/**
+ * Bounds-checked reads from a mapped image; a read past the end of the file, or a length
+ * that cannot fit in what remains, is reported through error
+ */
+class BinaryReader {
+public:
+	BinaryReader(const MappedFile& file, const std::string& fileName,
+			loggers::ErrorHandlerPtr error)
+		: file(file), fileName(fileName), error(error), position(0) { }
+
+	template <typename T>
+	T value() {
+		T x = T();
+		bytes(&x, sizeof(T));
+		return x;
+	}
+
+	std::string string() {
+		const uint64_t length = value<uint64_t>();
+		check<char>(length);
+		std::string s(file.begin + position, length);
+		position += length;
+		return s;
+	}
+
+	template <typename T>
+	void vector(std::vector<T>& v) {
+		const uint64_t length = value<uint64_t>();
+		pad();
+		check<T>(length);
+		const T* begin = reinterpret_cast<const T*>(file.begin + position);
+		v.assign(begin, begin + length);
+		position += length * sizeof(T);
+	}
+
+	// Skip over a vector, returning where its elements start
+	template <typename T>
+	size_t extent(uint64_t& length) {
+		length = value<uint64_t>();
+		pad();
+		check<T>(length);
+		const size_t start = position;
+		position += length * sizeof(T);
+		return start;
+	}
+
+	void bytes(void* data, size_t length) {
+		check<char>(length);
+		std::memcpy(data, file.begin + position, length);
+		position += length;
+	}
+
+	size_t remaining() const {
+		return position < file.length ? file.length - position : 0;
+	}
+
+	void corrupt(const std::string& what) const {
+		std::ostringstream stream;
+		stream << fileName << " is truncated or corrupt: " << what
+			   << " at byte " << position;
+		error->throwError(stream);
+	}
+
+private:
+	// Compare element counts, not byte counts, so that length * sizeof(T) cannot overflow
+	template <typename T>
+	void check(uint64_t length) const {
+		if (length > remaining() / sizeof(T)) {
+			std::ostringstream what;
+			what << length << " elements of " << sizeof(T) << " bytes exceed the "
+				 << remaining() << " bytes remaining";
+			corrupt(what.str());
+		}
+	}
+
+	void pad() {
+		const size_t extra = position % alignment;
+		if (extra != 0) {
+			position += alignment - extra;
+		}
+	}
+
+	const MappedFile& file;
+	const std::string& fileName;
+	loggers::ErrorHandlerPtr error;
+	size_t position;
+};
+
+/**
+ * Pages column buffers in from a mapped binary image, releasing the least recently
+ * used unpinned columns, with anything attached to them, once more than residentBytes
+ * are held
+ */
+class MappedColumnPager : public ColumnPager {
+public:
+	MappedColumnPager(bsccs::unique_ptr<MappedFile> mappedFile, size_t residentBytes, size_t readAhead)
+		: file(std::move(mappedFile)), budget(residentBytes), readAhead(readAhead), resident(0) { }
+
+	virtual ~MappedColumnPager() { }
+
+	void add(CompressedDataColumn& column,
+			size_t rowsOffset, size_t nRows, size_t dataOffset, size_t nData) {
+		Entry entry;
+		entry.column = &column;
+		entry.rowsOffset = rowsOffset;
+		entry.nRows = nRows;
+		entry.dataOffset = dataOffset;
+		entry.nData = nData;
+		entries.insert(std::make_pair(&column, entry));
+	}
+
+	virtual void load(const CompressedDataColumn& column) {
+		std::lock_guard<bsccs::mutex> guard(lock);
+		auto it = entries.find(&column);
+		if (it != entries.end()) {
+			makeResident(it->second);
+		}
+	}
+
+	virtual void pin(const CompressedDataColumn& column) {
+		std::lock_guard<bsccs::mutex> guard(lock);
+		auto it = entries.find(&column);
+		if (it != entries.end()) {
+			++it->second.pins;
+			makeResident(it->second);
+		}
+	}
+
+	virtual void unpin(const CompressedDataColumn& column) {
+		std::lock_guard<bsccs::mutex> guard(lock);
+		auto it = entries.find(&column);
+		if (it != entries.end() && it->second.pins > 0) {
+			--it->second.pins;
+		}
+	}
+
+	virtual void prefetch(const CompressedDataColumn& column) {
+		std::lock_guard<bsccs::mutex> guard(lock);
+		auto it = entries.find(&column);
+		if (it != entries.end() && !it->second.resident) {
+			const Entry& entry = it->second;
+			file->advise(entry.rowsOffset, entry.nRows * sizeof(int), true);
+			file->advise(entry.dataOffset, entry.nData * sizeof(real), true);
+		}
+	}
+
+	virtual void forget(const CompressedDataColumn& column) {
+		std::lock_guard<bsccs::mutex> guard(lock);
+		auto it = entries.find(&column);
+		if (it != entries.end()) {
+			if (it->second.resident) {
+				lru.erase(it->second.position);
+				resident -= it->second.bytes() + it->second.attachedBytes;
+			}
+			entries.erase(it);
+		}
+	}
+
+	virtual void attach(const CompressedDataColumn& column, uint64_t owner,
+			IntVectorPtr storage) {
+		std::lock_guard<bsccs::mutex> guard(lock);
+		auto it = entries.find(&column);
+		if (it == entries.end() || !it->second.resident) {
+			return; // Derived from storage that is no longer held
+		}
+		Entry& entry = it->second;
+		const size_t bytes = memory::bytes(*storage);
+		entry.attached.push_back(std::make_pair(owner, storage));
+		entry.attachedBytes += bytes;
+		resident += bytes;
+		release(0, &entry);
+	}
+
+	virtual IntVectorPtr getAttached(const CompressedDataColumn& column, uint64_t owner) const {
+		std::lock_guard<bsccs::mutex> guard(lock);
+		auto it = entries.find(&column);
+		if (it != entries.end()) {
+			for (const auto& attached : it->second.attached) {
+				if (attached.first == owner) {
+					return attached.second;
+				}
+			}
+		}
+		return IntVectorPtr();
+	}
+
+	virtual void detach(uint64_t owner) {
+		std::lock_guard<bsccs::mutex> guard(lock);
+		for (auto& item : entries) {
+			Entry& entry = item.second;
+			for (auto it = entry.attached.begin(); it != entry.attached.end(); ) {
+				if (it->first == owner) {
+					const size_t bytes = memory::bytes(*it->second);
+					entry.attachedBytes -= bytes;
+					resident -= bytes;
+					it = entry.attached.erase(it);
+				} else {
+					++it;
+				}
+			}
+		}
+	}
+
+	virtual size_t getReadAhead() const {
+		return readAhead;
+	}
+
+	virtual size_t getResidentBytes() const {
+		std::lock_guard<bsccs::mutex> guard(lock);
+		return resident;
+	}
+
+private:
+	typedef std::list<const CompressedDataColumn*> ResidentList;
+
+	struct Entry {
+		CompressedDataColumn* column;
+		size_t rowsOffset;
+		size_t nRows;
+		size_t dataOffset;
+		size_t nData;
+		int pins;
+		bool resident;
+		ResidentList::iterator position;
+		std::vector<std::pair<uint64_t, IntVectorPtr>> attached; // by owner
+		size_t attachedBytes;
+
+		Entry() : column(nullptr), rowsOffset(0), nRows(0), dataOffset(0), nData(0),
+			pins(0), resident(false), attachedBytes(0) { }
+
+		size_t bytes() const {
+			return nRows * sizeof(int) + nData * sizeof(real);
+		}
+	};
+
+	void makeResident(Entry& entry) {
+		if (entry.resident) {
+			lru.splice(lru.end(), lru, entry.position); // Most recently used
+			return;
+		}
+
+		release(entry.bytes());
+
+		if (entry.nRows > 0) {
+			const int* rows = reinterpret_cast<const int*>(file->begin + entry.rowsOffset);
+			entry.column->getColumnsVector().assign(rows, rows + entry.nRows);
+			file->advise(entry.rowsOffset, entry.nRows * sizeof(int), false);
+		}
+		if (entry.nData > 0) {
+			const real* data = reinterpret_cast<const real*>(file->begin + entry.dataOffset);
+			entry.column->getDataVector().assign(data, data + entry.nData);
+			file->advise(entry.dataOffset, entry.nData * sizeof(real), false);
+		}
+
+		entry.resident = true;
+		entry.position = lru.insert(lru.end(), entry.column);
+		resident += entry.bytes();
+	}
+
+	void release(size_t needed, const Entry* keep = nullptr) {
+		auto it = lru.begin();
+		while (resident + needed > budget && it != lru.end()) {
+			Entry& entry = entries[*it];
+			if (entry.pins > 0 || &entry == keep) {
+				++it;
+				continue;
+			}
+			const FormatType format = entry.column->getFormatType();
+			if (format == SPARSE || format == INDICATOR) {
+				std::vector<int>().swap(entry.column->getColumnsVector());
+			}
+			if (format == SPARSE || format == DENSE) {
+				std::vector<real>().swap(entry.column->getDataVector());
+			}
+			entry.attached.clear();
+			entry.resident = false;
+			resident -= entry.bytes() + entry.attachedBytes;
+			entry.attachedBytes = 0;
+			it = lru.erase(it);
+		}
+	}
+
+	bsccs::unique_ptr<MappedFile> file;
+	const size_t budget;
+	const size_t readAhead;
+	size_t resident;
+
+	bsccs::unordered_map<const CompressedDataColumn*, Entry> entries;
+	ResidentList lru;
+	mutable bsccs::mutex lock;
+};
+
+} // namespace
+
+const unsigned int BinaryModelData::version;
+
+void BinaryModelData::write(const ModelData& modelData, const std::string& fileName) {
+
+	BinaryWriter out(fileName);
+	if (!out.good()) {
+		std::ostringstream stream;
+		stream << "Unable to open " << fileName << " for writing";
+		modelData.error->throwError(stream);
+	}
+
+	out.value(magic);
+	out.value<uint32_t>(version);
+	out.value<uint32_t>(byteOrderMark);
+	out.value<uint32_t>(sizeof(real));
+
+	const uint32_t flags =
+		(modelData.hasOffsetCovariate ? HAS_OFFSET_COVARIATE : 0) |
+		(modelData.hasInterceptCovariate ? HAS_INTERCEPT_COVARIATE : 0) |
+		(modelData.isFinalized ? IS_FINALIZED : 0);
+
+	out.value<int32_t>(static_cast<int32_t>(modelData.modelType));
+	out.value<uint32_t>(flags);
+	out.value<int32_t>(modelData.nTypes);
+	out.value<uint64_t>(modelData.getNumberOfRows());
+	out.value<int64_t>(modelData.getNumberOfPatients());
+	out.string(modelData.conditionId);
+
+	out.vector(modelData.pid);
+	out.vector(modelData.y);
+	out.vector(modelData.z);
+	out.vector(modelData.offs);
+
+	out.value<uint64_t>(modelData.labels.size());
+	for (auto it = modelData.labels.begin(); it != modelData.labels.end(); ++it) {
+		out.string(*it);
+	}
+
+	const size_t nColumns = modelData.getNumberOfColumns();
+	const auto shared = modelData.getSharedColumnMap();
+	const std::vector<int> noIndices;
+	const std::vector<real> noData;
+
+	out.value<uint64_t>(nColumns);
+	for (size_t j = 0; j < nColumns; ++j) {
+		const CompressedDataColumn& column = modelData.getColumn(j);
+		const FormatType format = column.getFormatType();
+
+		out.value<int32_t>(format);
+		out.value<int64_t>(column.getNumericalLabel());
+		out.string(column.getLabel());
+		out.value<int64_t>(shared[j] == j ? -1 : static_cast<int64_t>(shared[j]));
+
+		if (shared[j] == j) {
+			out.vector((format == SPARSE || format == INDICATOR) ? column.getColumnsVector() : noIndices);
+			out.vector((format == SPARSE || format == DENSE) ? column.getDataVector() : noData);
+		}
+	}
+
+	if (!out.good()) {
+		std::ostringstream stream;
+		stream << "Error writing " << fileName;
+		modelData.error->throwError(stream);
+	}
+}
+
+void BinaryModelData::read(ModelData& modelData, const std::string& fileName,
+		size_t residentBytes, size_t readAhead) {
+
+	const bool outOfCore = residentBytes > 0;
+
+	auto mappedFile = bsccs::make_unique<MappedFile>(fileName, !outOfCore);
+	const MappedFile& file = *mappedFile;
+	if (!file.begin) {
+		std::ostringstream stream;
+		stream << "Unable to open " << fileName;
+		modelData.error->throwError(stream);
+	}
+
+	BinaryReader in(file, fileName, modelData.error);
+
+	char header[sizeof(magic)];
+	if (in.remaining() < sizeof(magic)) {
+		std::memset(header, 0, sizeof(magic));
+	} else {
+		in.bytes(header, sizeof(magic));
+	}
+	if (std::memcmp(header, magic, sizeof(magic)) != 0) {
+		std::ostringstream stream;
+		stream << fileName << " is not a Cyclops binary data file";
+		modelData.error->throwError(stream);
+	}
+
+	const uint32_t fileVersion = in.value<uint32_t>();
+	const uint32_t fileByteOrder = in.value<uint32_t>();
+	const uint32_t fileRealSize = in.value<uint32_t>();
+	if (fileVersion != version || fileByteOrder != byteOrderMark || fileRealSize != sizeof(real)) {
+		std::ostringstream stream;
+		stream << "Incompatible Cyclops binary data file (version " << fileVersion
+			   << ", expected " << version << ")";
+		modelData.error->throwError(stream);
+	}
+
+	if (modelData.getNumberOfColumns() > 0 || modelData.getNumberOfRows() > 0) {
+		std::ostringstream stream;
+		stream << "Binary data can only be read into an empty data object";
+		modelData.error->throwError(stream);
+	}
+
+	const int32_t modelType = in.value<int32_t>();
+	if (modelType < 0 || modelType >= static_cast<int32_t>(ModelType::SIZE_OF_ENUM)) {
+		std::ostringstream what;
+		what << "unknown model type " << modelType;
+		in.corrupt(what.str());
+	}
+	modelData.modelType = static_cast<ModelType>(modelType);
+	const uint32_t flags = in.value<uint32_t>();
+	modelData.hasOffsetCovariate = (flags & HAS_OFFSET_COVARIATE) != 0;
+	modelData.hasInterceptCovariate = (flags & HAS_INTERCEPT_COVARIATE) != 0;
+	modelData.isFinalized = (flags & IS_FINALIZED) != 0;
+	modelData.nTypes = in.value<int32_t>();
+	modelData.nRows = in.value<uint64_t>();
+	modelData.nPatients = static_cast<int>(in.value<int64_t>());
+	modelData.conditionId = in.string();
+
+	in.vector(modelData.pid);
+	in.vector(modelData.y);
+	in.vector(modelData.z);
+	in.vector(modelData.offs);
+
+	const uint64_t nLabels = in.value<uint64_t>();
+	for (uint64_t i = 0; i < nLabels; ++i) {
+		modelData.labels.push_back(in.string());
+	}
+
+	const uint64_t nColumns = in.value<uint64_t>();
+	const size_t minimumColumnBytes = sizeof(int32_t) + sizeof(int64_t) + sizeof(uint64_t) + sizeof(int64_t);
+	if (nColumns > in.remaining() / minimumColumnBytes) {
+		std::ostringstream what;
+		what << nColumns << " columns";
+		in.corrupt(what.str());
+	}
+
+	// Out-of-core: columns start empty and are filled from the file on access
+	bsccs::unique_ptr<MappedColumnPager> pager;
+	std::vector<size_t> extents;
+	if (outOfCore) {
+		pager = bsccs::make_unique<MappedColumnPager>(std::move(mappedFile), residentBytes, readAhead);
+		extents.reserve(4 * nColumns);
+	}
+
+	for (uint64_t j = 0; j < nColumns; ++j) {
+		const int32_t formatType = in.value<int32_t>();
+		if (formatType < DENSE || formatType > INTERCEPT) {
+			std::ostringstream what;
+			what << "unknown format " << formatType << " for column " << j;
+			in.corrupt(what.str());
+		}
+		const FormatType format = static_cast<FormatType>(formatType);
+		const IdType numericalLabel = in.value<int64_t>();
+		const std::string label = in.string();
+		const int64_t sharedWith = in.value<int64_t>();
+		if (sharedWith < -1 || sharedWith >= static_cast<int64_t>(j)) {
+			std::ostringstream what;
+			what << "column " << j << " shares storage with column " << sharedWith;
+			in.corrupt(what.str());
+		}
+		const bool isShared = sharedWith >= 0;
+
+		if (outOfCore) {
+			uint64_t nIndices = 0, nData = 0;
+			size_t indicesOffset = 0, dataOffset = 0;
+			if (isShared) { // Page from the original's buffers
+				indicesOffset = extents[4 * sharedWith];
+				nIndices = extents[4 * sharedWith + 1];
+				dataOffset = extents[4 * sharedWith + 2];
+				nData = extents[4 * sharedWith + 3];
+			} else {
+				indicesOffset = in.extent<int>(nIndices);
+				dataOffset = in.extent<real>(nData);
+			}
+			extents.push_back(indicesOffset);
+			extents.push_back(nIndices);
+			extents.push_back(dataOffset);
+			extents.push_back(nData);
+
+			modelData.push_back(format);
+			pager->add(modelData.getColumn(j), indicesOffset, nIndices, dataOffset, nData);
+		} else if (isShared) {
+			modelData.push_back(format);
+			const CompressedDataColumn& original = modelData.getColumn(sharedWith);
+			modelData.getColumn(j).shareStorage(original);
+			modelData.getColumn(sharedWith).shareStorage(original);
+		} else {
+			IntVectorPtr indices = make_shared<IntVector>();
+			RealVectorPtr data = make_shared<RealVector>();
+			in.vector(*indices);
+			in.vector(*data);
+			modelData.push_back(
+				(format == SPARSE || format == INDICATOR) ? indices : IntVectorPtr(),
+				(format == SPARSE || format == DENSE) ? data : RealVectorPtr(),
+				format);
+		}
+
+		modelData.setColumnLabel(j, numericalLabel);
+		modelData.getColumn(j).add_label(label);
+	}
+
+	modelData.touchX();
+
+	if (outOfCore) {
+		modelData.setColumnPager(ColumnPagerPtr(pager.release()));
+	}
+}
+
+} // namespace
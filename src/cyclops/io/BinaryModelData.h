@@ -0,0 +1,61 @@
+/*
+ * BinaryModelData.h
+ *
+ * Versioned binary snapshot of a finalized ModelData.  Buffers are 8-byte aligned and
+ * reloading costs one bulk copy per buffer instead of parsing.  Columns own their
+ * copies, so loading still takes time proportional to the file size and each process
+ * holds its own copy of the data; nothing is shared through the page cache.
+ *
+ * Layout (native endianness, checked on read):
+ *   header   : magic "CYCLOPSB", uint32 version, uint32 byte-order mark, uint32 sizeof(real)
+ *   scalars  : model type, flags, nTypes, nRows, nPatients, conditionId
+ *   rows     : pid, y, z, offs, row labels
+ *   columns  : per column format, labels, shared-storage link and CSC buffers
+ */
+
+#ifndef BINARYMODELDATA_H_
+#define BINARYMODELDATA_H_
+
+#include <string>
+
+#include "ModelData.h"
+#include "io/InputReader.h"
+
+namespace bsccs {
+
+class BinaryModelData {
+public:
+
+	static const unsigned int version = 1;
+
+	static void write(const ModelData& modelData, const std::string& fileName);
+
+	/**
+	 * Fill an empty ModelData from a binary image.  With residentBytes > 0, column
+	 * storage stays on disk and is paged in on access, holding roughly residentBytes
+	 * of columns and prefetching readAhead columns ahead of the coordinate sweep.
+	 */
+	static void read(ModelData& modelData, const std::string& fileName,
+		size_t residentBytes = 0, size_t readAhead = 4);
+};
+
+class BinaryInputReader : public InputReader {
+public:
+	BinaryInputReader(
+		loggers::ProgressLoggerPtr logger,
+		loggers::ErrorHandlerPtr error,
+		size_t residentBytes = 0) : InputReader(logger, error), residentBytes(residentBytes) { }
+
+	virtual ~BinaryInputReader() { }
+
+	virtual void readFile(const char* fileName) {
+		BinaryModelData::read(*modelData, fileName, residentBytes);
+	}
+
+private:
+	size_t residentBytes;
+};
+
+} // namespace
+
+#endif /* BINARYMODELDATA_H_ */
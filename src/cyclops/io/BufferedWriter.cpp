@@ -0,0 +1,97 @@
+/*
+ * BufferedWriter.cpp
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#include "io/BufferedWriter.h"
+
+namespace bsccs {
+
+BufferedWriter::BufferedWriter(size_t capacity)
+	: file(nullptr), buffer(std::max(capacity, maxNumberLength)), used(0), written(0) { }
+
+BufferedWriter::~BufferedWriter() {
+	close();
+}
+
+bool BufferedWriter::open(const std::string& fileName) {
+	close();
+	file = std::fopen(fileName.c_str(), "wb");
+	written = 0;
+	return file != nullptr;
+}
+
+void BufferedWriter::flush() {
+	if (file != nullptr && used > 0) {
+		std::fwrite(buffer.data(), 1, used, file);
+	}
+	written += used;
+	used = 0;
+}
+
+void BufferedWriter::close() {
+	if (file != nullptr) {
+		flush();
+		std::fclose(file);
+		file = nullptr;
+	}
+	used = 0;
+}
+
+BufferedWriter& BufferedWriter::write(const char* data, size_t length) {
+	if (length > buffer.size() - used) {
+		flush();
+		if (length > buffer.size()) { // Large blocks bypass the buffer
+			if (file != nullptr) {
+				std::fwrite(data, 1, length, file);
+			}
+			written += length;
+			return *this;
+		}
+	}
+	std::memcpy(&buffer[used], data, length);
+	used += length;
+	return *this;
+}
+
+BufferedWriter& BufferedWriter::write(const char* text) {
+	return write(text, std::strlen(text));
+}
+
+size_t BufferedWriter::formatUnsigned(uint64_t value, char* out) {
+	char digits[20];
+	size_t length = 0;
+	do {
+		digits[length++] = static_cast<char>('0' + value % 10);
+		value /= 10;
+	} while (value != 0);
+	for (size_t i = 0; i < length; ++i) {
+		out[i] = digits[length - 1 - i];
+	}
+	return length;
+}
+
+size_t BufferedWriter::formatInteger(int64_t value, char* out) {
+	if (value < 0) {
+		out[0] = '-';
+		return 1 + formatUnsigned(0 - static_cast<uint64_t>(value), out + 1);
+	}
+	return formatUnsigned(static_cast<uint64_t>(value), out);
+}
+
+size_t BufferedWriter::formatReal(double value, char* out) {
+	// Whole numbers below 1e6 print as integers under "%g"; -0 keeps its sign there
+	if (value == std::floor(value) && std::fabs(value) < 1e6 && !std::signbit(value)) {
+		return formatUnsigned(static_cast<uint64_t>(value), out);
+	}
+	if (value == std::floor(value) && std::fabs(value) < 1e6 && value != 0.0) {
+		return formatInteger(static_cast<int64_t>(value), out);
+	}
+	const int length = std::snprintf(out, maxNumberLength, "%g", value);
+	return length > 0 ? static_cast<size_t>(length) : 0;
+}
+
+} // namespace
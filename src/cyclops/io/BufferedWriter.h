@@ -0,0 +1,108 @@
+/*
+ * BufferedWriter.h
+ *
+ * Output file with a large private buffer.  Numbers are formatted straight into the
+ * buffer, with the same text std::ostream produces under default flags, so nothing
+ * goes through locale facets, stream sentries or per-line flushes.
+ */
+
+#ifndef BUFFEREDWRITER_H_
+#define BUFFEREDWRITER_H_
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace bsccs {
+
+class BufferedWriter {
+public:
+
+	static const size_t defaultCapacity = 1 << 20;
+
+	// Longest output of formatReal() or formatInteger()
+	static const size_t maxNumberLength = 32;
+
+	BufferedWriter(size_t capacity = defaultCapacity);
+
+	~BufferedWriter();
+
+	bool open(const std::string& fileName);
+
+	bool isOpen() const { return file != nullptr; }
+
+	void flush();
+
+	void close();
+
+	BufferedWriter& write(const char* data, size_t length);
+
+	BufferedWriter& write(const std::string& text) { return write(text.data(), text.size()); }
+
+	BufferedWriter& write(const char* text);
+
+	BufferedWriter& write(char c) {
+		reserve(1);
+		buffer[used++] = c;
+		return *this;
+	}
+
+	BufferedWriter& write(double value) {
+		reserve(maxNumberLength);
+		used += formatReal(value, &buffer[used]);
+		return *this;
+	}
+
+	BufferedWriter& write(float value) { return write(static_cast<double>(value)); }
+
+	template <typename T>
+	typename std::enable_if<std::is_integral<T>::value && !std::is_same<T, char>::value &&
+		!std::is_same<T, bool>::value, BufferedWriter&>::type write(T value) {
+		reserve(maxNumberLength);
+		used += std::is_signed<T>::value ?
+			formatInteger(static_cast<int64_t>(value), &buffer[used]) :
+			formatUnsigned(static_cast<uint64_t>(value), &buffer[used]);
+		return *this;
+	}
+
+	BufferedWriter& write(bool value) { return write(value ? '1' : '0'); }
+
+	// Native-endian bytes of trivially copyable values
+	template <typename T>
+	BufferedWriter& writeBytes(const T* values, size_t count) {
+		return write(reinterpret_cast<const char*>(values), count * sizeof(T));
+	}
+
+	template <typename T>
+	BufferedWriter& writeBytes(const T& value) { return writeBytes(&value, 1); }
+
+	uint64_t position() const { return written + used; }
+
+	// As std::ostream << value with default precision and flags ("%g"); returns length
+	static size_t formatReal(double value, char* out);
+
+	static size_t formatInteger(int64_t value, char* out);
+
+	static size_t formatUnsigned(uint64_t value, char* out);
+
+private:
+	BufferedWriter(const BufferedWriter&);
+	BufferedWriter& operator = (const BufferedWriter&);
+
+	void reserve(size_t length) {
+		if (used + length > buffer.size()) {
+			flush();
+		}
+	}
+
+	std::FILE* file;
+	std::vector<char> buffer;
+	size_t used;
+	uint64_t written;
+};
+
+} // namespace
+
+#endif /* BUFFEREDWRITER_H_ */
@@ -0,0 +1,393 @@
+/*
+ * ExternalSort.cpp
+ *
+ * Records are stride words: one order-preserving word per key followed by the
+ * original row index, so comparing whole records lexicographically gives a stable
+ * total order and runs can be merged without further tie-breaking.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <queue>
+#include <sstream>
+#include <stdexcept>
+
+#include <boost/iterator/counting_iterator.hpp>
+
+#include "io/ExternalSort.h"
+#include "Thread.h"
+
+namespace bsccs {
+
+namespace {
+
+const size_t minimumSliceRows = 1 << 16;
+const size_t writeBlockWords = 1 << 16;
+
+inline uint64_t encode(double x, bool ascending) {
+	if (std::isnan(x)) {
+		return ~static_cast<uint64_t>(0);
+	}
+	if (x == 0.0) {
+		x = 0.0; // fold -0.0 into +0.0
+	}
+	uint64_t bits;
+	std::memcpy(&bits, &x, sizeof(bits));
+	bits = (bits >> 63) ? ~bits : bits ^ (static_cast<uint64_t>(1) << 63);
+	return ascending ? bits : ~bits;
+}
+
+// Stable LSD radix sort on 8-bit digits, skipping digits shared by every record
+void radixSort(uint64_t* records, uint64_t* scratch, const size_t n,
+		const size_t stride, const size_t nKeys) {
+
+	uint64_t* source = records;
+	uint64_t* destination = scratch;
+	std::vector<size_t> counts(8 * 256);
+
+	for (size_t key = nKeys; key-- > 0; ) {
+		std::fill(counts.begin(), counts.end(), 0);
+		for (size_t i = 0; i < n; ++i) {
+			const uint64_t word = source[i * stride + key];
+			for (int digit = 0; digit < 8; ++digit) {
+				++counts[digit * 256 + ((word >> (8 * digit)) & 0xFF)];
+			}
+		}
+
+		for (int digit = 0; digit < 8; ++digit) {
+			size_t* bucket = &counts[digit * 256];
+			if (*std::max_element(bucket, bucket + 256) == n) {
+				continue;
+			}
+			size_t offset = 0;
+			for (int b = 0; b < 256; ++b) {
+				const size_t count = bucket[b];
+				bucket[b] = offset;
+				offset += count;
+			}
+			for (size_t i = 0; i < n; ++i) {
+				const uint64_t* record = source + i * stride;
+				const size_t position = bucket[(record[key] >> (8 * digit)) & 0xFF]++;
+				std::copy(record, record + stride, destination + position * stride);
+			}
+			std::swap(source, destination);
+		}
+	}
+
+	if (source != records) {
+		std::copy(source, source + n * stride, records);
+	}
+}
+
+struct FileSink {
+	FileSink(std::ofstream& stream, size_t stride) : stream(stream), stride(stride) {
+		block.reserve(writeBlockWords + stride);
+	}
+
+	void operator()(const uint64_t* record) {
+		block.insert(block.end(), record, record + stride);
+		if (block.size() >= writeBlockWords) {
+			flush();
+		}
+	}
+
+	void flush() {
+		stream.write(reinterpret_cast<const char*>(block.data()), block.size() * sizeof(uint64_t));
+		block.clear();
+	}
+
+	std::ofstream& stream;
+	const size_t stride;
+	std::vector<uint64_t> block;
+};
+
+// Collects original row indices into blocks for an ExternalSort::OrderSink
+struct OrderBlockSink {
+	OrderBlockSink(const ExternalSort::OrderSink& sink, size_t stride, size_t blockRows)
+		: sink(sink), stride(stride), blockRows(blockRows) {
+		block.reserve(blockRows);
+	}
+
+	void operator()(const uint64_t* record) {
+		block.push_back(record[stride - 1]);
+		if (block.size() == blockRows) {
+			flush();
+		}
+	}
+
+	void flush() {
+		if (!block.empty()) {
+			sink(block.data(), block.size());
+			block.clear();
+		}
+	}
+
+	const ExternalSort::OrderSink& sink;
+	const size_t stride;
+	const size_t blockRows;
+	std::vector<uint64_t> block;
+};
+
+} // namespace
+
+struct ExternalSort::RunCursor {
+
+	RunCursor(const uint64_t* begin, const uint64_t* end, size_t stride)
+		: position(begin), end(end), stride(stride) { }
+
+	RunCursor(const std::string& fileName, size_t stride, size_t blockRows)
+		: position(nullptr), end(nullptr), stride(stride),
+		  file(new std::ifstream(fileName.c_str(), std::ios::in | std::ios::binary)),
+		  block(blockRows * stride) {
+		if (!*file) {
+			throw std::runtime_error("Unable to read sort run " + fileName);
+		}
+		refill();
+	}
+
+	bool done() const { return position == end; }
+
+	bool advance() {
+		position += stride;
+		if (position == end && file) {
+			refill();
+		}
+		return position != end;
+	}
+
+	void refill() {
+		file->read(reinterpret_cast<char*>(block.data()), block.size() * sizeof(uint64_t));
+		position = block.data();
+		end = position + file->gcount() / sizeof(uint64_t);
+	}
+
+	const uint64_t* position;
+	const uint64_t* end;
+	size_t stride;
+	std::unique_ptr<std::ifstream> file;
+	std::vector<uint64_t> block;
+};
+
+ExternalSort::ExternalSort(const std::vector<bool>& ascending, size_t memoryBytes,
+		int nThreads, const std::string& tempDirectory)
+	: ascending(ascending), stride(ascending.size() + 1),
+	  nThreads(std::max(nThreads, 1)), tempDirectory(tempDirectory), rows(0) {
+
+	if (ascending.empty()) {
+		throw std::invalid_argument("No sort keys given");
+	}
+	// Buffer and radix scratch are both held while sorting
+	maxBufferedRows = std::max(memoryBytes / (2 * stride * sizeof(uint64_t)), minimumSliceRows);
+}
+
+ExternalSort::~ExternalSort() {
+	for (const auto& fileName : runFiles) {
+		std::remove(fileName.c_str());
+	}
+}
+
+void ExternalSort::add(const std::vector<const double*>& keys, size_t length) {
+
+	const size_t nKeys = stride - 1;
+	if (keys.size() != nKeys) {
+		throw std::invalid_argument("Number of key columns does not match sort order");
+	}
+
+	size_t done = 0;
+	while (done < length) {
+		const size_t buffered = buffer.size() / stride;
+		const size_t count = std::min(length - done, maxBufferedRows - buffered);
+
+		buffer.resize((buffered + count) * stride);
+		uint64_t* record = &buffer[buffered * stride];
+		for (size_t i = done; i < done + count; ++i, record += stride) {
+			for (size_t k = 0; k < nKeys; ++k) {
+				record[k] = encode(keys[k][i], ascending[k]);
+			}
+			record[nKeys] = rows++;
+		}
+		done += count;
+
+		if (buffer.size() / stride == maxBufferedRows) {
+			spill();
+		}
+	}
+}
+
+void ExternalSort::sortBuffer(std::vector<size_t>& slices) {
+
+	const size_t n = buffer.size() / stride;
+	if (n == 0) {
+		slices.assign(1, 0); // No slices
+		return;
+	}
+	const size_t nSlices = std::max(static_cast<size_t>(1),
+		std::min(static_cast<size_t>(nThreads), n / minimumSliceRows));
+
+	slices.resize(nSlices + 1);
+	for (size_t s = 0; s <= nSlices; ++s) {
+		slices[s] = n * s / nSlices;
+	}
+
+	scratch.resize(buffer.size());
+	auto sortSlice = [this, &slices](const size_t s) {
+		radixSort(buffer.data() + slices[s] * stride, scratch.data() + slices[s] * stride,
+			slices[s + 1] - slices[s], stride, stride - 1);
+	};
+
+	if (nSlices == 1) {
+		sortSlice(0);
+	} else {
+		TaskScheduler<boost::counting_iterator<size_t>>(
+			boost::make_counting_iterator(static_cast<size_t>(0)),
+			boost::make_counting_iterator(nSlices),
+			nSlices
+		).execute(sortSlice);
+	}
+}
+
+template <typename Sink>
+void ExternalSort::merge(std::vector<RunCursor>& runs, Sink& sink) const {
+
+	const size_t width = stride;
+	auto greater = [&runs, width](const size_t lhs, const size_t rhs) {
+		return std::lexicographical_compare(
+			runs[rhs].position, runs[rhs].position + width,
+			runs[lhs].position, runs[lhs].position + width);
+	};
+
+	std::priority_queue<size_t, std::vector<size_t>, decltype(greater)> heap(greater);
+	for (size_t r = 0; r < runs.size(); ++r) {
+		if (!runs[r].done()) {
+			heap.push(r);
+		}
+	}
+
+	while (!heap.empty()) {
+		const size_t r = heap.top();
+		heap.pop();
+		RunCursor& run = runs[r];
+		// Drain while this run still holds the smallest record
+		do {
+			sink(run.position);
+		} while (run.advance() && (heap.empty() || !greater(r, heap.top())));
+		if (!run.done()) {
+			heap.push(r);
+		}
+	}
+}
+
+void ExternalSort::spill() {
+
+	std::vector<size_t> slices;
+	sortBuffer(slices);
+
+	std::ostringstream name;
+	name << tempDirectory << "/cyclops-sort-" << static_cast<const void*>(this)
+	     << "-" << runFiles.size() << ".bin";
+	runFiles.push_back(name.str());
+
+	std::ofstream stream(runFiles.back().c_str(), std::ios::out | std::ios::binary);
+	if (!stream) {
+		throw std::runtime_error("Unable to write sort run " + runFiles.back());
+	}
+
+	std::vector<RunCursor> runs;
+	runs.reserve(slices.size() - 1);
+	for (size_t s = 0; s + 1 < slices.size(); ++s) {
+		runs.emplace_back(buffer.data() + slices[s] * stride, buffer.data() + slices[s + 1] * stride, stride);
+	}
+
+	FileSink sink(stream, stride);
+	merge(runs, sink);
+	sink.flush();
+
+	if (!stream) {
+		throw std::runtime_error("Unable to write sort run " + runFiles.back());
+	}
+	buffer.clear();
+}
+
+void ExternalSort::finish(const OrderSink& orderSink) {
+
+	OrderBlockSink sink(orderSink, stride, std::min(maxBufferedRows, std::max(rows,
+		static_cast<size_t>(1))));
+
+	std::vector<RunCursor> runs;
+	if (runFiles.empty()) {
+		if (buffer.empty()) {
+			return;
+		}
+		std::vector<size_t> slices;
+		sortBuffer(slices);
+		runs.reserve(slices.size() - 1);
+		for (size_t s = 0; s + 1 < slices.size(); ++s) {
+			runs.emplace_back(buffer.data() + slices[s] * stride, buffer.data() + slices[s + 1] * stride, stride);
+		}
+		merge(runs, sink);
+	} else {
+		if (!buffer.empty()) {
+			spill();
+		}
+		std::vector<uint64_t>().swap(scratch);
+		std::vector<uint64_t>().swap(buffer);
+
+		// Read blocks and the order block together stay within the buffer's budget
+		const size_t blockRows = std::max(maxBufferedRows / runFiles.size(),
+			static_cast<size_t>(1024));
+		runs.reserve(runFiles.size());
+		for (const auto& fileName : runFiles) {
+			runs.emplace_back(fileName, stride, blockRows);
+		}
+		merge(runs, sink);
+	}
+	sink.flush();
+
+	std::vector<uint64_t>().swap(scratch);
+	std::vector<uint64_t>().swap(buffer);
+}
+
+std::vector<uint64_t> ExternalSort::finish() {
+	std::vector<uint64_t> order;
+	order.reserve(rows);
+	finish([&order](const uint64_t* block, size_t length) {
+		order.insert(order.end(), block, block + length);
+	});
+	return order;
+}
+
+RowIdIndex::RowIdIndex(const double* rowIds, size_t length) {
+	map.reserve(length);
+	for (size_t i = 0; i < length; ++i) {
+		if (std::isnan(rowIds[i])) {
+			continue;
+		}
+		map.insert(std::make_pair(static_cast<IdType>(rowIds[i]), static_cast<int64_t>(i)));
+	}
+}
+
+void RowIdIndex::lookup(const double* ids, size_t length, int64_t* positions, int nThreads) const {
+
+	const size_t nBlocks = std::max(static_cast<size_t>(1),
+		std::min(static_cast<size_t>(std::max(nThreads, 1)), length / minimumSliceRows));
+
+	auto lookupBlock = [this, ids, length, positions, nBlocks](const size_t b) {
+		const size_t end = length * (b + 1) / nBlocks;
+		for (size_t i = length * b / nBlocks; i < end; ++i) {
+			const auto it = std::isnan(ids[i]) ? map.end() : map.find(static_cast<IdType>(ids[i]));
+			positions[i] = (it == map.end()) ? -1 : it->second;
+		}
+	};
+
+	TaskScheduler<boost::counting_iterator<size_t>>(
+		boost::make_counting_iterator(static_cast<size_t>(0)),
+		boost::make_counting_iterator(nBlocks),
+		nBlocks
+	).execute(lookupBlock);
+}
+
+} // namespace
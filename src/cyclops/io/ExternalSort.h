@@ -0,0 +1,92 @@
+/*
+ * ExternalSort.h
+ *
+ * Multi-key sort order for outcome and covariate tables that need not fit in memory.
+ * Rows arrive in chunks; keys are encoded into order-preserving 64-bit words and
+ * radix-sorted in parallel slices.  Once the buffered records exceed the memory budget
+ * they are written out as a sorted run to a temporary file, and finish() merges all
+ * runs into the stable sort permutation, streaming it out in blocks so that the whole
+ * order need not be held in memory either.
+ */
+
+#ifndef EXTERNALSORT_H_
+#define EXTERNALSORT_H_
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "Types.h"
+
+namespace bsccs {
+
+class ExternalSort {
+public:
+	ExternalSort(const std::vector<bool>& ascending, size_t memoryBytes,
+		int nThreads = 1, const std::string& tempDirectory = ".");
+
+	~ExternalSort();
+
+	/**
+	 * Append length rows; keys[k] holds the values of the k-th sort column.
+	 * NaN (R's NA) sorts last in either direction.
+	 */
+	void add(const std::vector<const double*>& keys, size_t length);
+
+	size_t size() const { return rows; }
+
+	typedef std::function<void(const uint64_t* order, size_t length)> OrderSink;
+
+	/**
+	 * Hand the 0-based stable permutation of all added rows to sink, in order, as blocks
+	 * no larger than the buffer allowed by the memory budget
+	 */
+	void finish(const OrderSink& sink);
+
+	// 0-based stable permutation of all added rows, held whole
+	std::vector<uint64_t> finish();
+
+private:
+	struct RunCursor;
+
+	void sortBuffer(std::vector<size_t>& slices);
+
+	void spill();
+
+	template <typename Sink>
+	void merge(std::vector<RunCursor>& runs, Sink& sink) const;
+
+	std::vector<bool> ascending;
+	size_t stride; // key words + original row index
+	size_t maxBufferedRows;
+	int nThreads;
+	std::string tempDirectory;
+
+	std::vector<uint64_t> buffer;
+	std::vector<uint64_t> scratch;
+	std::vector<std::string> runFiles;
+
+	size_t rows;
+};
+
+/**
+ * Hashed rowId -> row position, matching covariate rows to the outcome table
+ */
+class RowIdIndex {
+public:
+	RowIdIndex(const double* rowIds, size_t length);
+
+	// Position of each id in the outcome table, or -1 when absent
+	void lookup(const double* ids, size_t length, int64_t* positions, int nThreads = 1) const;
+
+	size_t size() const { return map.size(); }
+
+private:
+	std::unordered_map<IdType, int64_t> map;
+};
+
+} // namespace
+
+#endif /* EXTERNALSORT_H_ */
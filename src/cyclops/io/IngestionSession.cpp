@@ -0,0 +1,260 @@
+/*
+ * IngestionSession.cpp
+ *
+ * Each column is owned by exactly one worker (column index modulo worker count), so
+ * its entries arrive in row order and no column is shared between threads.  Only the
+ * dispatcher touches the outcome vectors and the column list.
+ */
+
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+#include "io/IngestionSession.h"
+
+namespace bsccs {
+
+IngestionSession::IngestionSession(ModelData& modelData, int nThreads,
+		size_t maxPendingBatches, size_t expectedRows)
+	: modelData(modelData), nWorkers(std::max(nThreads, 1)),
+	  batches(maxPendingBatches), failed(false), rowsAppended(0), closed(false) {
+
+	modelData.checkInMemory();
+
+	if (expectedRows > 0) {
+		const size_t rows = modelData.nRows + expectedRows;
+		modelData.pid.reserve(rows);
+		modelData.y.reserve(rows);
+		modelData.offs.reserve(rows);
+		modelData.labels.reserve(rows);
+	}
+
+	modelData.log->setConcurrent(true);
+
+	workerArguments.resize(nWorkers);
+	for (size_t w = 0; w < nWorkers; ++w) {
+		workerQueues.push_back(bsccs::make_unique<BoundedQueue<std::vector<Entry>>>(maxPendingBatches));
+		workerArguments[w].session = this;
+		workerArguments[w].index = w;
+	}
+	for (size_t w = 0; w < nWorkers; ++w) {
+		workers.push_back(bsccs::unique_ptr<thread>(new thread(runWorker, &workerArguments[w])));
+	}
+	dispatcher = bsccs::unique_ptr<thread>(new thread(runDispatcher, this));
+}
+
+IngestionSession::~IngestionSession() {
+	if (!closed) {
+		try {
+			close();
+		} catch (...) {
+			// Failures are only reported through append() or close()
+		}
+	}
+}
+
+void IngestionSession::append(Batch&& batch) {
+
+	if (closed) {
+		std::ostringstream stream;
+		stream << "Ingestion session is already closed";
+		modelData.error->throwError(stream);
+	}
+	rethrowFailure();
+
+	if (batch.covariateRowId.size() != batch.covariateId.size()
+			|| batch.covariateRowId.size() != batch.covariateValue.size()) {
+		std::ostringstream stream;
+		stream << "Mismatched covariate column dimensions";
+		modelData.error->throwError(stream);
+	}
+
+	if (batch.stratumId.size() != batch.y.size()
+			|| batch.stratumId.size() != batch.rowId.size()) {
+		std::ostringstream stream;
+		stream << "Mismatched outcome column dimensions";
+		modelData.error->throwError(stream);
+	}
+
+	batches.push(std::move(batch));
+}
+
+size_t IngestionSession::close() {
+
+	if (!closed) {
+		closed = true;
+		batches.close();
+		dispatcher->join();
+		for (auto& worker : workers) {
+			worker->join();
+		}
+
+		modelData.log->setConcurrent(false);
+		modelData.log->flush();
+		modelData.touchX();
+	}
+	rethrowFailure();
+
+	return rowsAppended;
+}
+
+void IngestionSession::runDispatcher(void* arguments) {
+
+	IngestionSession* session = static_cast<IngestionSession*>(arguments);
+
+	Batch batch;
+	while (session->batches.pop(batch)) {
+		try {
+			session->dispatch(batch);
+		} catch (...) {
+			session->recordFailure();
+		}
+	}
+
+	for (auto& queue : session->workerQueues) {
+		queue->close();
+	}
+}
+
+void IngestionSession::runWorker(void* arguments) {
+
+	WorkerArguments* worker = static_cast<WorkerArguments*>(arguments);
+	IngestionSession* session = worker->session;
+
+	std::vector<Entry> entries;
+	while (session->workerQueues[worker->index]->pop(entries)) {
+		try {
+			session->fill(entries);
+		} catch (...) {
+			session->recordFailure();
+		}
+	}
+}
+
+void IngestionSession::dispatch(Batch& batch) {
+
+	if (failed) {
+		return; // Later batches may continue strata of the failed one
+	}
+	validate(batch);
+
+	ModelData& data = modelData;
+	const bool hasTime = batch.time.size() == batch.y.size();
+
+	const size_t nOutcomes = batch.stratumId.size();
+	const size_t nCovariates = batch.covariateId.size();
+
+	std::vector<std::vector<Entry>> routed(nWorkers);
+	size_t cOffset = 0;
+
+	// Nothing reaches the workers until every row is in, so a failure here only needs
+	// the outcome rows taken back out
+	const size_t startRows = data.nRows;
+	const size_t startTimes = data.offs.size();
+	const int startPatients = data.nPatients;
+	const std::pair<IdType, int> startStratum = data.lastStratumMap;
+
+	try {
+		for (size_t i = 0; i < nOutcomes; ++i) {
+
+			const IdType currentRowId = batch.rowId[i];
+			data.appendRow(batch.stratumId[i], currentRowId, batch.y[i], hasTime,
+				hasTime ? batch.time[i] : 0.0);
+
+			while (cOffset < nCovariates && batch.covariateRowId[cOffset] == currentRowId) {
+				const IdType covariate = batch.covariateId[cOffset];
+
+				auto it = columns.find(covariate);
+				if (it == columns.end()) {
+					if (!data.sparseIndexer.hasColumn(covariate)) {
+						data.sparseIndexer.addColumn(covariate, INDICATOR);
+					}
+					const size_t index = data.sparseIndexer.getIndex(covariate);
+					it = columns.insert(std::make_pair(covariate,
+						std::make_pair(&data.getColumn(index), index % nWorkers))).first;
+				}
+
+				routed[it->second.second].push_back(Entry{
+					it->second.first, static_cast<int>(data.nRows), currentRowId,
+					static_cast<real>(batch.covariateValue[cOffset])});
+				++cOffset;
+			}
+			++data.nRows;
+		}
+	} catch (...) {
+		data.pid.resize(startRows);
+		data.y.resize(startRows);
+		data.labels.resize(startRows);
+		data.offs.resize(startTimes);
+		data.nRows = startRows;
+		data.nPatients = startPatients;
+		data.lastStratumMap = startStratum;
+		throw;
+	}
+
+	rowsAppended += nOutcomes;
+
+	for (size_t w = 0; w < nWorkers; ++w) {
+		if (!routed[w].empty()) {
+			workerQueues[w]->push(std::move(routed[w]));
+		}
+	}
+}
+
+void IngestionSession::validate(const Batch& batch) const {
+
+	// Every covariate must attach to an outcome row, in outcome row order
+	const size_t nOutcomes = batch.rowId.size();
+	const size_t nCovariates = batch.covariateRowId.size();
+	size_t cOffset = 0;
+	for (size_t i = 0; i < nOutcomes && cOffset < nCovariates; ++i) {
+		while (cOffset < nCovariates && batch.covariateRowId[cOffset] == batch.rowId[i]) {
+			++cOffset;
+		}
+	}
+	if (cOffset < nCovariates) {
+		std::ostringstream stream;
+		stream << "Covariate row " << batch.covariateRowId[cOffset]
+		       << " does not follow the outcome row order of its batch";
+		throw std::runtime_error(stream.str());
+	}
+}
+
+void IngestionSession::fill(const std::vector<Entry>& entries) {
+
+	if (failed) {
+		return;
+	}
+	for (const Entry& entry : entries) {
+		modelData.appendEntry(*entry.column, entry.row, entry.rowId, entry.value);
+	}
+}
+
+void IngestionSession::recordFailure() {
+	std::lock_guard<mutex> guard(failureLock);
+	if (!failure) {
+		failure = std::current_exception();
+	}
+	failed = true;
+}
+
+void IngestionSession::rethrowFailure() const {
+	std::exception_ptr pending;
+	{
+		std::lock_guard<mutex> guard(failureLock);
+		pending = failure;
+	}
+	if (pending) {
+		std::ostringstream stream;
+		try {
+			std::rethrow_exception(pending);
+		} catch (const std::exception& e) {
+			stream << "Ingestion session failed: " << e.what();
+		} catch (...) {
+			stream << "Ingestion session failed";
+		}
+		modelData.error->throwError(stream);
+	}
+}
+
+} // namespace
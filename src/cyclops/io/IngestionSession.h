@@ -0,0 +1,158 @@
+/*
+ * IngestionSession.h
+ *
+ * Streaming append into a ModelData.  Batches follow the ModelData::append contract
+ * (outcomes sorted by stratum and row, covariates sorted by row) and are applied in
+ * the background: a dispatcher thread appends outcome rows and creates columns in
+ * first-seen order, while column workers fill disjoint sets of columns.  The producer
+ * only blocks when too many batches are pending, so loading overlaps with upstream
+ * query execution.  The ModelData must not be touched until close() returns.
+ *
+ * A batch whose covariates do not follow its outcome rows is rejected before anything
+ * is appended.  After any failure the session is unusable: later batches are dropped,
+ * and append() and close() report the failure.  Rows from earlier batches remain.
+ */
+
+#ifndef INGESTIONSESSION_H_
+#define INGESTIONSESSION_H_
+
+#include <atomic>
+#include <deque>
+#include <exception>
+#include <unordered_map>
+#include <vector>
+
+#include "ModelData.h"
+#include "Thread.h"
+
+namespace bsccs {
+
+template <typename T>
+class BoundedQueue {
+public:
+	BoundedQueue(size_t capacity) : capacity(std::max(capacity, static_cast<size_t>(1))), closed(false) { }
+
+	void push(T&& item) {
+		lock.lock();
+		while (items.size() >= capacity && !closed) {
+			notFull.wait(lock);
+		}
+		items.push_back(std::move(item));
+		lock.unlock();
+		notEmpty.notify_one();
+	}
+
+	// Returns false once the queue is closed and drained
+	bool pop(T& item) {
+		lock.lock();
+		while (items.empty() && !closed) {
+			notEmpty.wait(lock);
+		}
+		const bool available = !items.empty();
+		if (available) {
+			item = std::move(items.front());
+			items.pop_front();
+		}
+		lock.unlock();
+		notFull.notify_one();
+		return available;
+	}
+
+	void close() {
+		lock.lock();
+		closed = true;
+		lock.unlock();
+		notEmpty.notify_all();
+		notFull.notify_all();
+	}
+
+private:
+	size_t capacity;
+	bool closed;
+	std::deque<T> items;
+	mutex lock;
+	condition_variable notEmpty;
+	condition_variable notFull;
+};
+
+class IngestionSession {
+public:
+
+	struct Batch {
+		std::vector<IdType> stratumId;
+		std::vector<IdType> rowId;
+		std::vector<double> y;
+		std::vector<double> time;
+		std::vector<IdType> covariateRowId;
+		std::vector<IdType> covariateId;
+		std::vector<double> covariateValue;
+	};
+
+	/**
+	 * nThreads column workers (plus one dispatcher); expectedRows pre-sizes the
+	 * outcome vectors
+	 */
+	IngestionSession(ModelData& modelData, int nThreads = 1,
+		size_t maxPendingBatches = 4, size_t expectedRows = 0);
+
+	~IngestionSession();
+
+	// Queue a batch; reports any failure from an earlier batch
+	void append(Batch&& batch);
+
+	// Wait for all queued batches; returns the number of rows appended by this session
+	size_t close();
+
+	bool isClosed() const { return closed; }
+
+private:
+
+	struct Entry {
+		CompressedDataColumn* column;
+		int row;
+		IdType rowId;
+		real value;
+	};
+
+	struct WorkerArguments {
+		IngestionSession* session;
+		size_t index;
+	};
+
+	static void runDispatcher(void* arguments);
+
+	static void runWorker(void* arguments);
+
+	void dispatch(Batch& batch);
+
+	void validate(const Batch& batch) const;
+
+	void fill(const std::vector<Entry>& entries);
+
+	void recordFailure();
+
+	void rethrowFailure() const;
+
+	ModelData& modelData;
+	const size_t nWorkers;
+
+	BoundedQueue<Batch> batches;
+	std::vector<unique_ptr<BoundedQueue<std::vector<Entry>>>> workerQueues;
+
+	std::unordered_map<IdType, std::pair<CompressedDataColumn*, size_t>> columns;
+
+	std::vector<WorkerArguments> workerArguments;
+	unique_ptr<thread> dispatcher;
+	std::vector<unique_ptr<thread>> workers;
+
+	mutable mutex failureLock;
+	std::exception_ptr failure;
+	std::atomic<bool> failed;
+
+	size_t rowsAppended;
+	bool closed;
+};
+
+} // namespace
+
+#endif /* INGESTIONSESSION_H_ */
@@ -55,6 +55,11 @@ public:
 		return modelData;
 	}
 
+	// Readers that support it parse with up to this many threads; -1 uses all cores
+	void setThreadCount(int threads) {
+		nThreads = threads;
+	}
+
 protected:
 	bool listContains(const vector<IdType>& list, IdType value);
 
@@ -106,6 +111,7 @@ protected:
 
 	ModelData* modelData;
 	bool deleteModelData;
+	int nThreads;
 };
 
 } // namespace
@@ -0,0 +1,88 @@
+/*
+ * MappedFile.h
+ *
+ * Read-only memory map of a whole file; falls back to reading into a buffer
+ * where mmap is unavailable.
+ */
+
+#ifndef MAPPEDFILE_H_
+#define MAPPEDFILE_H_
+
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#if defined(_WIN32) || defined(__WIN32__) || defined(__WINDOWS__) || defined(WIN_BUILD)
+	#define NO_MMAP
+#else
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <fcntl.h>
+	#include <unistd.h>
+#endif
+
+namespace bsccs {
+
+class MappedFile {
+public:
+	MappedFile(const std::string& fileName, bool sequential = true) : begin(nullptr), length(0) {
+#ifdef NO_MMAP
+		std::ifstream stream(fileName.c_str(), std::ios::in | std::ios::binary);
+		if (stream) {
+			buffer.assign(std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>());
+			begin = buffer.data();
+			length = buffer.size();
+		}
+#else
+		const int fd = open(fileName.c_str(), O_RDONLY);
+		if (fd == -1) {
+			return;
+		}
+		struct stat info;
+		if (fstat(fd, &info) == 0 && info.st_size > 0) {
+			void* address = mmap(nullptr, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+			if (address != MAP_FAILED) {
+				madvise(address, info.st_size, sequential ? MADV_SEQUENTIAL : MADV_RANDOM);
+				begin = static_cast<const char*>(address);
+				length = info.st_size;
+			}
+		}
+		close(fd);
+#endif
+	}
+
+	~MappedFile() {
+#ifndef NO_MMAP
+		if (begin) {
+			munmap(const_cast<char*>(begin), length);
+		}
+#endif
+	}
+
+	void advise(size_t offset, size_t bytes, bool needed) const {
+#ifndef NO_MMAP
+		if (bytes == 0) {
+			return;
+		}
+		static const size_t pageSize = sysconf(_SC_PAGESIZE);
+		const size_t start = offset - offset % pageSize;
+		madvise(const_cast<char*>(begin) + start, offset + bytes - start,
+			needed ? MADV_WILLNEED : MADV_DONTNEED);
+#endif
+	}
+
+	const char* begin;
+	size_t length;
+
+private:
+#ifdef NO_MMAP
+	std::vector<char> buffer;
+#endif
+	MappedFile(const MappedFile&);
+	MappedFile& operator = (const MappedFile&);
+};
+
+} // namespace
+
+#endif /* MAPPEDFILE_H_ */
@@ -9,9 +9,15 @@
 #define OUTPUTWRITER_H_
 
 #include <iterator>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+#include <type_traits>
 
 #include "CyclicCoordinateDescent.h"
 #include "ModelData.h"
+#include "PerformanceCounters.h"
+#include "io/BufferedWriter.h"
 
 namespace bsccs {
 
@@ -49,28 +55,33 @@ struct RowInformation {
 	}
 };
 
-class OFStream : public std::ofstream {
+class OFStream {
 public:
 
 	OFStream(std::string _delimitor) : delimitor(_delimitor) { }
 
+	bool open(const char* fileName, std::ios::openmode) {
+		return out.open(fileName);
+	}
+
 	template <typename T>
 	OFStream& addText(const T& t) {
-		*this << t;
+		out.write(t);
 		return *this;
 	}
 
 	template <typename T>
 	OFStream& addText(const std::vector<T>& v) {
-	    std::copy(v.begin(), v.end(),
-	        std::ostream_iterator<T>(*this, " "));
-	    return *this;
+		for (const auto& x : v) {
+			out.write(x).write(' ');
+		}
+		return *this;
 	}
 
 	OFStream& addDelimitor() { return addText(delimitor); }
 
 	OFStream& addEndl() {
-		*this << std::endl;
+		out.write('\n');
 		return *this;
 	}
 
@@ -91,9 +102,232 @@ public:
 	bool includeLabels() { return true; }
 
 private:
+	BufferedWriter out;
 	const std::string delimitor;
 };
 
+/**
+ * Collects a table column by column and writes it at endTable() as
+ *   header  : magic "CYCLOPST", uint32 version, uint32 byte-order mark
+ *   table   : name, metadata count and key / value strings
+ *   columns : uint64 column and row counts; per column its name, a uint8 type
+ *             (0 = float64, 1 = int64, 2 = string) and all values, numeric ones
+ *             8-byte aligned so the file can be mapped
+ * Strings are a uint64 length and bytes.  Missing cells are NaN, INT64_MIN or "".
+ */
+class BinaryColumnStream {
+public:
+
+	BinaryColumnStream(std::string _delimitor) : inHeader(true), current(0), nRows(0) { }
+
+	bool open(const char* fileName, std::ios::openmode) {
+		return out.open(fileName);
+	}
+
+	template <typename T>
+	BinaryColumnStream& addText(const T& t) {
+		return addValue(t);
+	}
+
+	BinaryColumnStream& addDelimitor() { return *this; }
+
+	BinaryColumnStream& addEndl() {
+		if (inHeader) {
+			inHeader = false;
+		} else {
+			++nRows;
+			for (auto& column : columns) {
+				column.pad(nRows);
+			}
+		}
+		current = 0;
+		return *this;
+	}
+
+	template <typename T>
+	BinaryColumnStream& addHeader(const T& t) {
+		columns.push_back(Column(toString(t)));
+		return *this;
+	}
+
+	template <typename T>
+	BinaryColumnStream& addMetaKey(const T& t) {
+		metaKey = toString(t);
+		return *this;
+	}
+
+	template <typename T>
+	BinaryColumnStream& addMetaValue(const T& t) {
+		metadata.push_back(std::make_pair(metaKey, toString(t)));
+		return *this;
+	}
+
+	template <typename T>
+	BinaryColumnStream& addValue(const T& t) {
+		if (current >= columns.size()) {
+			columns.push_back(Column(""));
+			columns.back().pad(nRows);
+		}
+		columns[current++].add(t);
+		return *this;
+	}
+
+	BinaryColumnStream& endTable(const char* name) {
+		const char magic[8] = { 'C', 'Y', 'C', 'L', 'O', 'P', 'S', 'T' };
+		out.write(magic, sizeof(magic));
+		const uint32_t header[2] = { version, byteOrderMark };
+		out.writeBytes(header, 2);
+		writeString(name);
+
+		out.writeBytes(static_cast<uint64_t>(metadata.size()));
+		for (const auto& entry : metadata) {
+			writeString(entry.first);
+			writeString(entry.second);
+		}
+
+		out.writeBytes(static_cast<uint64_t>(columns.size()));
+		out.writeBytes(static_cast<uint64_t>(nRows));
+		for (auto& column : columns) {
+			column.pad(nRows);
+			writeString(column.name);
+			const uint8_t type = (column.type == Column::STRING) ? 2 :
+				(column.type == Column::INTEGER) ? 1 : 0;
+			out.writeBytes(type);
+			if (type == 2) {
+				for (const auto& text : column.strings) {
+					writeString(text);
+				}
+			} else {
+				pad();
+				if (type == 1) {
+					out.writeBytes(column.integers.data(), column.integers.size());
+				} else {
+					out.writeBytes(column.reals.data(), column.reals.size());
+				}
+			}
+		}
+		out.close();
+		return *this;
+	}
+
+	bool includeLabels() { return true; }
+
+	static const uint32_t version = 1;
+	static const uint32_t byteOrderMark = 0x01020304;
+
+private:
+
+	struct Column {
+		enum Type { UNSET, REAL, INTEGER, STRING };
+
+		std::string name;
+		Type type;
+		size_t unsetMissing; // missing cells before the first value fixes the type
+		std::vector<double> reals;
+		std::vector<int64_t> integers;
+		std::vector<std::string> strings;
+
+		Column(const std::string& name) : name(name), type(UNSET), unsetMissing(0) { }
+
+		size_t size() const {
+			return type == UNSET ? unsetMissing :
+				type == REAL ? reals.size() :
+				type == INTEGER ? integers.size() : strings.size();
+		}
+
+		void fix(Type newType) {
+			if (type == UNSET) {
+				type = newType;
+				const size_t missing = unsetMissing;
+				unsetMissing = 0;
+				pad(missing);
+			}
+		}
+
+		void pad(size_t length) {
+			while (size() < length) {
+				switch (type) {
+					case UNSET : ++unsetMissing; break;
+					case REAL : reals.push_back(std::numeric_limits<double>::quiet_NaN()); break;
+					case INTEGER : integers.push_back(std::numeric_limits<int64_t>::min()); break;
+					case STRING : strings.push_back(std::string()); break;
+				}
+			}
+		}
+
+		template <typename T>
+		typename std::enable_if<std::is_integral<T>::value>::type add(const T& t) {
+			fix(INTEGER);
+			if (type == INTEGER) {
+				integers.push_back(static_cast<int64_t>(t));
+			} else if (type == REAL) {
+				reals.push_back(static_cast<double>(t));
+			} else {
+				strings.push_back(toString(t));
+			}
+		}
+
+		template <typename T>
+		typename std::enable_if<std::is_floating_point<T>::value>::type add(const T& t) {
+			fix(REAL);
+			if (type == INTEGER) { // Promote the column
+				reals.assign(integers.begin(), integers.end());
+				integers.clear();
+				type = REAL;
+			}
+			if (type == REAL) {
+				reals.push_back(static_cast<double>(t));
+			} else {
+				strings.push_back(toString(t));
+			}
+		}
+
+		template <typename T>
+		typename std::enable_if<!std::is_arithmetic<T>::value>::type add(const T& t) {
+			fix(STRING);
+			if (type != STRING) {
+				throw std::logic_error("Text value in numeric column " + name);
+			}
+			strings.push_back(toString(t));
+		}
+	};
+
+	template <typename T>
+	static std::string toString(const T& t) {
+		std::ostringstream stream;
+		stream << t;
+		return stream.str();
+	}
+
+	template <typename T>
+	static std::string toString(const std::vector<T>& v) {
+		std::ostringstream stream;
+		std::copy(v.begin(), v.end(), std::ostream_iterator<T>(stream, " "));
+		return stream.str();
+	}
+
+	void writeString(const std::string& text) {
+		out.writeBytes(static_cast<uint64_t>(text.size()));
+		out.write(text);
+	}
+
+	void pad() {
+		static const char zeros[8] = { 0 };
+		const size_t extra = out.position() % 8;
+		if (extra != 0) {
+			out.write(zeros, 8 - extra);
+		}
+	}
+
+	BufferedWriter out;
+	std::vector<Column> columns;
+	std::vector<std::pair<std::string, std::string>> metadata;
+	std::string metaKey;
+	bool inHeader;
+	size_t current;
+	size_t nRows;
+};
+
 class CoutStream {
 public:
 
@@ -145,7 +379,7 @@ template <typename DerivedFormat, typename Missing = OutputHelper::NoMissingPoli
 class BaseOutputWriter : public OutputWriter, Missing {
 public:
 	BaseOutputWriter(CyclicCoordinateDescent& _ccd, const ModelData& _data) :
-		OutputWriter(), ccd(_ccd), data(_data), delimitor(","), endl("\n") {
+		OutputWriter(), ccd(_ccd), data(_data), delimitor(","), endl("\n"), binary(false) {
 		// Do nothing
 	}
 	virtual ~BaseOutputWriter() {
@@ -153,9 +387,20 @@ public:
 	}
 
 	virtual void writeFile(const char* fileName) {
-		OutputHelper::OFStream out(delimitor);
-		out.open(fileName, std::ios::out);
-		writeFile(out);
+		if (binary) {
+			OutputHelper::BinaryColumnStream out(delimitor);
+			out.open(fileName, std::ios::out);
+			writeFile(out);
+		} else {
+			OutputHelper::OFStream out(delimitor);
+			out.open(fileName, std::ios::out);
+			writeFile(out);
+		}
+	}
+
+	// Write files as binary column tables instead of delimited text
+	void setBinaryOutput(bool b) {
+		binary = b;
 	}
 
 	template <typename Stream>
@@ -213,6 +458,7 @@ protected:
 	const ModelData& data;
 	string delimitor;
 	string endl;
+	bool binary;
 };
 
 // typedef std::pair<std::string,double> ExtraInformation;
@@ -418,6 +664,46 @@ private:
 	ProfileInformationList informationList;
 };
 
+class PerformanceOutputWriter : public BaseOutputWriter<PerformanceOutputWriter> {
+public:
+	PerformanceOutputWriter(CyclicCoordinateDescent& ccd, const ModelData& data) :
+		BaseOutputWriter<PerformanceOutputWriter>(ccd, data) {
+		// Do nothing
+	}
+	virtual ~PerformanceOutputWriter() {
+		// Do nothing
+	}
+
+	int getNumberOfRows() { return static_cast<int>(counters.size()); }
+
+	void preprocessAllRows() {
+		counters = performance::snapshot();
+	}
+
+	template <typename Stream>
+	void writeEndTable(Stream& out) {
+		out.endTable("performance");
+	}
+
+	template <typename Stream>
+	void writeHeader(Stream& out) {
+		out.addHeader("kernel").addDelimitor().addHeader("format").addDelimitor()
+			.addHeader("calls").addDelimitor().addHeader("nanoseconds").addEndl();
+	}
+
+	template <typename Stream>
+	void writeRow(Stream& out, OutputHelper::RowInformation& rowInfo) {
+		const performance::CounterRecord& counter = counters[rowInfo.currentRow];
+		out.addValue(counter.kernel).addDelimitor();
+		out.addValue(counter.format).addDelimitor();
+		out.addValue(counter.calls).addDelimitor();
+		out.addValue(counter.nanoseconds).addEndl();
+	}
+
+private:
+	std::vector<performance::CounterRecord> counters;
+};
+
 }
 
 #endif /* OUTPUTWRITER_H_ */
@@ -11,6 +11,7 @@
 #include <iostream>
 #include <sstream>
 #include <cstdlib>
+#include <stdexcept>
 
 #include "Types.h"
 
@@ -38,6 +39,14 @@ public:
 
 typedef bsccs::shared_ptr<ErrorHandler> ErrorHandlerPtr;
 
+// Raises errors as exceptions, for work that must unwind before reporting
+class ThrowingErrorHandler : public ErrorHandler {
+public:
+    void throwError(const std::ostringstream& stream) {
+        throw std::runtime_error(stream.str());
+    }
+};
+
 } // namespace loggers
 
 } // namespace bsccs
@@ -33,7 +33,7 @@ public:
 		dataMatrix.push_back(type);
 		
 		// Add numerical labels
-		dataMatrix.getColumn(index).add_label(covariate);
+		dataMatrix.setColumnLabel(index, covariate);
 	}
 	
 	bool hasColumn(IdType covariate) const {
@@ -0,0 +1,344 @@
+/*
+ * SyntheticDataGenerator.cpp
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include <random>
+#include <sstream>
+
+#include "io/SyntheticDataGenerator.h"
+
+namespace bsccs {
+
+namespace {
+
+typedef std::mt19937_64 Prng;
+
+// Rows of one sparse column, visiting only the selected rows
+template <typename Function>
+void forEachSelectedRow(size_t rows, double density, Prng& prng, Function function) {
+	if (density >= 1.0) {
+		for (size_t i = 0; i < rows; ++i) {
+			function(i);
+		}
+		return;
+	}
+	std::geometric_distribution<size_t> skip(density);
+	for (size_t i = skip(prng); i < rows; i += 1 + skip(prng)) {
+		function(i);
+	}
+}
+
+bool hasIntercept(const SyntheticDataArguments& arguments) {
+	return !Models::removeIntercept(arguments.modelType) &&
+		arguments.modelType != ModelType::COX;
+}
+
+bool isStratified(const SyntheticDataArguments& arguments) {
+	return Models::requiresStratumID(arguments.modelType) ||
+		(arguments.modelType == ModelType::COX && arguments.stratumSize > 0);
+}
+
+} // namespace
+
+SyntheticDataGenerator::SyntheticDataGenerator(const SyntheticDataArguments& arguments,
+		loggers::ProgressLoggerPtr logger, loggers::ErrorHandlerPtr error)
+	: arguments(arguments), logger(logger), error(error) {
+	drawCoefficients();
+}
+
+ModelData* SyntheticDataGenerator::generate() {
+	bsccs::unique_ptr<ModelData> modelData(new ModelData(arguments.modelType, logger, error));
+	generate(*modelData);
+	return modelData.release();
+}
+
+void SyntheticDataGenerator::generate(ModelData& modelData) {
+
+	const ModelType modelType = arguments.modelType;
+	if (modelType != ModelType::LOGISTIC && modelType != ModelType::POISSON &&
+			modelType != ModelType::CONDITIONAL_LOGISTIC &&
+			modelType != ModelType::SELF_CONTROLLED_MODEL && modelType != ModelType::COX) {
+		std::ostringstream stream;
+		stream << "Synthetic data are only available for lr, pr, clr, sccs and cox designs";
+		error->throwError(stream);
+	}
+	if (arguments.rows == 0 ||
+			arguments.rows > static_cast<size_t>(std::numeric_limits<int>::max())) {
+		std::ostringstream stream;
+		stream << "Number of rows must be between 1 and " << std::numeric_limits<int>::max();
+		error->throwError(stream);
+	}
+	if (Models::requiresStratumID(modelType) && arguments.stratumSize == 0) {
+		std::ostringstream stream;
+		stream << "Stratified designs require a positive stratum size";
+		error->throwError(stream);
+	}
+	if (arguments.maxDensity <= 0.0 || arguments.maxDensity > 1.0) {
+		std::ostringstream stream;
+		stream << "Maximum density must be in (0, 1]";
+		error->throwError(stream);
+	}
+	if (modelData.getNumberOfRows() != 0 || modelData.getNumberOfColumns() != 0) {
+		std::ostringstream stream;
+		stream << "Synthetic data must be generated into an empty data set";
+		error->throwError(stream);
+	}
+
+	modelData.modelType = modelType;
+	const size_t rows = arguments.rows;
+
+	const bool stratified = isStratified(arguments);
+	modelData.pid.resize(rows);
+	for (size_t i = 0; i < rows; ++i) {
+		modelData.pid[i] = static_cast<int>(stratified ? i / arguments.stratumSize :
+			(modelType == ModelType::COX ? 0 : i));
+	}
+	modelData.nRows = rows;
+	modelData.nPatients = modelData.pid.back() + 1;
+
+	std::vector<double> eta(rows, 0.0);
+	addColumns(modelData, eta);
+	drawOutcomes(modelData, eta);
+
+	if (modelType == ModelType::COX) {
+		orderBySurvivalTime(modelData);
+	}
+}
+
+void SyntheticDataGenerator::drawCoefficients() {
+	Prng prng(arguments.seed);
+	std::normal_distribution<double> normal(0.0, arguments.effectSize);
+
+	const int offset = hasIntercept(arguments) ? 1 : 0;
+	const int columns = arguments.denseColumns + arguments.sparseColumns +
+		arguments.indicatorColumns;
+
+	trueBeta.assign(offset + columns, 0.0);
+	if (offset > 0) {
+		trueBeta[0] = (arguments.modelType == ModelType::LOGISTIC) ?
+			std::log(arguments.baseRate / (1.0 - arguments.baseRate)) :
+			std::log(arguments.baseRate);
+	}
+	const int effects = std::min(arguments.effects, columns);
+	// Spread evenly over columns, so effects fall on common and rare covariates alike
+	for (int k = 0; k < effects; ++k) {
+		trueBeta[offset + static_cast<size_t>(k) * columns / effects] = normal(prng);
+	}
+}
+
+void SyntheticDataGenerator::addColumns(ModelData& modelData, std::vector<double>& eta) {
+
+	const size_t rows = arguments.rows;
+	const int offset = hasIntercept(arguments) ? 1 : 0;
+
+	if (offset > 0) {
+		modelData.push_back(INTERCEPT);
+		modelData.setColumnLabel(0, 0);
+		modelData.setHasInterceptCovariate(true);
+		for (auto& x : eta) {
+			x = trueBeta[0];
+		}
+	}
+
+	Prng prng(arguments.seed + 1);
+	std::normal_distribution<double> normal;
+	int column = offset;
+
+	for (int j = 0; j < arguments.denseColumns; ++j, ++column) {
+		RealVectorPtr values = make_shared<RealVector>(rows);
+		for (size_t i = 0; i < rows; ++i) {
+			(*values)[i] = normal(prng);
+		}
+		const double beta = trueBeta[column];
+		if (beta != 0.0) {
+			for (size_t i = 0; i < rows; ++i) {
+				eta[i] += beta * (*values)[i];
+			}
+		}
+		modelData.push_back(NULL, values, DENSE);
+		modelData.setColumnLabel(column, column + 1 - offset);
+	}
+
+	const int sparse = arguments.sparseColumns + arguments.indicatorColumns;
+	for (int j = 0; j < sparse; ++j, ++column) {
+		const bool indicator = j >= arguments.sparseColumns;
+		const int rank = indicator ? j - arguments.sparseColumns : j;
+		const double density = std::max(
+			arguments.maxDensity * std::pow(rank + 1.0, -arguments.decay), 1.0 / rows);
+
+		IntVectorPtr indices = make_shared<IntVector>();
+		indices->reserve(static_cast<size_t>(density * rows * 1.1) + 16);
+		RealVectorPtr values;
+		if (indicator) {
+			forEachSelectedRow(rows, density, prng, [&indices](size_t i) {
+				indices->push_back(static_cast<int>(i));
+			});
+		} else {
+			values = make_shared<RealVector>();
+			values->reserve(indices->capacity());
+			forEachSelectedRow(rows, density, prng, [&](size_t i) {
+				indices->push_back(static_cast<int>(i));
+				values->push_back(normal(prng));
+			});
+		}
+
+		const double beta = trueBeta[column];
+		if (beta != 0.0) {
+			for (size_t k = 0; k < indices->size(); ++k) {
+				eta[(*indices)[k]] += beta * (indicator ? 1.0 : (*values)[k]);
+			}
+		}
+		modelData.push_back(indices, values, indicator ? INDICATOR : SPARSE);
+		modelData.setColumnLabel(column, column + 1 - offset);
+	}
+}
+
+void SyntheticDataGenerator::drawOutcomes(ModelData& modelData, const std::vector<double>& eta) {
+
+	const size_t rows = arguments.rows;
+	Prng prng(arguments.seed + 2);
+	std::uniform_real_distribution<double> uniform;
+
+	RealVector& y = modelData.y;
+	y.assign(rows, 0.0);
+
+	switch (arguments.modelType) {
+		case ModelType::LOGISTIC :
+			for (size_t i = 0; i < rows; ++i) {
+				y[i] = (uniform(prng) * (1.0 + std::exp(-eta[i])) < 1.0) ? 1.0 : 0.0;
+			}
+			break;
+		case ModelType::POISSON :
+			for (size_t i = 0; i < rows; ++i) {
+				std::poisson_distribution<int> count(std::exp(eta[i]));
+				y[i] = count(prng);
+			}
+			break;
+		case ModelType::CONDITIONAL_LOGISTIC :
+			for (size_t begin = 0; begin < rows; begin += arguments.stratumSize) {
+				const size_t end = std::min(begin + arguments.stratumSize, rows);
+				double total = 0.0;
+				for (size_t i = begin; i < end; ++i) {
+					total += std::exp(eta[i]);
+				}
+				double u = uniform(prng) * total;
+				size_t i = begin;
+				while (i < end - 1 && (u -= std::exp(eta[i])) > 0.0) {
+					++i;
+				}
+				y[i] = 1.0;
+			}
+			break;
+		case ModelType::SELF_CONTROLLED_MODEL : {
+			RealVector& length = modelData.offs;
+			length.resize(rows);
+			std::uniform_int_distribution<int> days(1, 365);
+			std::poisson_distribution<int> extraEvents(0.5);
+			for (size_t begin = 0; begin < rows; begin += arguments.stratumSize) {
+				const size_t end = std::min(begin + arguments.stratumSize, rows);
+				double total = 0.0;
+				for (size_t i = begin; i < end; ++i) {
+					length[i] = days(prng);
+					total += length[i] * std::exp(eta[i]);
+				}
+				for (int event = 1 + extraEvents(prng); event > 0; --event) {
+					double u = uniform(prng) * total;
+					size_t i = begin;
+					while (i < end - 1 && (u -= length[i] * std::exp(eta[i])) > 0.0) {
+						++i;
+					}
+					y[i] += 1.0;
+				}
+			}
+			break;
+		}
+		case ModelType::COX : {
+			// Rates are per year; times are recorded in whole days, so ties occur
+			RealVector& time = modelData.offs;
+			time.resize(rows);
+			std::exponential_distribution<double> censoring(arguments.censoringRate);
+			for (size_t i = 0; i < rows; ++i) {
+				std::exponential_distribution<double> survival(
+					arguments.baseRate * std::exp(eta[i]));
+				const double event = survival(prng);
+				const double censor = censoring(prng);
+				y[i] = (event <= censor) ? 1.0 : 0.0;
+				time[i] = std::ceil(std::min(event, censor) * 365.0);
+			}
+			break;
+		}
+		default :
+			break;
+	}
+}
+
+void SyntheticDataGenerator::orderBySurvivalTime(ModelData& modelData) {
+
+	const size_t rows = arguments.rows;
+	const IntVector& pid = modelData.pid;
+	const RealVector& time = modelData.offs;
+	const RealVector& y = modelData.y;
+
+	// Same order as the R data conversion: stratum, decreasing time, censored first
+	std::vector<int> order(rows);
+	std::iota(order.begin(), order.end(), 0);
+	std::stable_sort(order.begin(), order.end(), [&](int lhs, int rhs) {
+		if (pid[lhs] != pid[rhs]) return pid[lhs] < pid[rhs];
+		if (time[lhs] != time[rhs]) return time[lhs] > time[rhs];
+		return y[lhs] < y[rhs];
+	});
+
+	std::vector<int> position(rows);
+	for (size_t i = 0; i < rows; ++i) {
+		position[order[i]] = static_cast<int>(i);
+	}
+
+	auto permute = [&order](RealVector& values) {
+		RealVector permuted(values.size());
+		for (size_t i = 0; i < values.size(); ++i) {
+			permuted[i] = values[order[i]];
+		}
+		values.swap(permuted);
+	};
+	permute(modelData.y);
+	permute(modelData.offs);
+
+	for (size_t j = 0; j < modelData.getNumberOfColumns(); ++j) {
+		CompressedDataColumn& column = modelData.getColumn(j);
+		switch (column.getFormatType()) {
+			case DENSE :
+				permute(column.getDataVector());
+				break;
+			case INDICATOR : {
+				std::vector<int>& indices = column.getColumnsVector();
+				for (auto& i : indices) {
+					i = position[i];
+				}
+				std::sort(indices.begin(), indices.end());
+				break;
+			}
+			case SPARSE : {
+				std::vector<int>& indices = column.getColumnsVector();
+				std::vector<real>& values = column.getDataVector();
+				std::vector<std::pair<int,real>> entries(indices.size());
+				for (size_t k = 0; k < indices.size(); ++k) {
+					entries[k] = std::make_pair(position[indices[k]], values[k]);
+				}
+				std::sort(entries.begin(), entries.end());
+				for (size_t k = 0; k < entries.size(); ++k) {
+					indices[k] = entries[k].first;
+					values[k] = entries[k].second;
+				}
+				break;
+			}
+			default :
+				break;
+		}
+	}
+}
+
+} // namespace bsccs
@@ -0,0 +1,101 @@
+/*
+ * SyntheticDataGenerator.h
+ *
+ * Simulates a study design straight into a ModelData, for performance testing at
+ * production scale (10^7 rows and beyond).  Covariates are indicators whose prevalence
+ * decays as a power law over columns, as for drug and condition eras, plus optional
+ * dense and real-valued sparse columns.  A few coefficients are non-zero and outcomes
+ * are drawn from the model itself:
+ *
+ *   lr   : independent rows, y ~ Bernoulli(logit^-1(b0 + eta))
+ *   pr   : independent rows, y ~ Poisson(exp(b0 + eta))
+ *   clr  : matched sets of stratumSize rows, one case drawn in proportion to exp(eta)
+ *   sccs : persons with stratumSize eras of random length, at least one event each,
+ *          events spread in proportion to length * exp(eta)
+ *   cox  : strata of stratumSize rows (0 for a single stratum), exponential survival
+ *          with rate exp(b0 + eta) and exponential censoring; rows are ordered by
+ *          decreasing time within stratum, as the Cox models require
+ *
+ * Sparse rows are drawn by geometric skips, so generation is linear in the number of
+ * non-zero entries.  No row labels are stored.
+ */
+
+#ifndef SYNTHETICDATAGENERATOR_H_
+#define SYNTHETICDATAGENERATOR_H_
+
+#include <cstdint>
+#include <vector>
+
+#include "ModelData.h"
+
+namespace bsccs {
+
+struct SyntheticDataArguments {
+
+	ModelType modelType;
+	size_t rows;
+	size_t stratumSize;
+	int indicatorColumns;
+	int sparseColumns;
+	int denseColumns;
+	double maxDensity;  // Prevalence of the most common sparse covariate
+	double decay;       // Prevalence of sparse column j is maxDensity * (j + 1)^-decay
+	int effects;        // Number of non-zero coefficients
+	double effectSize;  // Standard deviation of the non-zero coefficients
+	double baseRate;    // Outcome probability (lr), mean (pr) or hazard (cox) at eta = 0
+	double censoringRate;
+	uint64_t seed;
+
+	SyntheticDataArguments() :
+		modelType(ModelType::LOGISTIC),
+		rows(1000000),
+		stratumSize(5),
+		indicatorColumns(1000),
+		sparseColumns(0),
+		denseColumns(0),
+		maxDensity(0.1),
+		decay(1.0),
+		effects(10),
+		effectSize(0.5),
+		baseRate(0.1),
+		censoringRate(0.1),
+		seed(123)
+		{ }
+};
+
+class SyntheticDataGenerator {
+public:
+	SyntheticDataGenerator(const SyntheticDataArguments& arguments,
+		loggers::ProgressLoggerPtr logger, loggers::ErrorHandlerPtr error);
+
+	// Caller takes ownership.  Unconditional designs (lr, pr) get an intercept first,
+	// labelled 0; the other columns are labelled 1, 2, ...
+	ModelData* generate();
+
+	// Fills an empty data set, such as one owned by R, and sets its model type
+	void generate(ModelData& modelData);
+
+	// Simulating coefficients by column index, known before generate()
+	const std::vector<double>& getTrueBeta() const {
+		return trueBeta;
+	}
+
+private:
+	void drawCoefficients();
+
+	void addColumns(ModelData& modelData, std::vector<double>& eta);
+
+	void drawOutcomes(ModelData& modelData, const std::vector<double>& eta);
+
+	void orderBySurvivalTime(ModelData& modelData);
+
+	SyntheticDataArguments arguments;
+	loggers::ProgressLoggerPtr logger;
+	loggers::ErrorHandlerPtr error;
+
+	std::vector<double> trueBeta;
+};
+
+} // namespace bsccs
+
+#endif /* SYNTHETICDATAGENERATOR_H_ */
@@ -124,6 +124,98 @@ struct CacheCallback : public Cachable {
 
 typedef CallbackSharedPtr<double,CacheCallback> VariancePtr;
 
+/**
+ * Closed-form coordinate updates of the independent priors below, with hyperparameters
+ * resolved.  The priors delegate getDelta() here, and the cyclic sweep in ModelSpecifics
+ * instantiates them at compile time.
+ */
+enum class PenaltyType {
+	NONE,
+	LAPLACE,
+	NORMAL,
+	OTHER // No closed form; use CovariatePrior::getDelta()
+};
+
+struct Penalty {
+	PenaltyType type;
+	double parameter; // lambda (Laplace) or variance (normal)
+
+	Penalty(PenaltyType type = PenaltyType::OTHER, double parameter = 0.0)
+		: type(type), parameter(parameter) { }
+
+	bool operator==(const Penalty& rhs) const {
+		return type == rhs.type && parameter == rhs.parameter;
+	}
+};
+
+struct NoPenalty {
+	NoPenalty(double parameter = 0.0) { }
+
+	double getDelta(const GradientHessian& gh, const double beta) const {
+		return -(gh.first / gh.second); // No regularization
+	}
+};
+
+struct LaplacePenalty {
+	LaplacePenalty(double lambda) : lambda(lambda) { }
+
+	double getDelta(const GradientHessian& gh, const double beta) const {
+
+		double delta = 0.0;
+
+		double neg_update = - (gh.first - lambda) / gh.second;
+		double pos_update = - (gh.first + lambda) / gh.second;
+
+		int signBetaIndex = sign(beta);
+
+		if (signBetaIndex == 0) {
+
+			if (neg_update < 0) {
+				delta = neg_update;
+			} else if (pos_update > 0) {
+				delta = pos_update;
+			} else {
+				delta = 0;
+			}
+		} else { // non-zero entry
+
+			if (signBetaIndex < 0) {
+				delta = neg_update;
+			} else {
+				delta = pos_update;
+			}
+
+			if ( sign(beta + delta) != signBetaIndex ) {
+				delta = - beta;
+			}
+		}
+		return delta;
+	}
+
+	static int sign(double x) {
+		if (x == 0) {
+			return 0;
+		}
+		if (x < 0) {
+			return -1;
+		}
+		return 1;
+	}
+
+	const double lambda;
+};
+
+struct NormalPenalty {
+	NormalPenalty(double variance) : variance(variance) { }
+
+	double getDelta(const GradientHessian& gh, const double beta) const {
+		return - (gh.first + (beta / variance)) /
+				  (gh.second + (1.0 / variance));
+	}
+
+	const double variance;
+};
+
 class CovariatePrior; // forward declaration
 typedef bsccs::shared_ptr<CovariatePrior> PriorPtr;
 
@@ -150,6 +242,11 @@ public:
 
 	virtual std::vector<VariancePtr> getVarianceParameters() const = 0 ; // pure virtual
 
+	// Closed form of getDelta(), if it depends on this coordinate alone
+	virtual Penalty getPenalty() const {
+		return Penalty();
+	}
+
 	static PriorPtr makePrior(PriorType priorType, double variance);
 
 	static VariancePtr makeVariance(double variance) {
@@ -184,7 +281,11 @@ public:
 	}
 
 	double getDelta(GradientHessian gh,const DoubleVector& beta, const int index) const {
-		return -(gh.first / gh.second); // No regularization
+		return NoPenalty().getDelta(gh, beta[index]);
+	}
+
+	Penalty getPenalty() const {
+		return Penalty(PenaltyType::NONE);
 	}
 
 	bool getSupportsKktSwindle() const {
@@ -238,38 +339,11 @@ public:
 	}
 
 	double getDelta(GradientHessian gh, const DoubleVector& betaVector, const int index) const {
+		return LaplacePenalty(getLambda()).getDelta(gh, betaVector[index]);
+	}
 
-		double beta = betaVector[index];
-		double lambda = getLambda();
-		double delta = 0.0;
-
-		double neg_update = - (gh.first - lambda) / gh.second;
-		double pos_update = - (gh.first + lambda) / gh.second;
-
-		int signBetaIndex = sign(beta);
-
-		if (signBetaIndex == 0) {
-
-			if (neg_update < 0) {
-				delta = neg_update;
-			} else if (pos_update > 0) {
-				delta = pos_update;
-			} else {
-				delta = 0;
-			}
-		} else { // non-zero entry
-
-			if (signBetaIndex < 0) {
-				delta = neg_update;
-			} else {
-				delta = pos_update;
-			}
-
-			if ( sign(beta + delta) != signBetaIndex ) {
-				delta = - beta;
-			}
-		}
-		return delta;
+	Penalty getPenalty() const {
+		return Penalty(PenaltyType::LAPLACE, getLambda());
 	}
 
 	std::vector<VariancePtr> getVarianceParameters() const {
@@ -307,16 +381,6 @@ private:
 		return result;
 	}
 
-	int sign(double x) const {
-		if (x == 0) {
-			return 0;
-		}
-		if (x < 0) {
-			return -1;
-		}
-		return 1;
-	}
-
 	VariancePtr variance;
 };
 
@@ -357,6 +421,10 @@ public:
 
 	double getDelta(const GradientHessian gh, const DoubleVector& betaVector, const int index) const;
 
+	Penalty getPenalty() const {
+		return Penalty(); // Depends on neighbors
+	}
+
 private:
 	double getEpsilon() const {
 		return convertVarianceToHyperparameter(variance2.get());
@@ -408,10 +476,11 @@ public:
     }
 
 	double getDelta(GradientHessian gh, const DoubleVector& betaVector, const int index) const {
-		double sigma2Beta = getVariance();
-		double beta = betaVector[index];
-		return - (gh.first + (beta / sigma2Beta)) /
-				  (gh.second + (1.0 / sigma2Beta));
+		return NormalPenalty(getVariance()).getDelta(gh, betaVector[index]);
+	}
+
+	Penalty getPenalty() const {
+		return Penalty(PenaltyType::NORMAL, getVariance());
 	}
 
 	std::vector<VariancePtr> getVarianceParameters() const {
@@ -459,6 +528,10 @@ public:
 
     double getDelta(GradientHessian gh, const DoubleVector& betaVector, const int index) const;
 
+    Penalty getPenalty() const {
+        return Penalty(); // Depends on neighbors
+    }
+
     std::vector<VariancePtr> getVarianceParameters() const {
         auto tmp = NormalPrior::getVarianceParameters();
         tmp.push_back(variance2);
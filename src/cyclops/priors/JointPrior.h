@@ -33,6 +33,11 @@ public:
 
 	virtual double getDelta(const GradientHessian gh, const DoubleVector& beta, const int index) const = 0; // pure virtual
 
+	// Closed form of getDelta() at index, if it depends on that coordinate alone
+	virtual Penalty getPenalty(const int index) const {
+		return Penalty();
+	}
+
 	virtual const std::string getDescription() const = 0; // pure virtual
 
 	virtual bool getIsRegularized(const int index) const = 0; // pure virtual
@@ -138,6 +143,10 @@ public:
 		return listPriors[index]->getDelta(gh, beta, index);
 	}
 
+	Penalty getPenalty(const int index) const {
+		return listPriors[index]->getPenalty();
+	}
+
 	bool getSupportsKktSwindle(const int index) const {
 		return listPriors[index]->getSupportsKktSwindle();
 	}
@@ -617,6 +626,10 @@ public:
 		return singlePrior->getDelta(gh, beta, index);
 	}
 
+	Penalty getPenalty(const int index) const {
+		return singlePrior->getPenalty();
+	}
+
 	bool getIsRegularized(const int index) const {
 	    return singlePrior->getIsRegularized();
 	}
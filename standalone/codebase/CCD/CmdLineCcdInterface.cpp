@@ -26,6 +26,7 @@
 
 // #include "Types.h"
 #include "CmdLineCcdInterface.h"
+#include "Trace.h"
 // #include "CyclicCoordinateDescent.h"
 // #include "ModelData.h"
 #include "io/InputReader.h"
@@ -38,6 +39,7 @@
 #include "io/NewCLRInputReader.h"
 #include "io/NewSCCSInputReader.h"
 #include "io/NewCoxInputReader.h"
+#include "io/BinaryModelData.h"
 #include "io/NewGenericInputReader.h"
 #include "io/BBRInputReader.h"
 #include "io/OutputWriter.h"
@@ -77,6 +79,7 @@ void CmdLineCcdInterface::parseCommandLine(std::vector<std::string>& args) {
 		ValueArg<int> gpuArg("g","GPU","Use GPU device", arguments.useGPU, -1, "device #");
 //		SwitchArg betterGPUArg("1","better", "Use better GPU implementation", false);
 		ValueArg<int> maxIterationsArg("", "maxIterations", "Maximum iterations", false, arguments.modeFinding.maxIterations, "int");
+		ValueArg<int> threadsArg("", "threads", "Number of threads (-1 uses all cores)", false, arguments.threads, "int");
 		UnlabeledValueArg<string> inFileArg("inFileName","Input file name", true, arguments.inFileName, "inFileName");
 		UnlabeledValueArg<string> outFileArg("outFileName","Output file name", true, arguments.outFileName, "outFileName");
 		ValueArg<string> outDirectoryNameArg("", "outDirectoryName", "Output directory name", false, arguments.outDirectoryName, "outDirectoryName");
@@ -147,17 +150,23 @@ void CmdLineCcdInterface::parseCommandLine(std::vector<std::string>& args) {
 		allowedFormats.push_back("new-cox");
 		allowedFormats.push_back("bbr");
 		allowedFormats.push_back("generic");
+		allowedFormats.push_back("binary");
 		ValuesConstraint<std::string> allowedFormatValues(allowedFormats);
 		ValueArg<string> formatArg("", "format", "Format of data file", false, arguments.fileFormat, &allowedFormatValues);
+		ValueArg<string> writeBinaryArg("", "writeBinary", "Save a binary snapshot of the loaded data", false, "", "file");
+		ValueArg<int> residentArg("", "resident", "Page binary data columns from disk, keeping at most this many MB resident", false, arguments.residentMegabytes, "MB");
 
 		// Output format arguments
 		std::vector<std::string> allowedOutputFormats;
 		allowedOutputFormats.push_back("estimates");
 		allowedOutputFormats.push_back("prediction");
 		allowedOutputFormats.push_back("diagnostics");
+		allowedOutputFormats.push_back("performance");
 		ValuesConstraint<std::string> allowedOutputFormatValues(allowedOutputFormats);
 //		ValueArg<string> outputFormatArg("", "outputFormat", "Format of the output file", false, arguments.outputFormat, &allowedOutputFormatValues);
 		MultiArg<std::string> outputFormatArg("", "output", "Format of the output file", false, &allowedOutputFormatValues);
+		SwitchArg binaryOutputArg("", "binaryOutput", "Write output files as binary column tables", arguments.binaryOutput);
+		ValueArg<string> traceArg("", "trace", "Write a Chrome trace-event timeline of the run", false, "", "file");
 
 		// Control screen output volume
 		SwitchArg quietArg("q", "quiet", "Limit writing to standard out", arguments.noiseLevel <= QUIET);
@@ -170,6 +179,7 @@ void CmdLineCcdInterface::parseCommandLine(std::vector<std::string>& args) {
 //		cmd.add(betterGPUArg);
 		cmd.add(toleranceArg);
 		cmd.add(maxIterationsArg);
+		cmd.add(threadsArg);
 		cmd.add(hyperPriorArg);
 		cmd.add(normalPriorArg);
 		cmd.add(computeMLEArg);
@@ -180,7 +190,11 @@ void CmdLineCcdInterface::parseCommandLine(std::vector<std::string>& args) {
 		cmd.add(seedArg);
 		cmd.add(modelArg);
 		cmd.add(formatArg);
+		cmd.add(writeBinaryArg);
+		cmd.add(residentArg);
 		cmd.add(outputFormatArg);
+		cmd.add(binaryOutputArg);
+		cmd.add(traceArg);
 		cmd.add(profileCIArg);
 		cmd.add(flatPriorArg);
 
@@ -225,6 +239,7 @@ void CmdLineCcdInterface::parseCommandLine(std::vector<std::string>& args) {
 		arguments.outDirectoryName = outDirectoryNameArg.getValue();
 		arguments.modeFinding.tolerance = toleranceArg.getValue();
 		arguments.modeFinding.maxIterations = maxIterationsArg.getValue();
+		arguments.threads = threadsArg.getValue();
 		arguments.hyperprior = hyperPriorArg.getValue();
 		arguments.useNormalPrior = normalPriorArg.getValue();
 		arguments.computeMLE = computeMLEArg.getValue();
@@ -239,7 +254,11 @@ void CmdLineCcdInterface::parseCommandLine(std::vector<std::string>& args) {
 
 		arguments.modelName = modelArg.getValue();
 		arguments.fileFormat = formatArg.getValue();
+		arguments.binaryFileName = writeBinaryArg.getValue();
+		arguments.residentMegabytes = residentArg.getValue();
 		arguments.outputFormat = outputFormatArg.getValue();
+		arguments.binaryOutput = binaryOutputArg.getValue();
+		arguments.traceFileName = traceArg.getValue();
 		if (arguments.outputFormat.size() == 0) {
 			arguments.outputFormat.push_back("estimates");
 		}
@@ -377,14 +396,26 @@ void CmdLineCcdInterface::initializeModelImpl(
 		reader = new NewGenericInputReader(modelType, logger, error);
 	} else if (arguments.fileFormat == "new-cox") {
 		reader = new NewCoxInputReader(logger, error);
+	} else if (arguments.fileFormat == "binary") {
+		reader = new BinaryInputReader(logger, error,
+			static_cast<size_t>(std::max(0, arguments.residentMegabytes)) << 20);
 	} else {
 		cerr << "Invalid file format." << endl;
 		exit(-1);
 	}
 
-	reader->readFile(arguments.inFileName.c_str()); // TODO Check for error
-	// delete reader;
-	*modelData = reader->getModelData();
+	{
+		trace::Span span("readData", "data");
+		reader->setThreadCount(arguments.threads);
+		reader->readFile(arguments.inFileName.c_str()); // TODO Check for error
+		// delete reader;
+		*modelData = reader->getModelData();
+		(*modelData)->shareDuplicateColumns();
+	}
+
+	if (!arguments.binaryFileName.empty()) {
+		BinaryModelData::write(**modelData, arguments.binaryFileName);
+	}
 
 // 	switch (modelType) {
 // 		case bsccs::Models::SELF_CONTROLLED_MODEL :
@@ -497,6 +528,7 @@ void CmdLineCcdInterface::initializeModelImpl(
 void CmdLineCcdInterface::predictModelImpl(CyclicCoordinateDescent *ccd, ModelData *modelData) {
 
 	bsccs::PredictionOutputWriter predictor(*ccd, *modelData);
+	predictor.setBinaryOutput(arguments.binaryOutput);
 	string fileName = getPathAndFileName(arguments, "pred_");
 	predictor.writeFile(fileName.c_str());
 }
@@ -507,6 +539,7 @@ void CmdLineCcdInterface::logModelImpl(CyclicCoordinateDescent *ccd, ModelData *
 	using namespace bsccs;
 	bsccs::EstimationOutputWriter estimates(*ccd, *modelData);
 	estimates.addBoundInformation(profileMap);
+	estimates.setBinaryOutput(arguments.binaryOutput);
 
 	string fileName = getPathAndFileName(arguments, "est_");
 	estimates.writeFile(fileName.c_str());
@@ -518,6 +551,7 @@ void CmdLineCcdInterface::diagnoseModelImpl(CyclicCoordinateDescent *ccd, ModelD
 
 	using namespace bsccs;
 	DiagnosticsOutputWriter diagnostics(*ccd, *modelData);
+	diagnostics.setBinaryOutput(arguments.binaryOutput);
 
 	string fileName = getPathAndFileName(arguments, "diag_");
 
@@ -529,6 +563,16 @@ void CmdLineCcdInterface::diagnoseModelImpl(CyclicCoordinateDescent *ccd, ModelD
 	diagnostics.writeFile(fileName.c_str());
 }
 
+void CmdLineCcdInterface::logPerformanceCounters(CyclicCoordinateDescent *ccd, ModelData *modelData) {
+
+	using namespace bsccs;
+	PerformanceOutputWriter performance(*ccd, *modelData);
+	performance.setBinaryOutput(arguments.binaryOutput);
+
+	string fileName = getPathAndFileName(arguments, "perf_");
+	performance.writeFile(fileName.c_str());
+}
+
 CmdLineCcdInterface::CmdLineCcdInterface(int argc, char* argv[]) {
     std::vector<std::string> args;
 	for (int i = 0; i < argc; i++)
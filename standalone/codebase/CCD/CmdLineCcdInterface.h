@@ -25,6 +25,11 @@ public:
             int argc,
             char* argv[],
             CCDArguments &arguments);
+
+    // Kernel counters accumulated over the whole run, as a table
+    void logPerformanceCounters(
+            CyclicCoordinateDescent *ccd,
+            ModelData *modelData);
             
 protected:            
             
@@ -0,0 +1,522 @@
+/*
+ * benchmark.cpp
+ *
+ * Times the inner kernels of every model in AbstractModelSpecifics::factory against
+ * synthetic data holding columns of every FormatType.  Each kernel is run untimed for
+ * some warm-up rounds and then timed over several runs.  Results are written as CSV
+ * (model, format, kernel, rows, calls, nanosecondsPerCall, minimum, maximum), holding
+ * the median, fastest and slowest run, and may be compared against an earlier run.  The
+ * exit status is non-zero when any kernel regressed: its median is slower than the
+ * baseline median by more than the tolerance and even its fastest run is slower than
+ * the slowest baseline run.  To compare kernel backends, run a default build with -o and
+ * a build configured with -DPOINTER_KERNELS=ON with -b on the same arguments.
+ */
+
+#include <algorithm>
+#include <functional>
+#include <iostream>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <vector>
+#include <map>
+#include <random>
+#include <cstdlib>
+
+#include "Types.h"
+#include "Timing.h"
+#include "ModelData.h"
+#include "CyclicCoordinateDescent.h"
+#include "PerformanceCounters.h"
+#include "engine/AbstractModelSpecifics.h"
+#include "priors/JointPrior.h"
+#include "io/CmdLineProgressLogger.h"
+
+#include "tclap/CmdLine.h"
+
+namespace bsccs {
+
+namespace {
+
+struct BenchmarkArguments {
+	int rows;
+	int strata;
+	int columns;
+	double density;
+	int repeats;
+	int warmups;
+	int runs;
+	long seed;
+	std::vector<std::string> models;
+	std::string outFileName;
+	std::string baselineFileName;
+	double tolerance;
+};
+
+struct BenchmarkRecord {
+	std::string model;
+	std::string format;
+	std::string kernel;
+	int rows;
+	uint64_t calls;
+	double nanosecondsPerCall; // Median over runs
+	double minimum;
+	double maximum;
+};
+
+// One kernel of one model; run() makes calls kernel calls
+struct Measurement {
+	std::string model;
+	const char* format;
+	performance::Kernel kernel;
+	uint64_t calls;
+	std::function<void()> run;
+	std::vector<double> nanosecondsPerCall; // Of each timed run
+};
+
+const std::vector<std::pair<std::string, ModelType>> benchmarkModels = {
+	{"ls", ModelType::NORMAL},
+	{"pr", ModelType::POISSON},
+	{"lr", ModelType::LOGISTIC},
+	{"clr", ModelType::CONDITIONAL_LOGISTIC},
+	{"clr_exact", ModelType::TIED_CONDITIONAL_LOGISTIC},
+	{"cpr", ModelType::CONDITIONAL_POISSON},
+	{"sccs", ModelType::SELF_CONTROLLED_MODEL},
+	{"cox", ModelType::COX},
+	{"cox_raw", ModelType::COX_RAW}
+};
+
+const FormatType formats[] = { DENSE, SPARSE, INDICATOR, INTERCEPT };
+
+bool parseCommandLine(int argc, char* argv[], BenchmarkArguments& arguments) {
+	using namespace TCLAP;
+	try {
+		CmdLine cmd("Microbenchmark of model kernels on synthetic data", ' ', "0.1");
+
+		ValueArg<int> rowsArg("K", "rows", "Number of rows", false, 100000, "int");
+		ValueArg<int> strataArg("N", "strata", "Number of strata in stratified models", false, 1000, "int");
+		ValueArg<int> columnsArg("J", "columns", "Number of columns of each format", false, 10, "int");
+		ValueArg<double> densityArg("d", "density", "Proportion of non-zero entries in sparse and indicator columns", false, 0.1, "real");
+		ValueArg<int> repeatsArg("r", "repeats", "Calls of each kernel per column in each run", false, 10, "int");
+		ValueArg<int> warmupsArg("w", "warmups", "Untimed runs of each kernel before timing", false, 1, "int");
+		ValueArg<int> runsArg("n", "runs", "Timed runs of each kernel", false, 5, "int");
+		ValueArg<long> seedArg("s", "seed", "Random number generator seed", false, 123, "long");
+
+		std::vector<std::string> allowedModels;
+		for (const auto& model : benchmarkModels) {
+			allowedModels.push_back(model.first);
+		}
+		ValuesConstraint<std::string> allowedModelValues(allowedModels);
+		MultiArg<std::string> modelArg("m", "model", "Model to benchmark, default is all", false, &allowedModelValues);
+
+		ValueArg<std::string> outFileArg("o", "output", "CSV output file name, default is stdout", false, "", "outFileName");
+		ValueArg<std::string> baselineArg("b", "baseline", "CSV output of an earlier run to compare against", false, "", "baselineFileName");
+		ValueArg<double> toleranceArg("t", "tolerance", "Allowed relative slowdown before a kernel counts as a regression", false, 0.10, "real");
+
+		cmd.add(rowsArg);
+		cmd.add(strataArg);
+		cmd.add(columnsArg);
+		cmd.add(densityArg);
+		cmd.add(repeatsArg);
+		cmd.add(warmupsArg);
+		cmd.add(runsArg);
+		cmd.add(seedArg);
+		cmd.add(modelArg);
+		cmd.add(outFileArg);
+		cmd.add(baselineArg);
+		cmd.add(toleranceArg);
+
+		cmd.parse(argc, argv);
+
+		arguments.rows = rowsArg.getValue();
+		arguments.strata = strataArg.getValue();
+		arguments.columns = columnsArg.getValue();
+		arguments.density = densityArg.getValue();
+		arguments.repeats = repeatsArg.getValue();
+		arguments.warmups = warmupsArg.getValue();
+		arguments.runs = runsArg.getValue();
+		arguments.seed = seedArg.getValue();
+		arguments.models = modelArg.getValue();
+		arguments.outFileName = outFileArg.getValue();
+		arguments.baselineFileName = baselineArg.getValue();
+		arguments.tolerance = toleranceArg.getValue();
+
+		if (arguments.rows <= 0 || arguments.strata <= 0 || arguments.strata > arguments.rows
+				|| arguments.columns <= 0 || arguments.repeats <= 0
+				|| arguments.warmups < 0 || arguments.runs <= 0
+				|| arguments.density <= 0.0 || arguments.density > 1.0) {
+			std::cerr << "error: require 0 < strata <= rows, columns > 0, repeats > 0, warmups >= 0, runs > 0 and 0 < density <= 1" << std::endl;
+			return false;
+		}
+		if (arguments.models.empty()) {
+			arguments.models = allowedModels;
+		}
+	} catch (ArgException& e) {
+		std::cerr << "error: " << e.error() << " for argument " << e.argId() << std::endl;
+		return false;
+	}
+	return true;
+}
+
+// Rows are grouped into strata of (nearly) equal size; survival times decrease within each
+// stratum, as the Cox models expect.  Unstratified models get one stratum per row.
+void simulateOutcomes(ModelType modelType, const BenchmarkArguments& arguments,
+		std::mt19937& prng, ModelData& modelData) {
+
+	const bool stratified = Models::requiresStratumID(modelType) || modelType == ModelType::COX;
+
+	std::vector<IdType> stratumId(arguments.rows);
+	std::vector<IdType> rowId(arguments.rows);
+	std::vector<double> y(arguments.rows);
+	std::vector<double> time(arguments.rows);
+
+	std::bernoulli_distribution event(0.2);
+	std::poisson_distribution<int> count(0.5);
+	std::normal_distribution<double> normal;
+	std::uniform_real_distribution<double> exposure(1.0, 365.0);
+
+	for (int i = 0; i < arguments.rows; ++i) {
+		const IdType stratum = stratified ?
+			static_cast<IdType>(i) * arguments.strata / arguments.rows : i;
+		stratumId[i] = stratum;
+		rowId[i] = i;
+
+		switch (modelType) {
+			case ModelType::NORMAL :
+				y[i] = normal(prng);
+				break;
+			case ModelType::POISSON :
+			case ModelType::CONDITIONAL_POISSON :
+			case ModelType::SELF_CONTROLLED_MODEL :
+				y[i] = count(prng);
+				break;
+			default :
+				y[i] = event(prng) ? 1.0 : 0.0;
+				break;
+		}
+
+		if (Models::requiresOffset(modelType)) {
+			time[i] = exposure(prng);
+		} else if (Models::requiresCensoredData(modelType)) {
+			time[i] = (i == 0 || stratumId[i] != stratumId[i - 1]) ?
+				static_cast<double>(arguments.rows) : time[i - 1] - (event(prng) ? 0.0 : 1.0);
+		}
+	}
+
+	if (!Models::requiresOffset(modelType) && !Models::requiresCensoredData(modelType)) {
+		time.clear();
+	}
+	modelData.loadY(stratumId, rowId, y, time);
+}
+
+// Conditional models have no intercept, so they get no INTERCEPT column
+void simulateCovariates(ModelType modelType, const BenchmarkArguments& arguments,
+		std::mt19937& prng, ModelData& modelData) {
+
+	std::bernoulli_distribution include(arguments.density);
+	std::normal_distribution<double> normal;
+	IdType label = 1;
+
+	for (FormatType format : formats) {
+		if (format == INTERCEPT && Models::removeIntercept(modelType)) {
+			continue;
+		}
+		const int count = (format == INTERCEPT) ? 1 : arguments.columns;
+		for (int j = 0; j < count; ++j) {
+			std::vector<int> rows;
+			std::vector<double> values;
+			if (format == DENSE) {
+				for (int i = 0; i < arguments.rows; ++i) {
+					values.push_back(normal(prng));
+				}
+			} else if (format != INTERCEPT) {
+				for (int i = 0; i < arguments.rows; ++i) {
+					if (include(prng)) {
+						rows.push_back(i);
+						values.push_back(normal(prng));
+					}
+				}
+			}
+			modelData.push_back(rows.begin(), rows.end(), values.begin(), values.end(), format);
+			modelData.setColumnLabel(modelData.getNumberOfColumns() - 1, label++);
+		}
+	}
+}
+
+// Every model is set up first and its kernels run in rounds: one untimed round per
+// warm-up, then one timed round per run, each visiting all kernels of all models.  Slow
+// drift in machine speed so shows up in the spread of runs rather than biasing a kernel.
+class ModelBenchmark {
+public:
+	ModelBenchmark(const std::string& name, ModelType modelType,
+			const BenchmarkArguments& arguments, std::vector<Measurement>& measurements)
+		: logger(bsccs::make_shared<loggers::CoutLogger>()),
+		  error(bsccs::make_shared<loggers::CerrErrorHandler>()),
+		  modelData(modelType, logger, error) {
+
+		std::mt19937 prng(static_cast<std::mt19937::result_type>(arguments.seed));
+		simulateOutcomes(modelType, arguments, prng, modelData);
+		simulateCovariates(modelType, arguments, prng, modelData);
+
+		model.reset(AbstractModelSpecifics::factory(modelType, modelData));
+		prior = bsccs::make_shared<priors::FullyExchangeableJointPrior>(
+			bsccs::make_shared<priors::NormalPrior>(1.0));
+		ccd.reset(new CyclicCoordinateDescent(modelData, *model, prior, logger, error));
+		ccd->setNoiseLevel(SILENT);
+		ccd->getLogLikelihood(); // Sets weights, fixed terms and sufficient statistics
+
+		beta.assign(modelData.getNumberOfColumns(), 0.0);
+		bound.assign(modelData.getNumberOfColumns(), 2.0);
+
+		const int repeats = arguments.repeats;
+		auto add = [&](const char* format, performance::Kernel kernel, uint64_t calls,
+				std::function<void()> run) {
+			Measurement measurement = { name, format, kernel, calls, run, std::vector<double>() };
+			measurements.push_back(measurement);
+		};
+
+		for (FormatType format : formats) {
+			std::vector<int> columns;
+			std::vector<SweepRun> runs;
+			for (size_t index = 0; index < modelData.getNumberOfColumns(); ++index) {
+				if (modelData.getFormatType(index) != format) {
+					continue;
+				}
+				const int j = static_cast<int>(index);
+				if (!runs.empty() && runs.back().end == j) {
+					++runs.back().end;
+				} else {
+					SweepRun run = { j, j + 1, format, prior->getPenalty(j) };
+					runs.push_back(run);
+				}
+				columns.push_back(j);
+			}
+			if (columns.empty()) {
+				continue;
+			}
+			const uint64_t calls = static_cast<uint64_t>(columns.size()) * repeats;
+			const char* formatName = performance::formatName(format);
+
+			add(formatName, performance::COMPUTE_GRADIENT_HESSIAN, calls, [this, columns, repeats]() {
+				double gradient, hessian;
+				for (int j : columns) {
+					for (int i = 0; i < repeats; ++i) {
+						model->computeGradientAndHessian(j, &gradient, &hessian, useWeights);
+					}
+				}
+			});
+			// Paired steps leave the linear predictor where it started
+			add(formatName, performance::UPDATE_XBETA, calls * 2, [this, columns, repeats]() {
+				for (int j : columns) {
+					for (int i = 0; i < repeats; ++i) {
+						model->updateXBeta(delta, j, useWeights);
+						model->updateXBeta(-delta, j, useWeights);
+					}
+				}
+			});
+			// Full coordinate updates; coefficients move towards the mode as passes repeat
+			add(formatName, performance::SWEEP, calls, [this, runs, repeats]() {
+				for (int i = 0; i < repeats; ++i) {
+					for (const auto& run : runs) {
+						model->sweep(run, beta.data(), bound.data(), useWeights);
+					}
+				}
+			});
+		}
+
+		const char* allFormats = performance::formatName(performance::ANY_FORMAT);
+		add(allFormats, performance::COMPUTE_REMAINING_STATISTICS, repeats, [this, repeats]() {
+			for (int i = 0; i < repeats; ++i) {
+				model->computeRemainingStatistics(useWeights);
+			}
+		});
+		add(allFormats, performance::COMPUTE_LOG_LIKELIHOOD, repeats, [this, repeats]() {
+			for (int i = 0; i < repeats; ++i) {
+				model->getLogLikelihood(useWeights);
+			}
+		});
+	}
+
+private:
+	ModelBenchmark(const ModelBenchmark&);
+	ModelBenchmark& operator = (const ModelBenchmark&);
+
+	static const bool useWeights = false;
+	static constexpr real delta = 0.01;
+
+	loggers::ProgressLoggerPtr logger;
+	loggers::ErrorHandlerPtr error;
+	ModelData modelData;
+	bsccs::unique_ptr<AbstractModelSpecifics> model;
+	priors::JointPriorPtr prior;
+	bsccs::unique_ptr<CyclicCoordinateDescent> ccd;
+	std::vector<double> beta;
+	std::vector<double> bound;
+};
+
+void runMeasurements(const BenchmarkArguments& arguments, std::vector<Measurement>& measurements) {
+	for (int round = 0; round < arguments.warmups; ++round) {
+		for (auto& measurement : measurements) {
+			measurement.run();
+		}
+	}
+	for (int round = 0; round < arguments.runs; ++round) {
+		for (auto& measurement : measurements) {
+			auto start = chrono::steady_clock::now();
+			measurement.run();
+			measurement.nanosecondsPerCall.push_back(static_cast<double>(
+				chrono::duration_cast<chrono::TimingUnits>(chrono::steady_clock::now() - start).count())
+				/ measurement.calls);
+		}
+	}
+}
+
+BenchmarkRecord summarize(const Measurement& measurement, int rows) {
+	std::vector<double> times = measurement.nanosecondsPerCall;
+	std::sort(times.begin(), times.end());
+	const size_t middle = times.size() / 2;
+	const double median = (times.size() % 2 == 1) ? times[middle] :
+		(times[middle - 1] + times[middle]) / 2;
+	BenchmarkRecord record = { measurement.model, measurement.format,
+		performance::kernelName(measurement.kernel), rows, measurement.calls,
+		median, times.front(), times.back() };
+	return record;
+}
+
+void writeRecords(std::ostream& stream, const std::vector<BenchmarkRecord>& records) {
+	stream << "model,format,kernel,rows,calls,nanosecondsPerCall,minimum,maximum" << std::endl
+		<< std::fixed << std::setprecision(1);
+	for (const auto& record : records) {
+		stream << record.model << "," << record.format << "," << record.kernel << ","
+			<< record.rows << "," << record.calls << "," << record.nanosecondsPerCall << ","
+			<< record.minimum << "," << record.maximum << std::endl;
+	}
+}
+
+bool readRecords(const std::string& fileName, std::vector<BenchmarkRecord>& records) {
+	std::ifstream in(fileName.c_str());
+	if (!in) {
+		return false;
+	}
+	std::string line;
+	std::getline(in, line); // Header
+	while (std::getline(in, line)) {
+		std::istringstream fields(line);
+		BenchmarkRecord record;
+		std::string rows, calls, nanoseconds, minimum, maximum;
+		if (std::getline(fields, record.model, ',') && std::getline(fields, record.format, ',')
+				&& std::getline(fields, record.kernel, ',') && std::getline(fields, rows, ',')
+				&& std::getline(fields, calls, ',') && std::getline(fields, nanoseconds, ',')) {
+			record.rows = std::atoi(rows.c_str());
+			record.calls = std::strtoull(calls.c_str(), nullptr, 10);
+			record.nanosecondsPerCall = std::atof(nanoseconds.c_str());
+			// Files from before runs were repeated hold a single time
+			record.minimum = record.maximum = record.nanosecondsPerCall;
+			if (std::getline(fields, minimum, ',') && std::getline(fields, maximum)) {
+				record.minimum = std::atof(minimum.c_str());
+				record.maximum = std::atof(maximum.c_str());
+			}
+			records.push_back(record);
+		}
+	}
+	return true;
+}
+
+// Reports the ratio of current to baseline median per kernel; a kernel regressed when the
+// ratio exceeds the tolerance and the two ranges of runs do not overlap.  Returns the
+// number of regressions.
+int compareRecords(const std::vector<BenchmarkRecord>& baseline,
+		const std::vector<BenchmarkRecord>& current, double tolerance) {
+	std::map<std::string, const BenchmarkRecord*> index;
+	for (const auto& record : baseline) {
+		index[record.model + "," + record.format + "," + record.kernel] = &record;
+	}
+
+	int regressions = 0;
+	std::cerr << "model,format,kernel,baseline,current,ratio" << std::endl
+		<< std::fixed << std::setprecision(3);
+	for (const auto& record : current) {
+		auto match = index.find(record.model + "," + record.format + "," + record.kernel);
+		if (match == index.end() || match->second->nanosecondsPerCall <= 0.0) {
+			continue;
+		}
+		if (match->second->rows != record.rows) {
+			std::cerr << "warning: baseline for " << match->first << " used "
+				<< match->second->rows << " rows" << std::endl;
+		}
+		const double ratio = record.nanosecondsPerCall / match->second->nanosecondsPerCall;
+		const bool regressed = ratio > 1.0 + tolerance && record.minimum > match->second->maximum;
+		std::cerr << match->first << "," << match->second->nanosecondsPerCall << ","
+			<< record.nanosecondsPerCall << "," << ratio << (regressed ? ",REGRESSION" : "")
+			<< std::endl;
+		if (regressed) {
+			++regressions;
+		}
+	}
+	std::cerr.unsetf(std::ios::floatfield);
+	return regressions;
+}
+
+} // namespace
+
+} // namespace bsccs
+
+int main(int argc, char* argv[]) {
+
+	using namespace bsccs;
+
+	BenchmarkArguments arguments;
+	if (!parseCommandLine(argc, argv, arguments)) {
+		return EXIT_FAILURE;
+	}
+
+	std::vector<BenchmarkRecord> baseline;
+	if (!arguments.baselineFileName.empty() && !readRecords(arguments.baselineFileName, baseline)) {
+		std::cerr << "error: unable to read baseline " << arguments.baselineFileName << std::endl;
+		return EXIT_FAILURE;
+	}
+
+#ifdef CYCLOPS_POINTER_KERNELS
+	std::cerr << "kernels: pointer" << std::endl;
+#else
+	std::cerr << "kernels: zip-iterator" << std::endl;
+#endif
+
+	std::vector<bsccs::unique_ptr<ModelBenchmark>> benchmarks;
+	std::vector<Measurement> measurements;
+	for (const auto& model : benchmarkModels) {
+		if (std::find(arguments.models.begin(), arguments.models.end(), model.first)
+				!= arguments.models.end()) {
+			benchmarks.emplace_back(new ModelBenchmark(model.first, model.second, arguments,
+				measurements));
+		}
+	}
+	runMeasurements(arguments, measurements);
+
+	std::vector<BenchmarkRecord> records;
+	for (const auto& measurement : measurements) {
+		records.push_back(summarize(measurement, arguments.rows));
+	}
+
+	if (arguments.outFileName.empty()) {
+		writeRecords(std::cout, records);
+	} else {
+		std::ofstream out(arguments.outFileName.c_str());
+		if (!out) {
+			std::cerr << "error: unable to write " << arguments.outFileName << std::endl;
+			return EXIT_FAILURE;
+		}
+		writeRecords(out, records);
+	}
+
+	if (!arguments.baselineFileName.empty()) {
+		const int regressions = compareRecords(baseline, records, arguments.tolerance);
+		if (regressions > 0) {
+			std::cerr << regressions << " kernel(s) slower than baseline by more than "
+				<< arguments.tolerance * 100 << "% and beyond the run-to-run spread" << std::endl;
+			return EXIT_FAILURE;
+		}
+	}
+
+	return EXIT_SUCCESS;
+}
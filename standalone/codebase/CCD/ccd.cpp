@@ -19,6 +19,7 @@
 
 #include "CmdLineCcdInterface.h"
 #include "CyclicCoordinateDescent.h"
+#include "Trace.h"
 #include "drivers/ProportionSelector.h"
 #include "io/CmdLineProgressLogger.h"
 
@@ -39,6 +40,10 @@ int main(int argc, char* argv[]) {
 
 // 	interface.parseCommandLine(argc, argv, arguments);
 
+	if (!arguments.traceFileName.empty()) {
+		trace::start();
+	}
+
 	double timeInitialize = interface.initializeModel(&modelData, &ccd, &model);
 
 	double timeUpdate;
@@ -103,6 +108,11 @@ int main(int argc, char* argv[]) {
 		} // TODO Handle above work in interface.runBootstrap
 		timeUpdate += interface.runBoostrap(ccd, modelData, savedBeta);
 	}
+
+	if (std::find(arguments.outputFormat.begin(),arguments.outputFormat.end(), "performance")
+			!= arguments.outputFormat.end()) {
+		interface.logPerformanceCounters(ccd, modelData);
+	}
 		
 	using std::scientific;
 		
@@ -117,6 +127,14 @@ int main(int argc, char* argv[]) {
 		cout << "Diag    duration: " << scientific << timeDiagnose << endl;
 	}
 
+	if (!arguments.traceFileName.empty()) {
+		trace::stop();
+		if (!trace::write(arguments.traceFileName)) {
+			std::cerr << "Unable to write trace to " << arguments.traceFileName << std::endl;
+		}
+		trace::clear();
+	}
+
 //#define PRINT_LOG_LIKELIHOOD
 #ifdef PRINT_LOG_LIKELIHOOD
 	cout << endl << setprecision(15) << ccd->getLogLikelihood() << endl;
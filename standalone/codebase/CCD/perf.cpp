@@ -0,0 +1,391 @@
+/*
+ * perf.cpp
+ *
+ * End-to-end performance regression harness.  Simulates a study design with
+ * SyntheticDataGenerator, then fits it, optionally cross-validates the prior variance
+ * and profiles the likelihood of a few covariates, recording per phase the wall-time,
+ * mode-finding iterations and process peak memory.  Results are written as CSV
+ * (design, phase, rows, columns, nonZeros, seconds, iterations, peakMegabytes, status);
+ * the exit status is non-zero when any phase exceeds its limit.
+ */
+
+#include <iostream>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <vector>
+#include <cstdlib>
+
+#ifndef _WIN32
+#include <sys/resource.h>
+#endif
+
+#include "Types.h"
+#include "Timing.h"
+#include "CcdInterface.h"
+#include "CyclicCoordinateDescent.h"
+#include "ModelData.h"
+#include "engine/AbstractModelSpecifics.h"
+#include "priors/JointPrior.h"
+#include "io/SyntheticDataGenerator.h"
+#include "io/CmdLineProgressLogger.h"
+
+#include "tclap/CmdLine.h"
+
+namespace bsccs {
+
+namespace {
+
+struct PhaseLimits {
+	double fitSeconds;
+	double cvSeconds;
+	double profileSeconds;
+	int fitIterations;
+	double peakMegabytes;
+};
+
+struct PhaseRecord {
+	std::string phase;
+	double seconds;
+	int iterations; // -1 when not applicable
+	double peakMegabytes;
+	bool passed;
+};
+
+// Process-wide high-water mark of resident memory
+double peakMegabytes() {
+#ifdef _WIN32
+	return 0.0;
+#else
+	struct rusage usage;
+	getrusage(RUSAGE_SELF, &usage);
+#ifdef __APPLE__
+	return usage.ru_maxrss / (1024.0 * 1024.0); // bytes
+#else
+	return usage.ru_maxrss / 1024.0; // kilobytes
+#endif
+#endif
+}
+
+class SyntheticCcdInterface : public CcdInterface {
+public:
+	SyntheticCcdInterface(const SyntheticDataArguments& dataArguments)
+		: dataArguments(dataArguments) {
+		logger = bsccs::make_shared<loggers::CoutLogger>();
+		error = bsccs::make_shared<loggers::CerrErrorHandler>();
+		generator = bsccs::make_shared<SyntheticDataGenerator>(dataArguments, logger, error);
+	}
+
+	const std::vector<double>& getTrueBeta() const {
+		return generator->getTrueBeta();
+	}
+
+protected:
+	void initializeModelImpl(ModelData** modelData, CyclicCoordinateDescent** ccd,
+			AbstractModelSpecifics** model) {
+
+		*modelData = generator->generate();
+		*model = AbstractModelSpecifics::factory(dataArguments.modelType, **modelData);
+
+		using namespace bsccs::priors;
+		PriorPtr singlePrior;
+		if (arguments.useNormalPrior) {
+			singlePrior = std::make_shared<NormalPrior>(arguments.hyperprior);
+		} else {
+			singlePrior = std::make_shared<LaplacePrior>(arguments.hyperprior);
+		}
+
+		JointPriorPtr prior;
+		if (arguments.flatPrior.size() == 0) {
+			prior = std::make_shared<FullyExchangeableJointPrior>(singlePrior);
+		} else {
+			std::shared_ptr<MixtureJointPrior> mixturePrior = std::make_shared<MixtureJointPrior>(
+				singlePrior, (*modelData)->getNumberOfColumns());
+			PriorPtr noPrior = std::make_shared<NoPrior>();
+			for (auto label : arguments.flatPrior) {
+				const int index = (*modelData)->getColumnIndexByName(label);
+				if (index != -1) {
+					mixturePrior->changePrior(noPrior, index);
+				}
+			}
+			prior = mixturePrior;
+		}
+
+		*ccd = new CyclicCoordinateDescent(**modelData, **model, prior, logger, error);
+		(*ccd)->setNoiseLevel(arguments.noiseLevel);
+	}
+
+	void predictModelImpl(CyclicCoordinateDescent* ccd, ModelData* modelData) {
+		// Do nothing
+	}
+
+	void logModelImpl(CyclicCoordinateDescent* ccd, ModelData* modelData,
+			ProfileInformationMap& profileMap, bool withProfileBounds) {
+		// Do nothing
+	}
+
+	void diagnoseModelImpl(CyclicCoordinateDescent* ccd, ModelData* modelData,
+			double loadTime, double updateTime) {
+		// Do nothing
+	}
+
+private:
+	SyntheticDataArguments dataArguments;
+	bsccs::shared_ptr<SyntheticDataGenerator> generator;
+};
+
+const std::vector<std::pair<std::string, ModelType>> designs = {
+	{"lr", ModelType::LOGISTIC},
+	{"pr", ModelType::POISSON},
+	{"clr", ModelType::CONDITIONAL_LOGISTIC},
+	{"sccs", ModelType::SELF_CONTROLLED_MODEL},
+	{"cox", ModelType::COX}
+};
+
+template <typename Phase>
+PhaseRecord timePhase(const std::string& name, Phase phase) {
+	auto start = chrono::steady_clock::now();
+	const int iterations = phase();
+	PhaseRecord record = { name,
+		chrono::duration_cast<chrono::duration<double>>(chrono::steady_clock::now() - start).count(),
+		iterations, peakMegabytes(), true };
+	return record;
+}
+
+} // namespace
+
+} // namespace bsccs
+
+int main(int argc, char* argv[]) {
+
+	using namespace bsccs;
+	using namespace TCLAP;
+
+	SyntheticDataArguments data;
+	PhaseLimits limits;
+	std::string designName;
+	std::string outFileName;
+	bool doCrossValidation;
+	int profileCount;
+
+	SyntheticCcdInterface* interface = nullptr;
+
+	try {
+		CmdLine cmd("Performance regression harness on synthetic data", ' ', "0.1");
+
+		std::vector<std::string> allowedDesigns;
+		for (const auto& design : designs) {
+			allowedDesigns.push_back(design.first);
+		}
+		ValuesConstraint<std::string> allowedDesignValues(allowedDesigns);
+		ValueArg<std::string> designArg("", "design", "Study design", false, "lr", &allowedDesignValues);
+
+		ValueArg<long> rowsArg("K", "rows", "Number of rows", false, static_cast<long>(data.rows), "long");
+		ValueArg<int> stratumSizeArg("", "stratumSize", "Rows per matched set, person or Cox stratum (0: one Cox stratum)", false, static_cast<int>(data.stratumSize), "int");
+		ValueArg<int> indicatorsArg("J", "indicators", "Number of indicator columns", false, data.indicatorColumns, "int");
+		ValueArg<int> sparseArg("", "sparse", "Number of real-valued sparse columns", false, data.sparseColumns, "int");
+		ValueArg<int> denseArg("", "dense", "Number of dense columns", false, data.denseColumns, "int");
+		ValueArg<double> maxDensityArg("d", "maxDensity", "Prevalence of the most common sparse covariate", false, data.maxDensity, "real");
+		ValueArg<double> decayArg("", "decay", "Power-law decay of prevalence across sparse columns", false, data.decay, "real");
+		ValueArg<int> effectsArg("", "effects", "Number of non-zero coefficients", false, data.effects, "int");
+		ValueArg<long> seedArg("s", "seed", "Random number generator seed", false, static_cast<long>(data.seed), "long");
+
+		ValueArg<double> hyperPriorArg("v", "variance", "Hyperprior variance", false, 1.0, "real");
+		SwitchArg normalPriorArg("n", "normalPrior", "Use normal prior, default is laplace", false);
+		ValueArg<int> threadsArg("", "threads", "Number of threads (-1 uses all cores)", false, -1, "int");
+		ValueArg<double> toleranceArg("t", "tolerance", "Convergence criterion tolerance", false, 1E-6, "real");
+		ValueArg<int> maxIterationsArg("", "maxIterations", "Maximum iterations", false, 1000, "int");
+
+		SwitchArg doCVArg("c", "cv", "Cross-validate the hyperprior variance", false);
+		SwitchArg useAutoSearchCVArg("", "auto", "Use an auto-search when performing cross-validation", false);
+		ValueArg<int> foldCVArg("f", "fold", "Fold level for cross-validation", false, 10, "int");
+		ValueArg<int> gridCVArg("", "gridSize", "Uniform grid size for cross-validation search", false, 10, "int");
+		ValueArg<int> profileArg("p", "profile", "Number of simulated effects to profile; these are not regularized", false, 0, "int");
+
+		ValueArg<double> fitSecondsArg("", "fitSeconds", "Limit on fit wall-time (0: none)", false, 0.0, "real");
+		ValueArg<double> cvSecondsArg("", "cvSeconds", "Limit on cross-validation wall-time (0: none)", false, 0.0, "real");
+		ValueArg<double> profileSecondsArg("", "profileSeconds", "Limit on profiling wall-time (0: none)", false, 0.0, "real");
+		ValueArg<int> fitIterationsArg("", "fitIterations", "Limit on fit iterations (0: none)", false, 0, "int");
+		ValueArg<double> peakMegabytesArg("", "peakMegabytes", "Limit on process peak memory (0: none)", false, 0.0, "real");
+
+		ValueArg<std::string> outFileArg("o", "output", "CSV output file name, default is stdout", false, "", "outFileName");
+
+		cmd.add(designArg);
+		cmd.add(rowsArg);
+		cmd.add(stratumSizeArg);
+		cmd.add(indicatorsArg);
+		cmd.add(sparseArg);
+		cmd.add(denseArg);
+		cmd.add(maxDensityArg);
+		cmd.add(decayArg);
+		cmd.add(effectsArg);
+		cmd.add(seedArg);
+		cmd.add(hyperPriorArg);
+		cmd.add(normalPriorArg);
+		cmd.add(threadsArg);
+		cmd.add(toleranceArg);
+		cmd.add(maxIterationsArg);
+		cmd.add(doCVArg);
+		cmd.add(useAutoSearchCVArg);
+		cmd.add(foldCVArg);
+		cmd.add(gridCVArg);
+		cmd.add(profileArg);
+		cmd.add(fitSecondsArg);
+		cmd.add(cvSecondsArg);
+		cmd.add(profileSecondsArg);
+		cmd.add(fitIterationsArg);
+		cmd.add(peakMegabytesArg);
+		cmd.add(outFileArg);
+
+		cmd.parse(argc, argv);
+
+		designName = designArg.getValue();
+		for (const auto& design : designs) {
+			if (design.first == designName) {
+				data.modelType = design.second;
+			}
+		}
+		data.rows = static_cast<size_t>(std::max(0L, rowsArg.getValue()));
+		data.stratumSize = static_cast<size_t>(std::max(0, stratumSizeArg.getValue()));
+		data.indicatorColumns = indicatorsArg.getValue();
+		data.sparseColumns = sparseArg.getValue();
+		data.denseColumns = denseArg.getValue();
+		data.maxDensity = maxDensityArg.getValue();
+		data.decay = decayArg.getValue();
+		data.effects = effectsArg.getValue();
+		data.seed = static_cast<uint64_t>(seedArg.getValue());
+
+		limits.fitSeconds = fitSecondsArg.getValue();
+		limits.cvSeconds = cvSecondsArg.getValue();
+		limits.profileSeconds = profileSecondsArg.getValue();
+		limits.fitIterations = fitIterationsArg.getValue();
+		limits.peakMegabytes = peakMegabytesArg.getValue();
+
+		doCrossValidation = doCVArg.getValue();
+		profileCount = profileArg.getValue();
+		outFileName = outFileArg.getValue();
+
+		interface = new SyntheticCcdInterface(data);
+		CCDArguments& arguments = interface->getArguments();
+		arguments.hyperprior = hyperPriorArg.getValue();
+		arguments.hyperPriorSet = hyperPriorArg.isSet();
+		arguments.useNormalPrior = normalPriorArg.getValue();
+		arguments.threads = threadsArg.getValue();
+		arguments.seed = seedArg.getValue();
+		arguments.noiseLevel = QUIET;
+		arguments.modeFinding.tolerance = toleranceArg.getValue();
+		arguments.modeFinding.maxIterations = maxIterationsArg.getValue();
+		arguments.crossValidation.useAutoSearchCV = useAutoSearchCVArg.getValue();
+		arguments.crossValidation.fold = foldCVArg.getValue();
+		arguments.crossValidation.foldToCompute = foldCVArg.getValue();
+		arguments.crossValidation.gridSteps = gridCVArg.getValue();
+		arguments.crossValidation.selectorType = SelectorType::DEFAULT;
+	} catch (ArgException& e) {
+		std::cerr << "error: " << e.error() << " for argument " << e.argId() << std::endl;
+		return EXIT_FAILURE;
+	}
+
+	CCDArguments& arguments = interface->getArguments();
+	CyclicCoordinateDescent* ccd = nullptr;
+	AbstractModelSpecifics* model = nullptr;
+	ModelData* modelData = nullptr;
+
+	// Profiled covariates and any intercept are left unregularized, as in practice.
+	// Labels follow SyntheticDataGenerator: intercept 0, then 1, 2, ... by column.
+	const int offset = (!Models::removeIntercept(data.modelType) &&
+		data.modelType != ModelType::COX) ? 1 : 0;
+	if (offset > 0) {
+		arguments.flatPrior.push_back(0);
+	}
+	const std::vector<double>& trueBeta = interface->getTrueBeta();
+	ProfileVector profiled;
+	for (size_t j = offset; j < trueBeta.size() &&
+			static_cast<int>(profiled.size()) < profileCount; ++j) {
+		if (trueBeta[j] != 0.0) {
+			profiled.push_back(static_cast<IdType>(j + 1 - offset));
+		}
+	}
+	arguments.flatPrior.insert(arguments.flatPrior.end(), profiled.begin(), profiled.end());
+
+	std::vector<PhaseRecord> records;
+	records.push_back(timePhase("generate", [&]() {
+		interface->initializeModel(&modelData, &ccd, &model);
+		return -1;
+	}));
+
+	records.push_back(timePhase("fit", [&]() {
+		interface->fitModel(ccd);
+		return ccd->getIterationCount();
+	}));
+	records.back().passed =
+		(limits.fitSeconds <= 0.0 || records.back().seconds <= limits.fitSeconds) &&
+		(limits.fitIterations <= 0 || records.back().iterations <= limits.fitIterations);
+
+	if (doCrossValidation) {
+		records.push_back(timePhase("cv", [&]() {
+			interface->runCrossValidation(ccd, modelData);
+			return ccd->getIterationCount();
+		}));
+		records.back().passed = limits.cvSeconds <= 0.0 || records.back().seconds <= limits.cvSeconds;
+	}
+
+	if (!profiled.empty()) {
+		ProfileInformationMap profileMap;
+		records.push_back(timePhase("profile", [&]() {
+			interface->profileModel(ccd, modelData, profiled, profileMap, arguments.threads);
+			return -1;
+		}));
+		records.back().passed =
+			limits.profileSeconds <= 0.0 || records.back().seconds <= limits.profileSeconds;
+	}
+
+	size_t nonZeros = 0;
+	for (size_t j = 0; j < modelData->getNumberOfColumns(); ++j) {
+		nonZeros += modelData->getNumberOfNonZeroEntries(j);
+	}
+
+	int failures = 0;
+	for (auto& record : records) {
+		if (limits.peakMegabytes > 0.0 && record.peakMegabytes > limits.peakMegabytes) {
+			record.passed = false;
+		}
+		if (!record.passed) {
+			++failures;
+		}
+	}
+
+	std::ofstream outFile;
+	if (!outFileName.empty()) {
+		outFile.open(outFileName.c_str());
+		if (!outFile) {
+			std::cerr << "error: unable to write " << outFileName << std::endl;
+			return EXIT_FAILURE;
+		}
+	}
+	std::ostream& out = outFileName.empty() ? std::cout : outFile;
+	out << "design,phase,rows,columns,nonZeros,seconds,iterations,peakMegabytes,status" << std::endl
+		<< std::fixed;
+	for (const auto& record : records) {
+		out << designName << "," << record.phase << "," << modelData->getNumberOfRows() << ","
+			<< modelData->getNumberOfColumns() << "," << nonZeros << ","
+			<< std::setprecision(3) << record.seconds << ",";
+		if (record.iterations >= 0) {
+			out << record.iterations;
+		} else {
+			out << "NA";
+		}
+		out << "," << std::setprecision(1) << record.peakMegabytes << ","
+			<< (record.passed ? "ok" : "FAIL") << std::endl;
+	}
+
+	delete ccd;
+	delete model;
+	delete modelData;
+	delete interface;
+
+	if (failures > 0) {
+		std::cerr << failures << " phase(s) exceeded their limits" << std::endl;
+		return EXIT_FAILURE;
+	}
+	return EXIT_SUCCESS;
+}